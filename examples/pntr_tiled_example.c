@@ -28,7 +28,10 @@ bool Init(pntr_app* app) {
 
     appData->speed = 200;
 
-    appData->map = pntr_load_tiled("examples/resources/desert.tmj");
+    // index the objects, so only the ones on screen are drawn
+    pntr_tiled_load_options options = {0};
+    options.indexObjects = true;
+    appData->map = pntr_load_tiled_ex("examples/resources/desert.tmj", &options);
 
     // if you need more than 1 layer or object, use a single loop
     appData->objects = pntr_tiled_layer(appData->map, "objects");
@@ -90,6 +93,11 @@ bool Update(pntr_app* app, pntr_image* screen) {
         case DIRECTION_WEST: appData->player->gid = walking ? 56 : 55; break;
     }
 
+    // let the object layer's index know where the player is now
+    if (walking) {
+        pntr_tiled_update_object(appData->map, appData->objects, appData->player);
+    }
+
     // Update any map data.
     pntr_update_tiled(appData->map, pntr_app_delta_time(app));
 
@@ -90,26 +90,51 @@
 
 		GitHub : https://github.com/RandyGaul/cute_headers/
 
-		Compression of the tile GIDs is *not* supported in this header. Exporting
-		a map from Tiled will create a JSON file. This JSON file itself can very
-		trivially be compressed in its entirety, thus making Tiled's internal
-		compression exporting not a useful feature for this header to support.
-		Simply wrap calls to `cute_tiled_load_map_from_file` in a decompression
-		routine. Here is an example (assuming `zlib_uncompress` is already imp-
-		lemented somewhere in the user's codebase):
-
-			int size;
-			void* uncompressed_data = zlib_uncompress(path_to_zipped_map_file, &size);
-			cute_tiled_map_t* map = cute_tiled_load_map_from_memory(uncompressed_data, size, 0);
+		Tile layer data may be exported as CSV, or as base64 with optional `zlib`,
+		`gzip` or `zstd` compression. `zlib` and `gzip` are decoded with a small
+		built-in inflate that verifies the zlib Adler-32 and gzip CRC-32 trailers,
+		which can be swapped for your own codec (or compiled out with
+		`CUTE_TILED_NO_INFLATE`). `zstd` has no built-in decoder and requires
+		`CUTE_TILED_ZSTD_DECOMPRESS`. Each hook has the signature:
+
+			int decompress(void* out, int out_size, const void* in, int in_size, void* mem_ctx);
+
+		and returns the number of bytes written to `out`, or -1 on failure. Here is
+		an example routing `zstd` layers through libzstd:
+
+			static int my_zstd(void* out, int out_size, const void* in, int in_size, void* mem_ctx)
+			{
+				size_t n = ZSTD_decompress(out, out_size, in, in_size);
+				return ZSTD_isError(n) ? -1 : (int)n;
+			}
+			#define CUTE_TILED_ZSTD_DECOMPRESS my_zstd
+			#define CUTE_TILED_IMPLEMENTATION
+			#include <cute_tiled.h>
+
+		Whole JSON files can of course still be compressed in their entirety, and
+		decompressed before calling `cute_tiled_load_map_from_memory`.
 */
 
 #if !defined(CUTE_TILED_H)
 
 #include <stdint.h> // uint32_t
 
-// Read this in the event of errors
-extern const char* cute_tiled_error_reason;
-extern int cute_tiled_error_line;
+// The thread-local storage class of the error globals below, so that they are separate for maps that
+// load on different threads at once. Define it as empty if your platform has no thread-local storage.
+#if !defined(CUTE_TILED_THREAD_LOCAL)
+	#if defined(_MSC_VER)
+		#define CUTE_TILED_THREAD_LOCAL __declspec(thread)
+	#elif defined(__GNUC__) || defined(__clang__)
+		#define CUTE_TILED_THREAD_LOCAL __thread
+	#else
+		#define CUTE_TILED_THREAD_LOCAL
+	#endif
+#endif
+
+// Read this in the event of errors. Set once a load has failed, for the thread it failed on. Prefer
+// `cute_tiled_load_options_t::error`, which holds the full message of that load alone.
+extern CUTE_TILED_THREAD_LOCAL const char* cute_tiled_error_reason;
+extern CUTE_TILED_THREAD_LOCAL int cute_tiled_error_line;
 
 
 typedef struct cute_tiled_map_t cute_tiled_map_t;
@@ -126,6 +151,61 @@ cute_tiled_map_t* cute_tiled_load_map_from_file(const char* path, void* mem_ctx)
  */
 cute_tiled_map_t* cute_tiled_load_map_from_memory(const void* memory, int size_in_bytes, void* mem_ctx);
 
+/*!
+ * Load a map from writable memory, without copying its strings. Each string of the map is decoded
+ * in place, NUL terminated over its closing quote, and points straight into \p memory, which must
+ * outlive the map. Strings are not limited to `CUTE_TILED_INTERNAL_BUFFER_MAX` in this mode.
+ */
+cute_tiled_map_t* cute_tiled_load_map_from_memory_in_place(void* memory, int size_in_bytes, void* mem_ctx);
+
+/*!
+ * Decides whether a layer is parsed, from its name and type ("tilelayer", "objectgroup", "imagelayer"
+ * or "group"). Returns non-zero to parse the layer, or zero to skip it.
+ */
+typedef int (cute_tiled_layer_filter_fn)(const char* name, const char* type, void* udata);
+
+/*!
+ * Why a load failed. Each load keeps its own, so loads on different threads never share error state.
+ */
+typedef struct cute_tiled_error_t
+{
+	const char* reason; // The error message, or NULL if the load succeeded.
+	int line;           // The line of the JSON where the error happened.
+	int cline;          // The line in cute_tiled.h where the error was triggered.
+	char buffer[128];   // Holds `reason` when it describes the input, like an unexpected token.
+} cute_tiled_error_t;
+
+/*!
+ * Options for `cute_tiled_load_map_from_memory_ex` and `cute_tiled_load_external_tileset_from_memory_ex`. Zero
+ * initialize for the defaults.
+ */
+typedef struct cute_tiled_load_options_t
+{
+	/*!
+	 * Parse without copying strings, like `cute_tiled_load_map_from_memory_in_place`.
+	 */
+	int in_place;
+
+	/*!
+	 * Called before each layer, including those within groups, or NULL to parse all of them. Rejected
+	 * layers are skipped over in the JSON without being parsed, and a rejected group skips its children.
+	 */
+	cute_tiled_layer_filter_fn* layer_filter;
+	void* layer_filter_udata;
+
+	/*!
+	 * Filled in with why the load failed, or a NULL reason when it succeeds. Can be NULL, in which case the
+	 * failure is printed as a warning instead.
+	 */
+	cute_tiled_error_t* error;
+} cute_tiled_load_options_t;
+
+/*!
+ * Load a map from memory with the given options, or NULL for the defaults. \p memory is only written
+ * to when parsing in place.
+ */
+cute_tiled_map_t* cute_tiled_load_map_from_memory_ex(void* memory, int size_in_bytes, const cute_tiled_load_options_t* options, void* mem_ctx);
+
 /*!
  * Reverses the layers order, so they appear in reverse-order from what is shown in the Tiled editor.
  */
@@ -155,11 +235,48 @@ cute_tiled_tileset_t* cute_tiled_load_external_tileset(const char* path, void* m
  */
 cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory(const void* memory, int size_in_bytes, void* mem_ctx);
 
+/*!
+ * Load an external tileset from writable memory, without copying its strings, like
+ * `cute_tiled_load_map_from_memory_in_place`. \p memory must outlive the tileset.
+ */
+cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory_in_place(void* memory, int size_in_bytes, void* mem_ctx);
+
+/*!
+ * Load an external tileset from memory with the given options, or NULL for the defaults, like
+ * `cute_tiled_load_map_from_memory_ex`. The layer filter is not used, as tilesets hold no layers.
+ */
+cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory_ex(void* memory, int size_in_bytes, const cute_tiled_load_options_t* options, void* mem_ctx);
+
 /*!
  * Free all dynamic memory associated with this external tileset.
  */
 void cute_tiled_free_external_tileset(cute_tiled_tileset_t* tileset);
 
+/*!
+ * How much memory the parse pages of a map or external tileset take, from `cute_tiled_get_memory_stats`.
+ *
+ * Pages start at `CUTE_TILED_PAGE_SIZE` bytes and double up to `CUTE_TILED_PAGE_SIZE_MAX`, while
+ * allocations larger than a quarter of the current page get their own large block.
+ */
+typedef struct cute_tiled_memory_stats_t
+{
+	int page_count;
+	int page_bytes;
+	int large_block_count;
+	int large_block_bytes;
+	int bytes_wasted; // Left unused at the end of pages, including the free space on the current page.
+} cute_tiled_memory_stats_t;
+
+/*!
+ * Reports how much memory the parse pages of the given map take.
+ */
+void cute_tiled_get_memory_stats(const cute_tiled_map_t* map, cute_tiled_memory_stats_t* stats);
+
+/*!
+ * Whether `ptr` points within the parse pages of the given map, such as to one of its layers, objects or tilesets.
+ */
+int cute_tiled_map_owns(const cute_tiled_map_t* map, const void* ptr);
+
 #if !defined(CUTE_TILED_U64)
 	#define CUTE_TILED_U64 unsigned long long
 #endif
@@ -173,6 +290,7 @@ void cute_tiled_free_external_tileset(cute_tiled_tileset_t* tileset);
 #endif
 
 typedef struct cute_tiled_layer_t cute_tiled_layer_t;
+typedef struct cute_tiled_chunk_t cute_tiled_chunk_t;
 typedef struct cute_tiled_object_t cute_tiled_object_t;
 typedef struct cute_tiled_frame_t cute_tiled_frame_t;
 typedef struct cute_tiled_tile_descriptor_t cute_tiled_tile_descriptor_t;
@@ -304,15 +422,26 @@ static CUTE_TILED_INLINE void cute_tiled_get_flags(int tile_data_gid, int* flip_
 	*flip_diagonal = !!(tile_data_gid & CUTE_TILED_FLIPPED_DIAGONALLY_FLAG);
 }
 
+struct cute_tiled_chunk_t
+{
+	int data_count;                      // Number of integers in `data`.
+	int* data;                           // Array of GIDs, `width` by `height`.
+	int height;                          // Row count of the chunk.
+	int width;                           // Column count of the chunk.
+	int x;                               // X coordinate of the chunk in tiles.
+	int y;                               // Y coordinate of the chunk in tiles.
+	cute_tiled_chunk_t* next;            // Pointer to the next chunk. NULL if final chunk.
+};
+
 struct cute_tiled_layer_t
 {
-	/* chunks */                         // Not currently supported.
+	cute_tiled_chunk_t* chunks;          // Linked list of chunks. `tilelayer` of infinite maps only, `data` is NULL.
 	cute_tiled_string_t class_;          // The class of the layer (since 1.9, optional).
-	/* compression; */                   // Not currently supported.
+	cute_tiled_string_t compression;     // `zlib`, `gzip`, `zstd` or empty (default). `tilelayer` only.
 	int data_count;                      // Number of integers in `data`.
-	int* data;                           // Array of GIDs. `tilelayer` only. Only support CSV style exports.
+	int* data;                           // Array of GIDs. `tilelayer` only. Decoded from CSV or base64 exports.
 	cute_tiled_string_t draworder;       // `topdown` (default) or `index`. `objectgroup` only.
-	/* encoding; */                      // Not currently supported.
+	cute_tiled_string_t encoding;        // `csv` (default) or `base64`. `tilelayer` only.
 	int height;                          // Row count. Same as map height for fixed-size maps.
 	cute_tiled_layer_t* layers;          // Linked list of layers. Only appears if `type` is `group`.
 	cute_tiled_string_t name;            // Name assigned to this layer.
@@ -330,6 +459,8 @@ struct cute_tiled_layer_t
 	int width;                           // Column count. Same as map width for fixed-size maps.
 	int x;                               // Horizontal layer offset in tiles. Always 0.
 	int y;                               // Vertical layer offset in tiles. Always 0.
+	int startx;                          // X coordinate where the layer content starts in tiles. Infinite maps only.
+	int starty;                          // Y coordinate where the layer content starts in tiles. Infinite maps only.
 	float parallaxx;                     // X axis parallax factor.
 	float parallaxy;                     // Y axis parallax factor.
 	int repeatx;                         // Repeat image in the X direction
@@ -340,8 +471,18 @@ struct cute_tiled_layer_t
 	// used for image-layer
 	int imagewidth;
 	int imageheight;
+
+	void* _chunk_table;                  // For internal use only. Don't touch.
 };
 
+/*!
+ * Finds the chunk of an infinite map's tile layer that holds the tile at column \p x and
+ * row \p y, in O(1). Returns NULL for empty space, which takes no memory.
+ *
+ * int* gid = chunk->data + (y - chunk->y) * chunk->width + (x - chunk->x);
+ */
+cute_tiled_chunk_t* cute_tiled_get_chunk(const cute_tiled_layer_t* layer, int x, int y);
+
 struct cute_tiled_frame_t
 {
 	int duration;                        // Frame duration in milliseconds.
@@ -1220,7 +1361,10 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #if !defined(CUTE_TILED_WARNING)
 	#define CUTE_TILED_DEFAULT_WARNING
-	#define CUTE_TILED_WARNING(msg) cute_tiled_warning(msg, __LINE__)
+	#define CUTE_TILED_WARNING(msg) cute_tiled_warning(msg, 0, 0, __LINE__)
+	#define CUTE_TILED_WARNING_AT(path, line, msg) cute_tiled_warning(msg, path, line, __LINE__)
+#else
+	#define CUTE_TILED_WARNING_AT(path, line, msg) CUTE_TILED_WARNING(msg)
 #endif
 
 #if !defined(CUTE_TILED_MEMCPY)
@@ -1286,19 +1430,36 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 	#define CUTE_TILED_FCLOSE fclose
 #endif
 
-int cute_tiled_error_cline; 			// The line in cute_tiled.h where the error was triggered.
-const char* cute_tiled_error_reason; 		// The error message.
-int cute_tiled_error_line;  			// The line where the error happened in the json.
-const char* cute_tiled_error_file = NULL; 	// The filepath of the file being parsed. NULL if from memory.
+// Define CUTE_TILED_NO_SIMD to classify input blocks and scan CSV data one byte at a time.
+#if !defined(CUTE_TILED_NO_SIMD)
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+		#define CUTE_TILED_SIMD_AVX2
+	#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#include <emmintrin.h>
+		#define CUTE_TILED_SIMD_SSE2
+	#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && (defined(__aarch64__) || defined(_M_ARM64))
+		#include <arm_neon.h>
+		#define CUTE_TILED_SIMD_NEON
+	#endif
+	#if defined(CUTE_TILED_SIMD_AVX2) || defined(CUTE_TILED_SIMD_SSE2) || defined(CUTE_TILED_SIMD_NEON)
+		#define CUTE_TILED_SIMD
+	#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+	#include <intrin.h>
+#endif
+
+CUTE_TILED_THREAD_LOCAL const char* cute_tiled_error_reason; 		// The error message.
+CUTE_TILED_THREAD_LOCAL int cute_tiled_error_line;  			// The line where the error happened in the json.
 
 #ifdef CUTE_TILED_DEFAULT_WARNING
 	#include <stdio.h>
 
-	void cute_tiled_warning(const char* warning, int line)
+	void cute_tiled_warning(const char* warning, const char* path, int line, int cline)
 	{
-		const char *error_file = cute_tiled_error_file ? cute_tiled_error_file : "MEMORY";
-		cute_tiled_error_cline = line;
-		printf("WARNING (cute_tiled.h:%i): %s (%s:%i)\n", cute_tiled_error_cline, warning, error_file, cute_tiled_error_line);
+		printf("WARNING (cute_tiled.h:%i): %s (%s:%i)\n", cline, warning, path ? path : "MEMORY", line);
 	}
 #endif
 
@@ -1316,17 +1477,28 @@ const char* cute_tiled_error_file = NULL; 	// The filepath of the file being par
 	#define CUTE_TILED_STRTOD strtod
 #endif
 
+#include <float.h> // FLT_EVAL_METHOD
+
 typedef struct cute_tiled_page_t cute_tiled_page_t;
 typedef struct cute_tiled_map_internal_t cute_tiled_map_internal_t;
 
 struct cute_tiled_page_t
 {
 	cute_tiled_page_t* next;
+	int size;
 	void* data;
 };
 
 #define CUTE_TILED_INTERNAL_BUFFER_MAX 1024
 
+#if !defined(CUTE_TILED_PAGE_SIZE)
+	#define CUTE_TILED_PAGE_SIZE (1024 * 10)
+#endif
+
+#if !defined(CUTE_TILED_PAGE_SIZE_MAX)
+	#define CUTE_TILED_PAGE_SIZE_MAX (1024 * 1024)
+#endif
+
 struct cute_tiled_map_internal_t
 {
 	char* in;
@@ -1336,23 +1508,49 @@ struct cute_tiled_map_internal_t
 	void* mem_ctx;
 	int page_size;
 	int bytes_left_on_page;
+	int bytes_wasted;
 	cute_tiled_page_t* pages;
-	int scratch_len;
+	cute_tiled_page_t* large_blocks;
+	int in_place;
+	cute_tiled_layer_filter_fn* layer_filter;
+	void* layer_filter_udata;
+	const char* path; // The file being parsed, or NULL if from memory.
+	cute_tiled_error_t error; // Where and why the parse failed, counting lines as it goes.
+	char* string; // The last string read, either in `scratch` or in place within the input.
+	int string_len;
 	char scratch[CUTE_TILED_INTERNAL_BUFFER_MAX];
 };
 
+static cute_tiled_page_t* cute_tiled_alloc_page(cute_tiled_page_t** list, int size, void* mem_ctx)
+{
+	cute_tiled_page_t* page = (cute_tiled_page_t*)CUTE_TILED_ALLOC(sizeof(cute_tiled_page_t) + size, mem_ctx);
+	if (!page) return 0;
+	page->next = *list;
+	page->size = size;
+	page->data = page + 1;
+	*list = page;
+	return page;
+}
+
 void* cute_tiled_alloc(cute_tiled_map_internal_t* m, int size)
 {
 	void* data;
-	if (size > m->page_size) return NULL; // Should never happen.
+	int page_size;
 	if (m->bytes_left_on_page < size)
 	{
-		cute_tiled_page_t* page = (cute_tiled_page_t*)CUTE_TILED_ALLOC(sizeof(cute_tiled_page_t) + m->page_size, m->mem_ctx);
-		if (!page) return 0;
-		page->next = m->pages;
-		page->data = page + 1;
-		m->pages = page;
-		m->bytes_left_on_page = m->page_size;
+		// Large allocations get their own block, rather than throwing away the rest of the page.
+		if (size > m->page_size / 4)
+		{
+			cute_tiled_page_t* block = cute_tiled_alloc_page(&m->large_blocks, size, m->mem_ctx);
+			return block ? block->data : 0;
+		}
+
+		// Each new page is twice the size of the last, so maps with many objects only take a few pages.
+		page_size = m->page_size < CUTE_TILED_PAGE_SIZE_MAX / 2 ? m->page_size * 2 : CUTE_TILED_PAGE_SIZE_MAX;
+		if (!cute_tiled_alloc_page(&m->pages, page_size, m->mem_ctx)) return 0;
+		m->bytes_wasted += m->bytes_left_on_page;
+		m->page_size = page_size;
+		m->bytes_left_on_page = page_size;
 	}
 
 	data = ((char*)m->pages->data) + (m->page_size - m->bytes_left_on_page);
@@ -1397,30 +1595,27 @@ static char* cute_tiled_read_file_to_memory_and_null_terminate(const char* path,
 	return data;
 }
 
+static cute_tiled_map_t* cute_tiled_load_map_internal(void* memory, int size_in_bytes, void* mem_ctx, const cute_tiled_load_options_t* options, const char* path);
+
 cute_tiled_map_t* cute_tiled_load_map_from_file(const char* path, void* mem_ctx)
 {
 	int size;
 	void* file;
 	cute_tiled_map_t* map;
-	cute_tiled_error_file = path;
 
 	file = cute_tiled_read_file_to_memory_and_null_terminate(path, &size, mem_ctx);
-	if (!file) CUTE_TILED_WARNING("Unable to find map file.");
-	map = cute_tiled_load_map_from_memory(file, size, mem_ctx);
+	if (!file) CUTE_TILED_WARNING_AT(path, 0, "Unable to find map file.");
+	map = cute_tiled_load_map_internal(file, size, mem_ctx, 0, path);
 	CUTE_TILED_FREE(file, mem_ctx);
 
-	cute_tiled_error_file = NULL;
-
 	return map;
 }
 
-#define CUTE_TILED_CHECK(X, Y) do { if (!(X)) { cute_tiled_error_reason = Y; cute_tiled_error_cline = __LINE__; goto cute_tiled_err; } } while (0)
+#define CUTE_TILED_CHECK(X, Y) do { if (!(X)) { m->error.reason = Y; m->error.cline = __LINE__; goto cute_tiled_err; } } while (0)
 #define CUTE_TILED_FAIL_IF(X) do { if (X) { goto cute_tiled_err; } } while (0)
 
 static int cute_tiled_isspace(char c)
 {
-	cute_tiled_error_line += c == '\n';
-
 	return (c == ' ') |
 		(c == '\t') |
 		(c == '\n') |
@@ -1431,7 +1626,7 @@ static int cute_tiled_isspace(char c)
 
 static char cute_tiled_peak(cute_tiled_map_internal_t* m)
 {
-	while (cute_tiled_isspace(*m->in)) m->in++;
+	while (cute_tiled_isspace(*m->in)) m->error.line += *m->in++ == '\n';
 	return *m->in;
 }
 
@@ -1445,7 +1640,7 @@ static char cute_tiled_next(cute_tiled_map_internal_t* m)
 {
 	char c;
 	if (m->in == m->end) CUTE_TILED_CRASH();
-	while (cute_tiled_isspace(c = *m->in++));
+	while (cute_tiled_isspace(c = *m->in++)) m->error.line += c == '\n';
 	return c;
 }
 
@@ -1470,9 +1665,10 @@ static int cute_tiled_try(cute_tiled_map_internal_t* m, char expect)
 
 #define cute_tiled_expect(m, expect) \
 	do { \
-		static char error[128]; \
-		CUTE_TILED_SNPRINTF(error, sizeof(error), "Found unexpected token '%c', expected '%c' (is this a valid JSON file?).", *m->in, expect); \
-		CUTE_TILED_CHECK(cute_tiled_next(m) == (expect), error); \
+		if (cute_tiled_next(m) != (expect)) { \
+			CUTE_TILED_SNPRINTF(m->error.buffer, sizeof(m->error.buffer), "Found unexpected token '%c', expected '%c' (is this a valid JSON file?).", m->in[-1], expect); \
+			CUTE_TILED_CHECK(0, m->error.buffer); \
+		} \
 	} while (0)
 
 char cute_tiled_parse_char(char c)
@@ -1483,6 +1679,7 @@ char cute_tiled_parse_char(char c)
 		case '\'': return '\'';
 		case '"': return '"';
 		case 't': return '\t';
+		case 'b': return '\b';
 		case 'f': return '\f';
 		case 'n': return '\n';
 		case 'r': return '\r';
@@ -1491,38 +1688,296 @@ char cute_tiled_parse_char(char c)
 	}
 }
 
-static int cute_tiled_skip_object_internal(cute_tiled_map_internal_t* m)
+static int cute_tiled_parse_hex4(const char* in, const char* end, uint32_t* out)
 {
-	int depth = 1;
-	cute_tiled_expect(m, '{');
+	int i;
+	uint32_t val = 0;
+	if (end - in < 4) return 0;
+	for (i = 0; i < 4; ++i)
+	{
+		char c = in[i];
+		val <<= 4;
+		if (c >= '0' && c <= '9') val |= (uint32_t)(c - '0');
+		else if (c >= 'a' && c <= 'f') val |= (uint32_t)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') val |= (uint32_t)(c - 'A' + 10);
+		else return 0;
+	}
+	*out = val;
+	return 1;
+}
 
-	while (depth) {
-		char c;
-		CUTE_TILED_CHECK(m->in <= m->end, "Attempted to read passed input buffer (is this a valid JSON file?).");
+// Decodes the escape at `*in`, just past its backslash, into `out` and moves `*in` past it. `\uXXXX`
+// escapes, and surrogate pairs of them, become UTF-8. Returns how many bytes were written, up to 4.
+// All of the escape is read before `out` is written, so `out` may trail `*in` when decoding in place.
+static int cute_tiled_parse_escape(char** in, const char* end, char* out)
+{
+	char* p = *in;
+	uint32_t code, low;
+	if (*p != 'u' || !cute_tiled_parse_hex4(p + 1, end, &code))
+	{
+		*out = cute_tiled_parse_char(*p);
+		*in = p + 1;
+		return 1;
+	}
 
-		c = cute_tiled_next(m);
+	p += 5;
+	if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u' && cute_tiled_parse_hex4(p + 2, end, &low) && low >= 0xDC00 && low < 0xE000)
+	{
+		code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+		p += 6;
+	}
+	*in = p;
+
+	if (code < 0x80)
+	{
+		out[0] = (char)code;
+		return 1;
+	}
+	if (code < 0x800)
+	{
+		out[0] = (char)(0xC0 | (code >> 6));
+		out[1] = (char)(0x80 | (code & 0x3F));
+		return 2;
+	}
+	if (code < 0x10000)
+	{
+		out[0] = (char)(0xE0 | (code >> 12));
+		out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+		out[2] = (char)(0x80 | (code & 0x3F));
+		return 3;
+	}
+	out[0] = (char)(0xF0 | (code >> 18));
+	out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+	out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+	out[3] = (char)(0x80 | (code & 0x3F));
+	return 4;
+}
+
+/*
+	Structural classification, simdjson style. The input is classified 64 bytes at a time into
+	bitmasks, one bit per byte, so skipping a value only visits its brackets rather than every
+	byte within it.
+*/
+
+#define CUTE_TILED_BLOCK_SIZE 64
+#define CUTE_TILED_ODD_BITS 0xAAAAAAAAAAAAAAAAULL
+
+typedef struct cute_tiled_block_t
+{
+	CUTE_TILED_U64 quote;
+	CUTE_TILED_U64 backslash;
+	CUTE_TILED_U64 open;
+	CUTE_TILED_U64 close;
+	CUTE_TILED_U64 newline;
+} cute_tiled_block_t;
+
+// Carried from one block to the next.
+typedef struct cute_tiled_block_state_t
+{
+	CUTE_TILED_U64 next_is_escaped;
+	CUTE_TILED_U64 in_string;
+} cute_tiled_block_state_t;
+
+static CUTE_TILED_INLINE int cute_tiled_ctz64(CUTE_TILED_U64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return (int)index;
+#else
+	int n = 0;
+	while (!(x & 1)) { x >>= 1; ++n; }
+	return n;
+#endif
+}
+
+static CUTE_TILED_INLINE int cute_tiled_popcount64(CUTE_TILED_U64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(x);
+#else
+	int n = 0;
+	while (x) { x &= x - 1; ++n; }
+	return n;
+#endif
+}
+
+#if defined(CUTE_TILED_SIMD_AVX2)
+static CUTE_TILED_INLINE CUTE_TILED_U64 cute_tiled_eq_mask(const __m256i* chunks, char c)
+{
+	__m256i v = _mm256_set1_epi8(c);
+	CUTE_TILED_U64 m0 = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunks[0], v));
+	CUTE_TILED_U64 m1 = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunks[1], v));
+	return m0 | (m1 << 32);
+}
+#elif defined(CUTE_TILED_SIMD_SSE2)
+static CUTE_TILED_INLINE CUTE_TILED_U64 cute_tiled_eq_mask(const __m128i* chunks, char c)
+{
+	__m128i v = _mm_set1_epi8(c);
+	CUTE_TILED_U64 m0 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[0], v));
+	CUTE_TILED_U64 m1 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[1], v));
+	CUTE_TILED_U64 m2 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[2], v));
+	CUTE_TILED_U64 m3 = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[3], v));
+	return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+}
+#elif defined(CUTE_TILED_SIMD_NEON)
+static CUTE_TILED_INLINE CUTE_TILED_U64 cute_tiled_eq_mask(const uint8x16_t* chunks, char c)
+{
+	// NEON has no movemask, so each matching byte keeps the bit of its position within 8 bytes, and
+	// pairwise adds fold every 8 bytes down to one.
+	static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t bits = vld1q_u8(weights);
+	uint8x16_t v = vdupq_n_u8((uint8_t)c);
+	uint8x16_t m0 = vandq_u8(vceqq_u8(chunks[0], v), bits);
+	uint8x16_t m1 = vandq_u8(vceqq_u8(chunks[1], v), bits);
+	uint8x16_t m2 = vandq_u8(vceqq_u8(chunks[2], v), bits);
+	uint8x16_t m3 = vandq_u8(vceqq_u8(chunks[3], v), bits);
+	uint8x16_t sum = vpaddq_u8(vpaddq_u8(m0, m1), vpaddq_u8(m2, m3));
+	sum = vpaddq_u8(sum, sum);
+	return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+}
+#endif
 
-		switch(c)
+// Classifies the 64 bytes at `in`, looking for the given pair of brackets.
+static void cute_tiled_classify_block(const char* in, char open, char close, cute_tiled_block_t* block)
+{
+#if defined(CUTE_TILED_SIMD_AVX2)
+	__m256i chunks[2];
+	chunks[0] = _mm256_loadu_si256((const __m256i*)in);
+	chunks[1] = _mm256_loadu_si256((const __m256i*)(in + 32));
+#elif defined(CUTE_TILED_SIMD_SSE2)
+	__m128i chunks[4];
+	chunks[0] = _mm_loadu_si128((const __m128i*)in);
+	chunks[1] = _mm_loadu_si128((const __m128i*)(in + 16));
+	chunks[2] = _mm_loadu_si128((const __m128i*)(in + 32));
+	chunks[3] = _mm_loadu_si128((const __m128i*)(in + 48));
+#elif defined(CUTE_TILED_SIMD_NEON)
+	uint8x16_t chunks[4];
+	chunks[0] = vld1q_u8((const uint8_t*)in);
+	chunks[1] = vld1q_u8((const uint8_t*)(in + 16));
+	chunks[2] = vld1q_u8((const uint8_t*)(in + 32));
+	chunks[3] = vld1q_u8((const uint8_t*)(in + 48));
+#endif
+
+#ifdef CUTE_TILED_SIMD
+	block->quote = cute_tiled_eq_mask(chunks, '"');
+	block->backslash = cute_tiled_eq_mask(chunks, '\\');
+	block->open = cute_tiled_eq_mask(chunks, open);
+	block->close = cute_tiled_eq_mask(chunks, close);
+	block->newline = cute_tiled_eq_mask(chunks, '\n');
+#else
+	int i;
+	CUTE_TILED_MEMSET(block, 0, sizeof(cute_tiled_block_t));
+	for (i = 0; i < CUTE_TILED_BLOCK_SIZE; ++i)
+	{
+		CUTE_TILED_U64 bit = 1ULL << i;
+		char c = in[i];
+		if (c == '"') block->quote |= bit;
+		else if (c == '\\') block->backslash |= bit;
+		else if (c == open) block->open |= bit;
+		else if (c == close) block->close |= bit;
+		else if (c == '\n') block->newline |= bit;
+	}
+#endif
+}
+
+// Returns the mask of bytes inside strings, including opening quotes but not closing ones.
+static CUTE_TILED_U64 cute_tiled_string_mask(cute_tiled_block_t* block, cute_tiled_block_state_t* state)
+{
+	CUTE_TILED_U64 escaped = state->next_is_escaped;
+	CUTE_TILED_U64 quotes;
+	CUTE_TILED_U64 in_string;
+
+	// Backslashes escape the character after them, unless they are escaped themselves.
+	if (block->backslash)
+	{
+		CUTE_TILED_U64 potential_escape = block->backslash & ~state->next_is_escaped;
+		CUTE_TILED_U64 maybe_escaped = potential_escape << 1;
+		CUTE_TILED_U64 escape_and_terminal_code = ((maybe_escaped | CUTE_TILED_ODD_BITS) - potential_escape) ^ CUTE_TILED_ODD_BITS;
+		escaped = escape_and_terminal_code ^ (block->backslash | state->next_is_escaped);
+		state->next_is_escaped = (escape_and_terminal_code & block->backslash) >> 63;
+	}
+	else
+	{
+		state->next_is_escaped = 0;
+	}
+
+	// Prefix XOR of the unescaped quotes flips in and out of strings.
+	quotes = block->quote & ~escaped;
+	in_string = quotes;
+	in_string ^= in_string << 1;
+	in_string ^= in_string << 2;
+	in_string ^= in_string << 4;
+	in_string ^= in_string << 8;
+	in_string ^= in_string << 16;
+	in_string ^= in_string << 32;
+	in_string ^= state->in_string;
+	state->in_string = (CUTE_TILED_U64)0 - (in_string >> 63);
+	return in_string;
+}
+
+// Skips the value starting at `m->in`, up to and including the `close` that matches its `open`.
+// Brackets inside strings are ignored.
+static int cute_tiled_skip_nested_internal(cute_tiled_map_internal_t* m, char open, char close)
+{
+	int depth = 0;
+	cute_tiled_block_state_t state;
+	char tail[CUTE_TILED_BLOCK_SIZE];
+	CUTE_TILED_CHECK(cute_tiled_peak(m) == open, "Found unexpected token (is this a valid JSON file?).");
+	CUTE_TILED_MEMSET(&state, 0, sizeof(state));
+
+	while (m->in < m->end)
+	{
+		cute_tiled_block_t block;
+		CUTE_TILED_U64 in_string;
+		CUTE_TILED_U64 brackets;
+		const char* in = m->in;
+		int size = (int)(m->end - m->in);
+
+		// The last block is padded out, so blocks never read past the input.
+		if (size < CUTE_TILED_BLOCK_SIZE)
 		{
-		case '{':
-			depth += 1;
-			break;
+			CUTE_TILED_MEMSET(tail, ' ', sizeof(tail));
+			CUTE_TILED_MEMCPY(tail, m->in, size);
+			in = tail;
+		}
+		else size = CUTE_TILED_BLOCK_SIZE;
 
-		case '}':
-			depth -= 1;
-			break;
+		cute_tiled_classify_block(in, open, close, &block);
+		in_string = cute_tiled_string_mask(&block, &state);
+		brackets = (block.open | block.close) & ~in_string;
 
-		default:
-			break;
+		while (brackets)
+		{
+			int i = cute_tiled_ctz64(brackets);
+			CUTE_TILED_U64 bit = 1ULL << i;
+			depth += (block.open & bit) ? 1 : -1;
+			if (!depth)
+			{
+				m->error.line += cute_tiled_popcount64(block.newline & (bit - 1));
+				m->in += i + 1;
+				return 1;
+			}
+			brackets &= brackets - 1;
 		}
+
+		m->error.line += cute_tiled_popcount64(block.newline);
+		m->in += size;
 	}
 
-	return 1;
+	CUTE_TILED_CHECK(0, "Attempted to read passed input buffer (is this a valid JSON file?).");
 
 cute_tiled_err:
 	return 0;
 }
 
+static int cute_tiled_skip_object_internal(cute_tiled_map_internal_t* m)
+{
+	return cute_tiled_skip_nested_internal(m, '{', '}');
+}
+
 #define cute_tiled_skip_object(m) \
 	do { \
 		CUTE_TILED_FAIL_IF(!cute_tiled_skip_object_internal(m)); \
@@ -1530,47 +1985,51 @@ cute_tiled_err:
 
 static int cute_tiled_skip_array_internal(cute_tiled_map_internal_t* m)
 {
-	int depth = 1;
-	cute_tiled_expect(m, '[');
+	return cute_tiled_skip_nested_internal(m, '[', ']');
+}
 
-	while (depth)
-	{
-		char c;
-		CUTE_TILED_CHECK(m->in <= m->end, "Attempted to read passed input buffer (is this a valid JSON file?).");
+#define cute_tiled_skip_array(m) \
+	do { \
+		CUTE_TILED_FAIL_IF(!cute_tiled_skip_array_internal(m)); \
+	} while (0)
 
-		c = cute_tiled_next(m);
+// Reads a string in place, by writing a NUL over its closing quote. Only strings with escapes
+// are moved, since decoding an escape shortens the string.
+static int cute_tiled_read_string_in_place(cute_tiled_map_internal_t* m)
+{
+	char* out;
+	m->string = m->in;
+	while (m->in < m->end && *m->in != '"' && *m->in != '\\') m->in++;
 
-		switch(c)
+	out = m->in;
+	while (m->in < m->end && *m->in != '"')
+	{
+		char c = *m->in++;
+		if (c == '\\')
 		{
-		case '[':
-			depth += 1;
-			break;
-
-		case ']':
-			depth -= 1;
-			break;
-
-		default:
-			break;
+			CUTE_TILED_CHECK(m->in < m->end, "Unterminated string found during parse.");
+			out += cute_tiled_parse_escape(&m->in, m->end, out);
+			continue;
 		}
+		*out++ = c;
 	}
 
+	CUTE_TILED_CHECK(m->in < m->end, "Unterminated string found during parse.");
+	m->in++;
+	*out = 0;
+	m->string_len = (int)(out - m->string);
 	return 1;
 
 cute_tiled_err:
 	return 0;
 }
 
-#define cute_tiled_skip_array(m) \
-	do { \
-		CUTE_TILED_FAIL_IF(!cute_tiled_skip_array_internal(m)); \
-	} while (0)
-
 static int cute_tiled_read_string_internal(cute_tiled_map_internal_t* m)
 {
 	int count = 0;
 	int done = 0;
 	cute_tiled_expect(m, '"');
+	if (m->in_place) return cute_tiled_read_string_in_place(m);
 
 	while (!done)
 	{
@@ -1587,8 +2046,13 @@ static int cute_tiled_read_string_internal(cute_tiled_map_internal_t* m)
 
 		case '\\':
 		{
-			char the_char = cute_tiled_parse_char(cute_tiled_string_next(m));
-			m->scratch[count++] = the_char;
+			char decoded[4];
+			int len;
+			if (m->in == m->end) CUTE_TILED_CRASH();
+			len = cute_tiled_parse_escape(&m->in, m->end, decoded);
+			CUTE_TILED_CHECK(count + len < CUTE_TILED_INTERNAL_BUFFER_MAX, "String exceeded max length of CUTE_TILED_INTERNAL_BUFFER_MAX.");
+			CUTE_TILED_MEMCPY(m->scratch + count, decoded, len);
+			count += len;
 		}	break;
 
 		default:
@@ -1597,7 +2061,8 @@ static int cute_tiled_read_string_internal(cute_tiled_map_internal_t* m)
 		}
 	}
 
-	m->scratch_len = count;
+	m->string = m->scratch;
+	m->string_len = count;
 	return 1;
 
 cute_tiled_err:
@@ -1676,10 +2141,120 @@ cute_tiled_err:
 		CUTE_TILED_FAIL_IF(!cute_tiled_read_hex_int_internal(m, num)); \
 	} while (0)
 
+#define CUTE_TILED_FAST_FLOAT_MAX_DIGITS 19
+#define CUTE_TILED_FAST_FLOAT_MAX_MANTISSA (1ULL << 53)
+
+static const double cute_tiled_pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/*
+	Locale independent strtod for JSON numbers. Short decimals take Clinger's fast path: when the
+	digits fit in a double's 53 bit mantissa and the power of ten is exactly representable, one
+	IEEE multiply or divide is correctly rounded, so the result is bit identical to strtod. Anything
+	else (long mantissas, large exponents, hex, inf/nan) falls back to CUTE_TILED_STRTOD.
+*/
+static double cute_tiled_strtod(const char* in, char** end)
+{
+	const char* p = in;
+	CUTE_TILED_U64 mantissa = 0;
+	int digits = 0;
+	int any_digits = 0;
+	int exponent = 0;
+	int negative = 0;
+	double val;
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+	// Extended precision intermediates (x87) would round twice.
+	goto cute_tiled_slow;
+#endif
+
+	if (*p == '-') { negative = 1; ++p; }
+
+	// Integer part, not counting leading zeros as significant.
+	while (*p == '0') { any_digits = 1; ++p; }
+	while ((unsigned)(*p - '0') < 10)
+	{
+		if (digits == CUTE_TILED_FAST_FLOAT_MAX_DIGITS) goto cute_tiled_slow;
+		mantissa = mantissa * 10 + (CUTE_TILED_U64)(*p - '0');
+		++digits;
+		any_digits = 1;
+		++p;
+	}
+	if ((*p == 'x') | (*p == 'X')) goto cute_tiled_slow;
+
+	// Fraction part.
+	if (*p == '.')
+	{
+		++p;
+		if ((unsigned)(*p - '0') >= 10) goto cute_tiled_slow;
+		while ((unsigned)(*p - '0') < 10)
+		{
+			if (mantissa || *p != '0')
+			{
+				if (digits == CUTE_TILED_FAST_FLOAT_MAX_DIGITS) goto cute_tiled_slow;
+				++digits;
+			}
+			mantissa = mantissa * 10 + (CUTE_TILED_U64)(*p - '0');
+			--exponent;
+			any_digits = 1;
+			++p;
+		}
+	}
+
+	if (!any_digits) goto cute_tiled_slow;
+
+	// Exponent part.
+	if ((*p == 'e') | (*p == 'E'))
+	{
+		int exponent_negative = 0;
+		int explicit_exponent = 0;
+		++p;
+		if (*p == '-') { exponent_negative = 1; ++p; }
+		else if (*p == '+') ++p;
+		if ((unsigned)(*p - '0') >= 10) goto cute_tiled_slow;
+		while ((unsigned)(*p - '0') < 10)
+		{
+			if (explicit_exponent > 9999) goto cute_tiled_slow;
+			explicit_exponent = explicit_exponent * 10 + (*p - '0');
+			++p;
+		}
+		exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
+	}
+
+	if (!mantissa)
+	{
+		val = 0.0;
+	}
+	else
+	{
+		if (mantissa > CUTE_TILED_FAST_FLOAT_MAX_MANTISSA) goto cute_tiled_slow;
+
+		// Move surplus powers of ten into the mantissa while it stays exact, e.g. 12e25 = 12000e22.
+		while (exponent > 22 && mantissa * 10 <= CUTE_TILED_FAST_FLOAT_MAX_MANTISSA)
+		{
+			mantissa *= 10;
+			--exponent;
+		}
+
+		if ((exponent < -22) | (exponent > 22)) goto cute_tiled_slow;
+		val = (double)mantissa;
+		if (exponent < 0) val /= cute_tiled_pow10[-exponent];
+		else val *= cute_tiled_pow10[exponent];
+	}
+
+	if (end) *end = (char*)p;
+	return negative ? -val : val;
+
+cute_tiled_slow:
+	return CUTE_TILED_STRTOD(in, end);
+}
+
 static int cute_tiled_read_float_internal(cute_tiled_map_internal_t* m, float* out)
 {
 	char* end;
-	float val = (float)strtod(m->in, &end);
+	float val = (float)cute_tiled_strtod(m->in, &end);
 	CUTE_TILED_CHECK(m->in != end, "Invalid integer found during parse.");
 	m->in = end;
 	*out = val;
@@ -1722,48 +2297,614 @@ cute_tiled_err:
 		CUTE_TILED_FAIL_IF(!cute_tiled_read_bool_internal(m, b)); \
 	} while (0)
 
-int cute_tiled_read_csv_integers_internal(cute_tiled_map_internal_t* m, int* count_out, int** out)
+static CUTE_TILED_INLINE int cute_tiled_popcount(uint32_t x)
 {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcount(x);
+#else
+	x = x - ((x >> 1) & 0x55555555);
+	x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+	return (int)((((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+#endif
+}
+
+// Finds the `]` closing a CSV array starting at `in`, and counts the commas before it. Scans
+// 16 or 32 bytes at a time when SIMD is available. Returns NULL if `end` is reached first.
+static const char* cute_tiled_csv_scan(const char* in, const char* end, int* commas)
+{
+	const char* p = in;
 	int count = 0;
-	int capacity = 1024;
-	int* integers = (int*)CUTE_TILED_ALLOC(capacity * sizeof(int), m->mem_ctx);
 
-	char c;
-	do
+#if defined(CUTE_TILED_SIMD_AVX2)
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i close = _mm256_set1_epi8(']');
+	while (end - p >= 32)
 	{
-		int val;
-		cute_tiled_read_int(m, &val);
-		if (count == capacity)
+		__m256i v = _mm256_loadu_si256((const __m256i*)p);
+		uint32_t comma_mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, comma));
+		uint32_t close_mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, close));
+		if (close_mask)
 		{
-			int* new_integers;
-			capacity *= 2;
-			new_integers = (int*)CUTE_TILED_ALLOC(capacity * sizeof(int), m->mem_ctx);
-			CUTE_TILED_MEMCPY(new_integers, integers, sizeof(int) * count);
-			CUTE_TILED_FREE(integers, m->mem_ctx);
-			integers = new_integers;
+			uint32_t before = (close_mask & (0U - close_mask)) - 1;
+			*commas = count + cute_tiled_popcount(comma_mask & before);
+			return p + cute_tiled_popcount(before);
 		}
-		integers[count++] = val;
-		c = cute_tiled_next(m);
+		count += cute_tiled_popcount(comma_mask);
+		p += 32;
+	}
+#elif defined(CUTE_TILED_SIMD_SSE2)
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i close = _mm_set1_epi8(']');
+	while (end - p >= 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		uint32_t comma_mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma));
+		uint32_t close_mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, close));
+		if (close_mask)
+		{
+			uint32_t before = (close_mask & (0U - close_mask)) - 1;
+			*commas = count + cute_tiled_popcount(comma_mask & before);
+			return p + cute_tiled_popcount(before);
+		}
+		count += cute_tiled_popcount(comma_mask);
+		p += 16;
+	}
+#elif defined(CUTE_TILED_SIMD_NEON)
+	const uint8x16_t comma = vdupq_n_u8(',');
+	const uint8x16_t close = vdupq_n_u8(']');
+	while (end - p >= 16)
+	{
+		uint8x16_t v = vld1q_u8((const uint8_t*)p);
+		if (vmaxvq_u8(vceqq_u8(v, close))) break; // The scalar loop finds the exact position.
+		count += vaddvq_u8(vshrq_n_u8(vceqq_u8(v, comma), 7));
+		p += 16;
 	}
-	while (c != ']');
+#endif
 
-	*count_out = count;
-	*out = integers;
-	return 1;
+	for (; p < end; ++p)
+	{
+		if (*p == ']')
+		{
+			*commas = count;
+			return p;
+		}
+		count += *p == ',';
+	}
 
-cute_tiled_err:
 	return 0;
 }
 
-#define cute_tiled_read_csv_integers(m, count_out, out) \
-	do { \
-		CUTE_TILED_FAIL_IF(!cute_tiled_read_csv_integers_internal(m, count_out, out)); \
-	} while (0)
-
-int cute_tiled_intern_string_internal(cute_tiled_map_internal_t* m, cute_tiled_string_t* out)
+// Reads the GIDs of a CSV `data` array, right after its opening `[`. The separators are
+// counted up front so the output is allocated exactly once. Values past INT_MAX wrap like
+// the previous `strtoll` cast did, keeping the flip flags in the high bits.
+int cute_tiled_read_csv_integers_internal(cute_tiled_map_internal_t* m, int* count_out, int** out)
+{
+	int i;
+	int count;
+	int* integers = 0;
+	const char* p = m->in;
+	const char* close = cute_tiled_csv_scan(p, m->end, &count);
+	if (!close)
+	{
+		// Report the line the input ran out on, as the byte-wise reader would have.
+		while (p < m->end) m->error.line += *p++ == '\n';
+		CUTE_TILED_CHECK(0, "Attempted to read passed input buffer (is this a valid JSON file?).");
+	}
+
+	while (cute_tiled_isspace(*p)) m->error.line += *p++ == '\n';
+	count = p == close ? 0 : count + 1;
+
+	if (count)
+	{
+		CUTE_TILED_CHECK(count <= 0x7FFFFFFF / (int)sizeof(int), "Too much tile data.");
+		integers = (int*)CUTE_TILED_ALLOC(count * sizeof(int), m->mem_ctx);
+		CUTE_TILED_CHECK(integers, "Unable to allocate memory for tile data.");
+	}
+
+	for (i = 0; i < count; ++i)
+	{
+		uint32_t val = 0;
+		int negative = 0;
+		const char* digits;
+
+		while (cute_tiled_isspace(*p)) m->error.line += *p++ == '\n';
+		if (*p == '-')
+		{
+			negative = 1;
+			++p;
+		}
+
+		digits = p;
+		while ((unsigned)(*p - '0') < 10)
+		{
+			val = val * 10 + (uint32_t)(*p - '0');
+			++p;
+		}
+
+		if (*p == '.') do ++p; while ((unsigned)(*p - '0') < 10); // Skip the decimal part of floats.
+		while (cute_tiled_isspace(*p)) m->error.line += *p++ == '\n';
+		if (p == digits || *p++ != (i + 1 < count ? ',' : ']'))
+		{
+			CUTE_TILED_FREE(integers, m->mem_ctx);
+			CUTE_TILED_CHECK(0, "Invalid integer found during parse.");
+		}
+
+		integers[i] = (int)(negative ? 0U - val : val);
+	}
+
+	m->in = (char*)close + 1;
+	*count_out = count;
+	*out = integers;
+	return 1;
+
+cute_tiled_err:
+	return 0;
+}
+
+#define cute_tiled_read_csv_integers(m, count_out, out) \
+	do { \
+		CUTE_TILED_FAIL_IF(!cute_tiled_read_csv_integers_internal(m, count_out, out)); \
+	} while (0)
+
+static CUTE_TILED_INLINE int cute_tiled_base64_value(char c)
+{
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+') return 62;
+	if (c == '/') return 63;
+	return -1;
+}
+
+// Decodes `in_len` characters of base64 into `out`. Whitespace and JSON escape slashes
+// (`\/`) are skipped, decoding stops at the first '='. Returns the number of bytes written,
+// or -1 on invalid input or if `out_size` is too small.
+int cute_tiled_base64_decode(const char* in, int in_len, unsigned char* out, int out_size)
+{
+	int i;
+	int count = 0;
+	int bits = 0;
+	uint32_t accum = 0;
+
+	for (i = 0; i < in_len; ++i)
+	{
+		char c = in[i];
+		int value;
+		if (c == '=') break;
+		if ((c == '\\') | (c == ' ') | (c == '\n') | (c == '\r') | (c == '\t')) continue;
+		value = cute_tiled_base64_value(c);
+		if (value < 0) return -1;
+		accum = (accum << 6) | (uint32_t)value;
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			if (count == out_size) return -1;
+			out[count++] = (unsigned char)(accum >> bits);
+		}
+	}
+
+	return count;
+}
+
+#if !defined(CUTE_TILED_NO_INFLATE)
+
+// Minimal DEFLATE (RFC 1951) decoder, used for `zlib` and `gzip` compressed tile layers.
+// Decodes with canonical Huffman tables, trading peak speed for a tiny footprint. Tile
+// layers are small relative to the JSON they replace, so this is never the bottleneck.
+
+typedef struct cute_tiled_huffman_t
+{
+	short count[16];
+	short symbol[288];
+} cute_tiled_huffman_t;
+
+typedef struct cute_tiled_inflate_t
+{
+	const unsigned char* in;
+	const unsigned char* in_end;
+	uint32_t bitbuf;
+	int bitcnt;
+	unsigned char* out;
+	unsigned char* out_begin;
+	unsigned char* out_end;
+	int error;
+} cute_tiled_inflate_t;
+
+static int cute_tiled_inflate_bits(cute_tiled_inflate_t* s, int need)
+{
+	uint32_t val = s->bitbuf;
+	while (s->bitcnt < need)
+	{
+		if (s->in == s->in_end)
+		{
+			s->error = 1;
+			return 0;
+		}
+		val |= (uint32_t)(*s->in++) << s->bitcnt;
+		s->bitcnt += 8;
+	}
+	s->bitbuf = need < 32 ? val >> need : 0;
+	s->bitcnt -= need;
+	return (int)(val & ((1UL << need) - 1));
+}
+
+static int cute_tiled_inflate_decode(cute_tiled_inflate_t* s, const cute_tiled_huffman_t* h)
+{
+	int len;
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	for (len = 1; len <= 15; ++len)
+	{
+		int count;
+		code |= cute_tiled_inflate_bits(s, 1);
+		if (s->error) return -1;
+		count = h->count[len];
+		if (code - count < first) return h->symbol[index + (code - first)];
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+	return -1;
+}
+
+static int cute_tiled_inflate_construct(cute_tiled_huffman_t* h, const short* length, int n)
+{
+	int symbol, len, left;
+	short offs[16];
+
+	for (len = 0; len <= 15; ++len) h->count[len] = 0;
+	for (symbol = 0; symbol < n; ++symbol) h->count[length[symbol]]++;
+	if (h->count[0] == n) return 0;
+
+	left = 1;
+	for (len = 1; len <= 15; ++len)
+	{
+		left <<= 1;
+		left -= h->count[len];
+		if (left < 0) return left;
+	}
+
+	offs[1] = 0;
+	for (len = 1; len < 15; ++len) offs[len + 1] = offs[len] + h->count[len];
+	for (symbol = 0; symbol < n; ++symbol)
+		if (length[symbol] != 0) h->symbol[offs[length[symbol]]++] = (short)symbol;
+
+	return left;
+}
+
+static int cute_tiled_inflate_codes(cute_tiled_inflate_t* s, const cute_tiled_huffman_t* lencode, const cute_tiled_huffman_t* distcode)
+{
+	static const short lbase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const short lext[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const short dbase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	static const short dext[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	int symbol;
+
+	do
+	{
+		symbol = cute_tiled_inflate_decode(s, lencode);
+		if (symbol < 0) return 0;
+
+		if (symbol < 256)
+		{
+			if (s->out == s->out_end) return 0;
+			*s->out++ = (unsigned char)symbol;
+		}
+
+		else if (symbol > 256)
+		{
+			int len, dist;
+			symbol -= 257;
+			if (symbol >= 29) return 0;
+			len = lbase[symbol] + cute_tiled_inflate_bits(s, lext[symbol]);
+			symbol = cute_tiled_inflate_decode(s, distcode);
+			if (symbol < 0 || symbol >= 30) return 0;
+			dist = dbase[symbol] + cute_tiled_inflate_bits(s, dext[symbol]);
+			if (s->error) return 0;
+			if (dist > s->out - s->out_begin || len > s->out_end - s->out) return 0;
+			while (len--)
+			{
+				*s->out = *(s->out - dist);
+				s->out++;
+			}
+		}
+	}
+	while (symbol != 256);
+
+	return 1;
+}
+
+static int cute_tiled_inflate_stored(cute_tiled_inflate_t* s)
+{
+	int len;
+	s->bitbuf = 0;
+	s->bitcnt = 0;
+	if (s->in_end - s->in < 4) return 0;
+	len = s->in[0] | (s->in[1] << 8);
+	if ((s->in[2] != (~len & 0xFF)) | (s->in[3] != ((~len >> 8) & 0xFF))) return 0;
+	s->in += 4;
+	if (len > s->in_end - s->in || len > s->out_end - s->out) return 0;
+	CUTE_TILED_MEMCPY(s->out, s->in, len);
+	s->in += len;
+	s->out += len;
+	return 1;
+}
+
+static int cute_tiled_inflate_fixed(cute_tiled_inflate_t* s)
+{
+	cute_tiled_huffman_t lencode, distcode;
+	short lengths[288];
+	int symbol;
+	for (symbol = 0; symbol < 144; ++symbol) lengths[symbol] = 8;
+	for (; symbol < 256; ++symbol) lengths[symbol] = 9;
+	for (; symbol < 280; ++symbol) lengths[symbol] = 7;
+	for (; symbol < 288; ++symbol) lengths[symbol] = 8;
+	cute_tiled_inflate_construct(&lencode, lengths, 288);
+	for (symbol = 0; symbol < 30; ++symbol) lengths[symbol] = 5;
+	cute_tiled_inflate_construct(&distcode, lengths, 30);
+	return cute_tiled_inflate_codes(s, &lencode, &distcode);
+}
+
+static int cute_tiled_inflate_dynamic(cute_tiled_inflate_t* s)
+{
+	static const short order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	cute_tiled_huffman_t lencode, distcode;
+	short lengths[320];
+	int nlen, ndist, ncode, index, err;
+
+	nlen = cute_tiled_inflate_bits(s, 5) + 257;
+	ndist = cute_tiled_inflate_bits(s, 5) + 1;
+	ncode = cute_tiled_inflate_bits(s, 4) + 4;
+	if (s->error || nlen > 286 || ndist > 30) return 0;
+
+	for (index = 0; index < ncode; ++index) lengths[order[index]] = (short)cute_tiled_inflate_bits(s, 3);
+	for (; index < 19; ++index) lengths[order[index]] = 0;
+	if (s->error || cute_tiled_inflate_construct(&lencode, lengths, 19) != 0) return 0;
+
+	index = 0;
+	while (index < nlen + ndist)
+	{
+		int symbol = cute_tiled_inflate_decode(s, &lencode);
+		if (symbol < 0) return 0;
+		if (symbol < 16) lengths[index++] = (short)symbol;
+		else
+		{
+			short len = 0;
+			if (symbol == 16)
+			{
+				if (index == 0) return 0;
+				len = lengths[index - 1];
+				symbol = 3 + cute_tiled_inflate_bits(s, 2);
+			}
+			else if (symbol == 17) symbol = 3 + cute_tiled_inflate_bits(s, 3);
+			else symbol = 11 + cute_tiled_inflate_bits(s, 7);
+			if (s->error || index + symbol > nlen + ndist) return 0;
+			while (symbol--) lengths[index++] = len;
+		}
+	}
+
+	if (lengths[256] == 0) return 0;
+	err = cute_tiled_inflate_construct(&lencode, lengths, nlen);
+	if (err && (err < 0 || nlen != lencode.count[0] + lencode.count[1])) return 0;
+	err = cute_tiled_inflate_construct(&distcode, lengths + nlen, ndist);
+	if (err && (err < 0 || ndist != distcode.count[0] + distcode.count[1])) return 0;
+
+	return cute_tiled_inflate_codes(s, &lencode, &distcode);
+}
+
+// Inflates a raw DEFLATE stream, setting `*in_used` to the bytes consumed so callers can find
+// the container trailer. Returns the number of bytes written, or -1 on failure.
+static int cute_tiled_inflate_internal(void* out, int out_size, const void* in, int in_size, int* in_used)
+{
+	cute_tiled_inflate_t s;
+	int last;
+	s.in = (const unsigned char*)in;
+	s.in_end = s.in + in_size;
+	s.bitbuf = 0;
+	s.bitcnt = 0;
+	s.out = s.out_begin = (unsigned char*)out;
+	s.out_end = s.out + out_size;
+	s.error = 0;
+
+	do
+	{
+		int type, ok;
+		last = cute_tiled_inflate_bits(&s, 1);
+		type = cute_tiled_inflate_bits(&s, 2);
+		if (s.error) return -1;
+		switch (type)
+		{
+		case 0: ok = cute_tiled_inflate_stored(&s); break;
+		case 1: ok = cute_tiled_inflate_fixed(&s); break;
+		case 2: ok = cute_tiled_inflate_dynamic(&s); break;
+		default: ok = 0; break;
+		}
+		if (!ok || s.error) return -1;
+	}
+	while (!last);
+
+	// Leftover bits belong to the final partial byte, so the trailer starts at `s.in`.
+	*in_used = (int)(s.in - (const unsigned char*)in);
+	return (int)(s.out - s.out_begin);
+}
+
+// Inflates a raw DEFLATE stream. Returns the number of bytes written, or -1 on failure.
+int cute_tiled_inflate(void* out, int out_size, const void* in, int in_size)
+{
+	int in_used;
+	return cute_tiled_inflate_internal(out, out_size, in, in_size, &in_used);
+}
+
+static uint32_t cute_tiled_adler32(const unsigned char* data, int size)
+{
+	uint32_t a = 1, b = 0;
+	while (size > 0)
+	{
+		// 5552 is the longest run that cannot overflow `b` before the modulo.
+		int run = size < 5552 ? size : 5552;
+		size -= run;
+		while (run--)
+		{
+			a += *data++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
+}
+
+static uint32_t cute_tiled_crc32(const unsigned char* data, int size)
+{
+	// Half-byte table: 64 bytes instead of the usual 1KB, plenty for tile layers.
+	static const uint32_t table[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+	uint32_t crc = 0xFFFFFFFF;
+	while (size--)
+	{
+		crc ^= *data++;
+		crc = (crc >> 4) ^ table[crc & 15];
+		crc = (crc >> 4) ^ table[crc & 15];
+	}
+	return ~crc;
+}
+
+int cute_tiled_zlib_decompress(void* out, int out_size, const void* in, int in_size, void* mem_ctx)
+{
+	const unsigned char* bytes = (const unsigned char*)in;
+	int written, in_used;
+	const unsigned char* trailer;
+	CUTE_TILED_UNUSED(mem_ctx);
+	if (in_size < 2) return -1;
+	if ((bytes[0] & 0x0F) != 8 || ((bytes[0] << 8) | bytes[1]) % 31 != 0 || (bytes[1] & 0x20)) return -1;
+	written = cute_tiled_inflate_internal(out, out_size, bytes + 2, in_size - 2, &in_used);
+	if (written < 0) return -1;
+
+	// Big-endian Adler-32 of the inflated bytes.
+	trailer = bytes + 2 + in_used;
+	if (in_size - 2 - in_used < 4) return -1;
+	if ((((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | trailer[3]) != cute_tiled_adler32((const unsigned char*)out, written)) return -1;
+	return written;
+}
+
+int cute_tiled_gzip_decompress(void* out, int out_size, const void* in, int in_size, void* mem_ctx)
+{
+	const unsigned char* bytes = (const unsigned char*)in;
+	const unsigned char* end = bytes + in_size;
+	const unsigned char* trailer;
+	int flags, written, in_used;
+	CUTE_TILED_UNUSED(mem_ctx);
+	if (in_size < 18 || bytes[0] != 0x1F || bytes[1] != 0x8B || bytes[2] != 8) return -1;
+	flags = bytes[3];
+	bytes += 10;
+	if (flags & 4) bytes += 2 + (bytes[0] | (bytes[1] << 8)); // FEXTRA
+	if (flags & 8) while (bytes < end && *bytes++); // FNAME
+	if (flags & 16) while (bytes < end && *bytes++); // FCOMMENT
+	if (flags & 2) bytes += 2; // FHCRC
+	if (bytes >= end) return -1;
+	written = cute_tiled_inflate_internal(out, out_size, bytes, (int)(end - bytes), &in_used);
+	if (written < 0) return -1;
+
+	// Little-endian CRC-32 and size (mod 2^32) of the inflated bytes.
+	trailer = bytes + in_used;
+	if (end - trailer < 8) return -1;
+	if (((uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24)) != cute_tiled_crc32((const unsigned char*)out, written)) return -1;
+	if (((uint32_t)trailer[4] | ((uint32_t)trailer[5] << 8) | ((uint32_t)trailer[6] << 16) | ((uint32_t)trailer[7] << 24)) != (uint32_t)written) return -1;
+	return written;
+}
+
+#if !defined(CUTE_TILED_ZLIB_DECOMPRESS)
+	#define CUTE_TILED_ZLIB_DECOMPRESS cute_tiled_zlib_decompress
+#endif
+
+#if !defined(CUTE_TILED_GZIP_DECOMPRESS)
+	#define CUTE_TILED_GZIP_DECOMPRESS cute_tiled_gzip_decompress
+#endif
+
+#endif // CUTE_TILED_NO_INFLATE
+
+#define CUTE_TILED_COMPRESSION_NONE 0
+#define CUTE_TILED_COMPRESSION_ZLIB 1
+#define CUTE_TILED_COMPRESSION_GZIP 2
+#define CUTE_TILED_COMPRESSION_ZSTD 3
+
+// Decodes a base64 (and optionally compressed) `data` string straight into `out`, an array of
+// `count` GIDs. Tiled stores GIDs as little-endian unsigned 32-bit integers.
+int cute_tiled_decode_tile_data_internal(cute_tiled_map_internal_t* m, const char* in, int in_len, int compression, int* out, int count)
+{
+	unsigned char* bytes = (unsigned char*)out;
+	int size = count * (int)sizeof(int);
+	int written;
+	int i;
+
+	if (compression == CUTE_TILED_COMPRESSION_NONE)
+	{
+		written = cute_tiled_base64_decode(in, in_len, bytes, size);
+	}
+
+	else
+	{
+		int packed_size = in_len / 4 * 3 + 3;
+		unsigned char* packed = (unsigned char*)CUTE_TILED_ALLOC(packed_size, m->mem_ctx);
+		CUTE_TILED_CHECK(packed, "Unable to allocate memory for compressed tile data.");
+		packed_size = cute_tiled_base64_decode(in, in_len, packed, packed_size);
+		written = -1;
+
+		if (packed_size >= 0) switch (compression)
+		{
+		case CUTE_TILED_COMPRESSION_ZLIB:
+#if defined(CUTE_TILED_ZLIB_DECOMPRESS)
+			written = CUTE_TILED_ZLIB_DECOMPRESS(bytes, size, packed, packed_size, m->mem_ctx);
+#endif
+			break;
+
+		case CUTE_TILED_COMPRESSION_GZIP:
+#if defined(CUTE_TILED_GZIP_DECOMPRESS)
+			written = CUTE_TILED_GZIP_DECOMPRESS(bytes, size, packed, packed_size, m->mem_ctx);
+#endif
+			break;
+
+		case CUTE_TILED_COMPRESSION_ZSTD:
+#if defined(CUTE_TILED_ZSTD_DECOMPRESS)
+			written = CUTE_TILED_ZSTD_DECOMPRESS(bytes, size, packed, packed_size, m->mem_ctx);
+#endif
+			break;
+		}
+
+		CUTE_TILED_FREE(packed, m->mem_ctx);
+	}
+
+	CUTE_TILED_CHECK(written == size, "Unable to decode tile data. Is the compression supported, see CUTE_TILED_ZSTD_DECOMPRESS?");
+
+	// Convert from little-endian in place, reading each GID before it is overwritten.
+	for (i = 0; i < count; ++i)
+	{
+		const unsigned char* b = bytes + i * 4;
+		out[i] = (int)((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+	}
+
+	return 1;
+
+cute_tiled_err:
+	return 0;
+}
+
+// Stores the last string read, either as a pointer into the input when reading in place, or
+// interned in the string pool.
+static void cute_tiled_store_string(cute_tiled_map_internal_t* m, cute_tiled_string_t* out)
 {
 	STRPOOL_EMBEDDED_U64 id;
-	cute_tiled_read_string(m);
+
+	if (m->in_place)
+	{
+		out->ptr = m->string;
+		return;
+	}
 
 	// Store string id inside the memory of the pointer. This is important since
 	// the string pool can relocate strings while parsing the map file at any
@@ -1772,10 +2913,15 @@ int cute_tiled_intern_string_internal(cute_tiled_map_internal_t* m, cute_tiled_s
 	// Later there will be a second pass to patch all these string
 	// pointers by doing: *out = (const char*)strpool_embedded_cstr(&m->strpool, id);
 
-	id = strpool_embedded_inject(&m->strpool, m->scratch, m->scratch_len);
+	id = strpool_embedded_inject(&m->strpool, m->string, m->string_len);
 	// if (sizeof(const char*) < sizeof(STRPOOL_EMBEDDED_U64)) *(int*)0 = 0; // sanity check
 	out->hash_id = id;
+}
 
+int cute_tiled_intern_string_internal(cute_tiled_map_internal_t* m, cute_tiled_string_t* out)
+{
+	cute_tiled_read_string(m);
+	cute_tiled_store_string(m, out);
 	return 1;
 
 cute_tiled_err:
@@ -1850,7 +2996,7 @@ cute_tiled_err:
 int cute_tiled_skip_until_after_internal(cute_tiled_map_internal_t* m, char c)
 {
 	while (*m->in != c) {
-		cute_tiled_error_line += *m->in == '\n';
+		m->error.line += *m->in == '\n';
 		m->in++;
 	}
 	cute_tiled_expect(m, c);
@@ -1998,6 +3144,7 @@ int cute_tiled_read_properties_internal(cute_tiled_map_internal_t* m, cute_tiled
 	return 1;
 
 cute_tiled_err:
+	CUTE_TILED_FREE(props, m->mem_ctx);
 	return 0;
 }
 
@@ -2017,7 +3164,7 @@ cute_tiled_object_t* cute_tiled_read_object(cute_tiled_map_internal_t* m)
 		CUTE_TILED_U64 h;
 		cute_tiled_read_string(m);
 		cute_tiled_expect(m, ':');
-		h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 		switch (h)
 		{
@@ -2064,7 +3211,7 @@ cute_tiled_object_t* cute_tiled_read_object(cute_tiled_map_internal_t* m)
 			break;
 
 		case 7758770083360183834U: // text
-			CUTE_TILED_WARNING("Text field of Tiled objects is not yet supported. Ignoring field.");
+			CUTE_TILED_WARNING_AT(m->path, m->error.line, "Text field of Tiled objects is not yet supported. Ignoring field.");
 			while (cute_tiled_peak(m) != ',' && cute_tiled_peak(m) != '}') cute_tiled_next(m);
 			if (cute_tiled_peak(m) == '}')	continue;
 			break;
@@ -2108,8 +3255,335 @@ cute_tiled_err:
 	return 0;
 }
 
+#define CUTE_TILED_REVERSE_LIST(T, root) \
+	do { \
+		T* n = 0; \
+		while (root) { \
+			T* next = root->next; \
+			root->next = n; \
+			n = root; \
+			root = next; \
+		} \
+		root = n; \
+	} while (0)
+
+typedef struct cute_tiled_pending_data_t cute_tiled_pending_data_t;
+
+// A base64 `data` string waiting to be decoded. Decoding happens once the whole layer is
+// read, as `compression`, `width` and `height` may appear on either side of it.
+struct cute_tiled_pending_data_t
+{
+	const char* encoded;
+	int encoded_len;
+	int* width;
+	int* height;
+	int* data_count;
+	int** data;
+	cute_tiled_pending_data_t* next;
+};
+
+int cute_tiled_read_tile_data_internal(cute_tiled_map_internal_t* m, int* width, int* height, int* data_count, int** data, cute_tiled_pending_data_t** pending)
+{
+	if (cute_tiled_peak(m) == '"')
+	{
+		cute_tiled_pending_data_t* p = (cute_tiled_pending_data_t*)cute_tiled_alloc(m, sizeof(cute_tiled_pending_data_t));
+		CUTE_TILED_CHECK(p, "Unable to allocate memory for tile data.");
+		cute_tiled_expect(m, '"');
+		p->encoded = m->in;
+		cute_tiled_skip_until_after(m, '"');
+		p->encoded_len = (int)(m->in - p->encoded) - 1;
+		p->width = width;
+		p->height = height;
+		p->data_count = data_count;
+		p->data = data;
+		p->next = *pending;
+		*pending = p;
+	}
+	else
+	{
+		cute_tiled_expect(m, '[');
+		cute_tiled_read_csv_integers(m, data_count, data);
+	}
+
+	return 1;
+
+cute_tiled_err:
+	return 0;
+}
+
+#define cute_tiled_read_tile_data(m, width, height, data_count, data, pending) \
+	do { \
+		CUTE_TILED_FAIL_IF(!cute_tiled_read_tile_data_internal(m, width, height, data_count, data, pending)); \
+	} while (0)
+
+int cute_tiled_decode_pending_data_internal(cute_tiled_map_internal_t* m, cute_tiled_pending_data_t* pending, int compression)
+{
+	while (pending)
+	{
+		int count;
+		CUTE_TILED_CHECK(*pending->width > 0 && *pending->height > 0, "Base64 tile data requires the layer `width` and `height`.");
+
+		// The decoders take the output size as an int, so the bytes must fit in one too.
+		CUTE_TILED_CHECK(*pending->width <= 0x7FFFFFFF / (int)sizeof(int) / *pending->height, "Tile layer is too large.");
+		count = *pending->width * *pending->height;
+		*pending->data = (int*)CUTE_TILED_ALLOC(count * sizeof(int), m->mem_ctx);
+		CUTE_TILED_CHECK(*pending->data, "Unable to allocate memory for tile data.");
+		*pending->data_count = count;
+		CUTE_TILED_FAIL_IF(!cute_tiled_decode_tile_data_internal(m, pending->encoded, pending->encoded_len, compression, *pending->data, count));
+		pending = pending->next;
+	}
+
+	return 1;
+
+cute_tiled_err:
+	return 0;
+}
+
+cute_tiled_chunk_t* cute_tiled_read_chunk(cute_tiled_map_internal_t* m, cute_tiled_pending_data_t** pending)
+{
+	cute_tiled_chunk_t* chunk = (cute_tiled_chunk_t*)cute_tiled_alloc(m, sizeof(cute_tiled_chunk_t));
+	CUTE_TILED_MEMSET(chunk, 0, sizeof(cute_tiled_chunk_t));
+	cute_tiled_expect(m, '{');
+
+	while (cute_tiled_peak(m) != '}')
+	{
+		CUTE_TILED_U64 h;
+		cute_tiled_read_string(m);
+		cute_tiled_expect(m, ':');
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
+
+		switch (h)
+		{
+		case 4430454992770877055U: // data
+			cute_tiled_read_tile_data(m, &chunk->width, &chunk->height, &chunk->data_count, &chunk->data, pending);
+			break;
+
+		case 809651598226485190U: // height
+			cute_tiled_read_int(m, &chunk->height);
+			break;
+
+		case 7400839267610537869U: // width
+			cute_tiled_read_int(m, &chunk->width);
+			break;
+
+		case 644252274336276709U: // x
+			cute_tiled_read_int(m, &chunk->x);
+			break;
+
+		case 643295699219922364U: // y
+			cute_tiled_read_int(m, &chunk->y);
+			break;
+
+		default:
+			CUTE_TILED_CHECK(0, "Unknown identifier found.");
+		}
+
+		cute_tiled_try(m, ',');
+	}
+
+	cute_tiled_expect(m, '}');
+	return chunk;
+
+cute_tiled_err:
+	return 0;
+}
+
+// Open addressed hash table from chunk coordinates to chunks, so infinite layers cost
+// memory only for the chunks they contain.
+typedef struct cute_tiled_chunk_table_t
+{
+	int chunk_width;
+	int chunk_height;
+	uint32_t mask;
+	cute_tiled_chunk_t* slots[1];
+} cute_tiled_chunk_table_t;
+
+static CUTE_TILED_INLINE int cute_tiled_floor_div(int a, int b)
+{
+	int q = a / b;
+	return q - ((a % b != 0) & ((a < 0) != (b < 0)));
+}
+
+static CUTE_TILED_INLINE uint32_t cute_tiled_chunk_hash(int x, int y)
+{
+	return ((uint32_t)x * 0x9E3779B1U) ^ ((uint32_t)y * 0x85EBCA77U);
+}
+
+int cute_tiled_build_chunk_table_internal(cute_tiled_map_internal_t* m, cute_tiled_layer_t* layer)
+{
+	cute_tiled_chunk_table_t* table;
+	cute_tiled_chunk_t* chunk;
+	uint32_t capacity = 2;
+	int count = 0;
+
+	for (chunk = layer->chunks; chunk; chunk = chunk->next) ++count;
+	while (capacity < (uint32_t)count * 2) capacity *= 2;
+
+	table = (cute_tiled_chunk_table_t*)CUTE_TILED_ALLOC(sizeof(cute_tiled_chunk_table_t) + sizeof(cute_tiled_chunk_t*) * (capacity - 1), m->mem_ctx);
+	CUTE_TILED_CHECK(table, "Unable to allocate memory for the chunk table.");
+	CUTE_TILED_MEMSET(table->slots, 0, sizeof(cute_tiled_chunk_t*) * capacity);
+	layer->_chunk_table = table;
+	table->chunk_width = layer->chunks->width;
+	table->chunk_height = layer->chunks->height;
+	table->mask = capacity - 1;
+	CUTE_TILED_CHECK(table->chunk_width > 0 && table->chunk_height > 0, "Chunks require a `width` and `height`.");
+
+	for (chunk = layer->chunks; chunk; chunk = chunk->next)
+	{
+		uint32_t index = cute_tiled_chunk_hash(chunk->x, chunk->y) & table->mask;
+		CUTE_TILED_CHECK(chunk->width == table->chunk_width && chunk->height == table->chunk_height, "All chunks of a layer must share the same size.");
+		CUTE_TILED_CHECK(cute_tiled_floor_div(chunk->x, chunk->width) * chunk->width == chunk->x && cute_tiled_floor_div(chunk->y, chunk->height) * chunk->height == chunk->y, "Chunks must be aligned to their size.");
+		CUTE_TILED_CHECK(chunk->data_count == chunk->width * chunk->height, "Chunk data does not match its size.");
+		while (table->slots[index]) index = (index + 1) & table->mask;
+		table->slots[index] = chunk;
+	}
+
+	return 1;
+
+cute_tiled_err:
+	return 0;
+}
+
+cute_tiled_chunk_t* cute_tiled_get_chunk(const cute_tiled_layer_t* layer, int x, int y)
+{
+	const cute_tiled_chunk_table_t* table = (const cute_tiled_chunk_table_t*)layer->_chunk_table;
+	cute_tiled_chunk_t* chunk;
+	uint32_t index;
+	if (!table) return 0;
+
+	x = cute_tiled_floor_div(x, table->chunk_width) * table->chunk_width;
+	y = cute_tiled_floor_div(y, table->chunk_height) * table->chunk_height;
+	index = cute_tiled_chunk_hash(x, y) & table->mask;
+	while ((chunk = table->slots[index]))
+	{
+		if (chunk->x == x && chunk->y == y) return chunk;
+		index = (index + 1) & table->mask;
+	}
+
+	return 0;
+}
+
+// Decodes the string at `m->in` like the string readers do, and moves past it. The input is left
+// untouched, even when parsing in place. Strings that do not fit in the `capacity` bytes at `*out`
+// are decoded into an allocation instead, which `*out` then points to for the caller to free.
+// Returns the length, or -1 on failure.
+static int cute_tiled_peek_string_internal(cute_tiled_map_internal_t* m, char** out, int capacity)
+{
+	char* p;
+	int len = 0;
+	cute_tiled_expect(m, '"');
+
+	// Escapes only ever shorten the string, so its raw length is enough room.
+	p = m->in;
+	while (p < m->end && *p != '"') p += *p == '\\' ? 2 : 1;
+	CUTE_TILED_CHECK(p < m->end, "Attempted to read passed input buffer (is this a valid JSON file?).");
+	if (p - m->in >= capacity)
+	{
+		*out = (char*)CUTE_TILED_ALLOC((size_t)(p - m->in) + 1, m->mem_ctx);
+		CUTE_TILED_CHECK(*out, "Unable to allocate memory for a layer name.");
+	}
+
+	while (*m->in != '"')
+	{
+		char c = *m->in++;
+		if (c == '\\') len += cute_tiled_parse_escape(&m->in, m->end, *out + len);
+		else (*out)[len++] = c;
+	}
+	m->in++;
+	(*out)[len] = 0;
+	return len;
+
+cute_tiled_err:
+	return -1;
+}
+
+// Looks ahead through the layer at `m->in` for its name and type, and skips over the layer if the
+// layer filter rejects it. Otherwise `m->in` is left at the start of the layer, to be parsed.
+static int cute_tiled_filter_layer_internal(cute_tiled_map_internal_t* m, int* skipped)
+{
+	char name_buffer[CUTE_TILED_INTERNAL_BUFFER_MAX];
+	char type_buffer[32];
+	char key_buffer[32];
+	char* name = name_buffer;
+	char* type = type_buffer;
+	char* start;
+	int line;
+	int found = 0;
+	int accepted;
+	*skipped = 0;
+	if (!m->layer_filter) return 1;
+
+	start = m->in;
+	line = m->error.line;
+	name[0] = 0;
+	type[0] = 0;
+	cute_tiled_expect(m, '{');
+
+	// Both keys are usually near the start of the layer, well before its data.
+	while (found != 3 && cute_tiled_peak(m) != '}')
+	{
+		char* key = key_buffer;
+		CUTE_TILED_U64 h;
+		int is_name, is_type;
+		char c;
+		int len = cute_tiled_peek_string_internal(m, &key, sizeof(key_buffer));
+		CUTE_TILED_FAIL_IF(len < 0);
+		h = cute_tiled_FNV1a(key, len + 1);
+		if (key != key_buffer) CUTE_TILED_FREE(key, m->mem_ctx);
+		is_name = !(found & 1) && h == 12661511911333414066U; // name
+		is_type = !(found & 2) && h == 13509284784451838071U; // type
+		cute_tiled_expect(m, ':');
+		c = cute_tiled_peak(m);
+
+		if (c == '"')
+		{
+			if (is_name) len = cute_tiled_peek_string_internal(m, &name, sizeof(name_buffer));
+			else if (is_type) len = cute_tiled_peek_string_internal(m, &type, sizeof(type_buffer));
+			else
+			{
+				char* value = key_buffer;
+				len = cute_tiled_peek_string_internal(m, &value, sizeof(key_buffer));
+				if (value != key_buffer) CUTE_TILED_FREE(value, m->mem_ctx);
+			}
+			CUTE_TILED_FAIL_IF(len < 0);
+			found |= is_name | (is_type << 1);
+		}
+		else if (c == '{') cute_tiled_skip_object(m);
+		else if (c == '[') cute_tiled_skip_array(m);
+		else
+		{
+			// Numbers, booleans and null.
+			while (m->in < m->end && *m->in != ',' && *m->in != '}' && !cute_tiled_isspace(*m->in)) m->in++;
+		}
+
+		cute_tiled_try(m, ',');
+	}
+
+	// The layer is parsed or skipped from its start either way.
+	m->in = start;
+	m->error.line = line;
+	accepted = m->layer_filter(name, type, m->layer_filter_udata);
+	if (name != name_buffer) CUTE_TILED_FREE(name, m->mem_ctx);
+	if (type != type_buffer) CUTE_TILED_FREE(type, m->mem_ctx);
+	if (!accepted)
+	{
+		cute_tiled_skip_object(m);
+		*skipped = 1;
+	}
+	return 1;
+
+cute_tiled_err:
+	if (name != name_buffer) CUTE_TILED_FREE(name, m->mem_ctx);
+	if (type != type_buffer) CUTE_TILED_FREE(type, m->mem_ctx);
+	return 0;
+}
+
+static void cute_tiled_free_layers(cute_tiled_layer_t* layers, void* mem_ctx);
+
 cute_tiled_layer_t* cute_tiled_layers(cute_tiled_map_internal_t* m)
 {
+	cute_tiled_pending_data_t* pending = 0;
+	int compression = CUTE_TILED_COMPRESSION_NONE;
 	cute_tiled_layer_t* layer = (cute_tiled_layer_t*)cute_tiled_alloc(m, sizeof(cute_tiled_layer_t));
 	CUTE_TILED_MEMSET(layer, 0, sizeof(cute_tiled_layer_t));
 	layer->parallaxx = 1.0f;
@@ -2124,7 +3598,7 @@ cute_tiled_layer_t* cute_tiled_layers(cute_tiled_map_internal_t* m)
 		CUTE_TILED_U64 h;
 		cute_tiled_read_string(m);
 		cute_tiled_expect(m, ':');
-		h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 		switch (h)
 		{
@@ -2133,17 +3607,47 @@ cute_tiled_layer_t* cute_tiled_layers(cute_tiled_map_internal_t* m)
 			break;
 
 		case 14868627273436340303U: // compression
-			CUTE_TILED_CHECK(0, "Compression is not yet supported. The expected tile format is CSV (uncompressed). Please see the docs if you are interested in compression.");
+			cute_tiled_read_string(m);
+			switch (cute_tiled_FNV1a(m->string, m->string_len + 1))
+			{
+			case 12638153115695167455U: compression = CUTE_TILED_COMPRESSION_NONE; break; // ""
+			case 10889674168827858156U: compression = CUTE_TILED_COMPRESSION_ZLIB; break; // zlib
+			case 5536446126065152879U: compression = CUTE_TILED_COMPRESSION_GZIP; break; // gzip
+			case 13700412844294834782U: compression = CUTE_TILED_COMPRESSION_ZSTD; break; // zstd
+			default: CUTE_TILED_CHECK(0, "Unknown tile layer compression. Expected `zlib`, `gzip` or `zstd`.");
+			}
+			cute_tiled_store_string(m, &layer->compression);
 			break;
 
 		case 4430454992770877055U: // data
-			CUTE_TILED_CHECK(cute_tiled_peak(m) == '[', "The expected tile format is CSV (uncompressed). It looks like Base64 (uncompressed) was selected. Please see the docs if you are interested in compression.");
+			cute_tiled_read_tile_data(m, &layer->width, &layer->height, &layer->data_count, &layer->data, &pending);
+			break;
+
+		case 16604818415630589433U: // chunks
 			cute_tiled_expect(m, '[');
-			cute_tiled_read_csv_integers(m, &layer->data_count, &layer->data);
+
+			while (cute_tiled_peak(m) != ']')
+			{
+				cute_tiled_chunk_t* chunk = cute_tiled_read_chunk(m, &pending);
+				CUTE_TILED_FAIL_IF(!chunk);
+				chunk->next = layer->chunks;
+				layer->chunks = chunk;
+				cute_tiled_try(m, ',');
+			}
+
+			cute_tiled_expect(m, ']');
+			break;
+
+		case 14335666674294018687U: // startx
+			cute_tiled_read_int(m, &layer->startx);
+			break;
+
+		case 14334710099177664342U: // starty
+			cute_tiled_read_int(m, &layer->starty);
 			break;
 
 		case 1888774307506158416U: // encoding
-			CUTE_TILED_CHECK(0, "Encoding is not yet supported. The expected tile format is CSV (uncompressed). Please see the docs if you are interested in compression.");
+			cute_tiled_intern_string(m, &layer->encoding);
 			break;
 
 		case 2841939415665718447U: // draworder
@@ -2163,10 +3667,15 @@ cute_tiled_layer_t* cute_tiled_layers(cute_tiled_map_internal_t* m)
 
 		while (cute_tiled_peak(m) != ']')
 		{
-			cute_tiled_layer_t* child_layer = cute_tiled_layers(m);
-			CUTE_TILED_FAIL_IF(!child_layer);
-			child_layer->next = layer->layers;
-			layer->layers = child_layer;
+			int skipped;
+			CUTE_TILED_FAIL_IF(!cute_tiled_filter_layer_internal(m, &skipped));
+			if (!skipped)
+			{
+				cute_tiled_layer_t* child_layer = cute_tiled_layers(m);
+				CUTE_TILED_FAIL_IF(!child_layer);
+				child_layer->next = layer->layers;
+				layer->layers = child_layer;
+			}
 			cute_tiled_try(m, ',');
 		}
 
@@ -2282,9 +3791,20 @@ cute_tiled_layer_t* cute_tiled_layers(cute_tiled_map_internal_t* m)
 	}
 
 	cute_tiled_expect(m, '}');
+	CUTE_TILED_FAIL_IF(!cute_tiled_decode_pending_data_internal(m, pending, compression));
+
+	if (layer->chunks)
+	{
+		CUTE_TILED_REVERSE_LIST(cute_tiled_chunk_t, layer->chunks);
+		CUTE_TILED_FAIL_IF(!cute_tiled_build_chunk_table_internal(m, layer));
+	}
+
 	return layer;
 
 cute_tiled_err:
+	// The layer never reaches the map, so release what it already allocated, such as tile data
+	// whose checksum failed.
+	cute_tiled_free_layers(layer, m->mem_ctx);
 	return 0;
 }
 
@@ -2351,7 +3871,7 @@ cute_tiled_tile_descriptor_t* cute_tiled_read_tile_descriptor(cute_tiled_map_int
 		CUTE_TILED_U64 h;
 		cute_tiled_read_string(m);
 		cute_tiled_expect(m, ':');
-		h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 		switch (h)
 		{
@@ -2424,7 +3944,7 @@ int cute_tiled_read_point_internal(cute_tiled_map_internal_t* m, int* point_x, i
 		CUTE_TILED_U64 h;
 		cute_tiled_read_string(m);
 		cute_tiled_expect(m, ':');
-		h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 		switch (h)
 		{
@@ -2473,6 +3993,8 @@ cute_tiled_err:
 	return 1;
 }
 
+static void cute_tiled_free_tileset(cute_tiled_tileset_t* tileset, void* mem_ctx);
+
 cute_tiled_tileset_t* cute_tiled_tileset(cute_tiled_map_internal_t* m)
 {
 	cute_tiled_tileset_t* tileset = (cute_tiled_tileset_t*)cute_tiled_alloc(m, sizeof(cute_tiled_tileset_t));
@@ -2484,7 +4006,7 @@ cute_tiled_tileset_t* cute_tiled_tileset(cute_tiled_map_internal_t* m)
 		CUTE_TILED_U64 h;
 		cute_tiled_read_string(m);
 		cute_tiled_expect(m, ':');
-		h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+		h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 		switch (h)
 		{
@@ -2567,12 +4089,12 @@ cute_tiled_tileset_t* cute_tiled_tileset(cute_tiled_map_internal_t* m)
 			break;
 
 		case 7277156227374254384U: // tileproperties
-			CUTE_TILED_WARNING("`tileproperties` is deprecated. Attempting to skip.");
+			CUTE_TILED_WARNING_AT(m->path, m->error.line, "`tileproperties` is deprecated. Attempting to skip.");
 			CUTE_TILED_FAIL_IF(cute_tiled_skip_curly_braces_internal(m));
 			break;
 
 		case 15569462518706435895U: // tilepropertytypes
-			CUTE_TILED_WARNING("`tilepropertytypes` is deprecated. Attempting to skip.");
+			CUTE_TILED_WARNING_AT(m->path, m->error.line, "`tilepropertytypes` is deprecated. Attempting to skip.");
 			CUTE_TILED_FAIL_IF(cute_tiled_skip_curly_braces_internal(m));
 			break;
 
@@ -2593,7 +4115,7 @@ cute_tiled_tileset_t* cute_tiled_tileset(cute_tiled_map_internal_t* m)
 		case 8053780534892277672U: // source
 			cute_tiled_intern_string(m, &tileset->source);
 #ifndef CUTE_TILED_NO_EXTERNAL_TILESET_WARNING
-			CUTE_TILED_WARNING("You might have forgotten to embed your tileset -- Most fields of `cute_tiled_tileset_t` will be zero'd out (unset).");
+			CUTE_TILED_WARNING_AT(m->path, m->error.line, "You might have forgotten to embed your tileset -- Most fields of `cute_tiled_tileset_t` will be zero'd out (unset).");
 #endif /* CUTE_TILED_NO_EXTERNAL_TILESET_WARNING */
 			break;
 
@@ -2634,6 +4156,8 @@ cute_tiled_tileset_t* cute_tiled_tileset(cute_tiled_map_internal_t* m)
 	return tileset;
 
 cute_tiled_err:
+	// The tileset lives on the parse pages, but not the properties and tiles read so far.
+	cute_tiled_free_tileset(tileset, m->mem_ctx);
 	return 0;
 }
 
@@ -2642,7 +4166,7 @@ static int cute_tiled_dispatch_map_internal(cute_tiled_map_internal_t* m)
 	CUTE_TILED_U64 h;
 	cute_tiled_read_string(m);
 	cute_tiled_expect(m, ':');
-	h = cute_tiled_FNV1a(m->scratch, m->scratch_len + 1);
+	h = cute_tiled_FNV1a(m->string, m->string_len + 1);
 
 	switch (h)
 	{
@@ -2656,11 +4180,10 @@ static int cute_tiled_dispatch_map_internal(cute_tiled_map_internal_t* m)
 		cute_tiled_intern_string(m, &m->map.class_);
 		break;
 
-	case 5549108793316760247U: // compressionlevel
+	case 5549108793316760247U: // compressionlevel: only used by the editor when exporting
 	{
 		int compressionlevel;
 		cute_tiled_read_int(m, &compressionlevel);
-		CUTE_TILED_CHECK(compressionlevel == -1 || compressionlevel == 0, "Compression is not yet supported.");
 	}	break;
 
 	case 13648382824248632287U: // editorsettings
@@ -2680,10 +4203,15 @@ static int cute_tiled_dispatch_map_internal(cute_tiled_map_internal_t* m)
 
 		while (cute_tiled_peak(m) != ']')
 		{
-			cute_tiled_layer_t* layer = cute_tiled_layers(m);
-			CUTE_TILED_FAIL_IF(!layer);
-			layer->next = m->map.layers;
-			m->map.layers = layer;
+			int skipped;
+			CUTE_TILED_FAIL_IF(!cute_tiled_filter_layer_internal(m, &skipped));
+			if (!skipped)
+			{
+				cute_tiled_layer_t* layer = cute_tiled_layers(m);
+				CUTE_TILED_FAIL_IF(!layer);
+				layer->next = m->map.layers;
+				m->map.layers = layer;
+			}
 			cute_tiled_try(m, ',');
 		}
 
@@ -2791,7 +4319,9 @@ static void cute_tiled_deintern_layer(cute_tiled_map_internal_t* m, cute_tiled_l
 	{
 		cute_tiled_object_t* object;
 		cute_tiled_deintern_string(m, &layer->class_);
+		cute_tiled_deintern_string(m, &layer->compression);
 		cute_tiled_deintern_string(m, &layer->draworder);
+		cute_tiled_deintern_string(m, &layer->encoding);
 		cute_tiled_deintern_string(m, &layer->name);
 		cute_tiled_deintern_string(m, &layer->type);
 		cute_tiled_deintern_string(m, &layer->image);
@@ -2829,6 +4359,7 @@ static void cute_tiled_patch_tileset_strings(cute_tiled_map_internal_t* m, cute_
 		cute_tiled_deintern_string(m, &tile_descriptor->image);
 		cute_tiled_deintern_string(m, &tile_descriptor->type);
 		cute_tiled_deintern_properties(m, tile_descriptor->properties, tile_descriptor->property_count);
+		cute_tiled_deintern_layer(m, tile_descriptor->objectgroup);
 		tile_descriptor = tile_descriptor->next;
 	}
 }
@@ -2837,6 +4368,7 @@ static void cute_tiled_patch_interned_strings(cute_tiled_map_internal_t* m)
 {
 	cute_tiled_tileset_t* tileset;
 	cute_tiled_layer_t* layer;
+	if (m->in_place) return;
 	cute_tiled_deintern_string(m, &m->map.class_);
 	cute_tiled_deintern_string(m, &m->map.orientation);
 	cute_tiled_deintern_string(m, &m->map.renderorder);
@@ -2873,19 +4405,41 @@ static void cute_tiled_free_layers(cute_tiled_layer_t* layers, void* mem_ctx)
 	CUTE_TILED_UNUSED(mem_ctx);
 	while (layer)
 	{
+		cute_tiled_chunk_t* chunk = layer->chunks;
 		if (layer->data) CUTE_TILED_FREE(layer->data, mem_ctx);
 		if (layer->properties) CUTE_TILED_FREE(layer->properties, mem_ctx);
+		if (layer->_chunk_table) CUTE_TILED_FREE(layer->_chunk_table, mem_ctx);
+		while (chunk)
+		{
+			if (chunk->data) CUTE_TILED_FREE(chunk->data, mem_ctx);
+			chunk = chunk->next;
+		}
 		cute_tiled_free_layers(layer->layers, mem_ctx);
 		cute_tiled_free_objects(layer->objects, mem_ctx);
 		layer = layer->next;
 	}
 }
 
+static void cute_tiled_free_tileset(cute_tiled_tileset_t* tileset, void* mem_ctx)
+{
+	cute_tiled_tile_descriptor_t* desc;
+	CUTE_TILED_UNUSED(mem_ctx);
+	if (tileset->properties) CUTE_TILED_FREE(tileset->properties, mem_ctx);
+	desc = tileset->tiles;
+	while (desc)
+	{
+		if (desc->properties) CUTE_TILED_FREE(desc->properties, mem_ctx);
+		if (desc->animation) CUTE_TILED_FREE(desc->animation, mem_ctx);
+		cute_tiled_free_layers(desc->objectgroup, mem_ctx);
+		desc = desc->next;
+	}
+}
+
 static void cute_tiled_free_map_internal(cute_tiled_map_internal_t* m)
 {
 	cute_tiled_tileset_t* tileset;
 	cute_tiled_page_t* page;
-	strpool_embedded_term(&m->strpool);
+	if (!m->in_place) strpool_embedded_term(&m->strpool);
 
 	cute_tiled_free_layers(m->map.layers, m->mem_ctx);
 	if (m->map.properties) CUTE_TILED_FREE(m->map.properties, m->mem_ctx);
@@ -2893,16 +4447,7 @@ static void cute_tiled_free_map_internal(cute_tiled_map_internal_t* m)
 	tileset = m->map.tilesets;
 	while (tileset)
 	{
-		cute_tiled_tile_descriptor_t* desc;
-		if (tileset->properties) CUTE_TILED_FREE(tileset->properties, m->mem_ctx);
-		desc = tileset->tiles;
-		while (desc)
-		{
-			if (desc->properties) CUTE_TILED_FREE(desc->properties, m->mem_ctx);
-			if (desc->animation) CUTE_TILED_FREE(desc->animation, mem_ctx);
-			cute_tiled_free_layers(desc->objectgroup, m->mem_ctx);
-			desc = desc->next;
-		}
+		cute_tiled_free_tileset(tileset, m->mem_ctx);
 		tileset = tileset->next;
 	}
 
@@ -2918,27 +4463,23 @@ static void cute_tiled_free_map_internal(cute_tiled_map_internal_t* m)
 		page = next;
 	}
 
+	page = m->large_blocks;
+	while (page)
+	{
+		cute_tiled_page_t* next = page->next;
+		CUTE_TILED_FREE(page, m->mem_ctx);
+		page = next;
+	}
+
 	CUTE_TILED_FREE(m, m->mem_ctx);
 }
 
-#define CUTE_TILED_REVERSE_LIST(T, root) \
-	do { \
-		T* n = 0; \
-		while (root) { \
-			T* next = root->next; \
-			root->next = n; \
-			n = root; \
-			root = next; \
-		} \
-		root = n; \
-	} while (0)
-
 void cute_tiled_reverse_layers(cute_tiled_map_t* map)
 {
 	CUTE_TILED_REVERSE_LIST(cute_tiled_layer_t, map->layers);
 }
 
-static cute_tiled_map_internal_t* cute_tiled_map_internal_alloc_internal(void* memory, int size_in_bytes, void* mem_ctx)
+static cute_tiled_map_internal_t* cute_tiled_map_internal_alloc_internal(void* memory, int size_in_bytes, void* mem_ctx, int in_place)
 {
 	strpool_embedded_config_t config;
 	cute_tiled_map_internal_t* m = (cute_tiled_map_internal_t*)CUTE_TILED_ALLOC(sizeof(cute_tiled_map_internal_t), mem_ctx);
@@ -2946,23 +4487,44 @@ static cute_tiled_map_internal_t* cute_tiled_map_internal_alloc_internal(void* m
 	m->in = (char*)memory;
 	m->end = m->in + size_in_bytes;
 	m->mem_ctx = mem_ctx;
-	m->page_size = 1024 * 10;
+	m->page_size = CUTE_TILED_PAGE_SIZE;
 	m->bytes_left_on_page = m->page_size;
-	m->pages = (cute_tiled_page_t*)CUTE_TILED_ALLOC(sizeof(cute_tiled_page_t) + m->page_size, mem_ctx);
-	m->pages->next = 0;
-	m->pages->data = m->pages + 1;
+	if (!cute_tiled_alloc_page(&m->pages, m->page_size, mem_ctx)) m->bytes_left_on_page = 0;
+	m->in_place = in_place;
+	m->error.line = 1;
+	if (in_place) return m;
+
 	config = strpool_embedded_default_config;
 	config.memctx = mem_ctx;
+
+	// Size the string pool from the input, rather than starting every small file with the full default block.
+	if (config.block_size > size_in_bytes) config.block_size = size_in_bytes;
+	if (config.entry_capacity > size_in_bytes / 32) config.entry_capacity = size_in_bytes / 32 > 64 ? size_in_bytes / 32 : 64;
 	strpool_embedded_init(&m->strpool, &config);
 	return m;
 }
 
-cute_tiled_map_t* cute_tiled_load_map_from_memory(const void* memory, int size_in_bytes, void* mem_ctx)
+/*!
+ * Hands the error of a failed load to the caller, and to the globals of the thread it failed on.
+ */
+static void cute_tiled_report_error(cute_tiled_map_internal_t* m, cute_tiled_error_t* error)
+{
+	if (error)
+	{
+		*error = m->error;
+		if (m->error.reason == m->error.buffer) error->reason = error->buffer;
+	}
+
+	// The globals outlive the map, and with it the message buffer.
+	cute_tiled_error_reason = m->error.reason == m->error.buffer ? "Found unexpected token (is this a valid JSON file?)." : m->error.reason;
+	cute_tiled_error_line = m->error.line;
+}
+
+static cute_tiled_map_t* cute_tiled_load_map_internal(void* memory, int size_in_bytes, void* mem_ctx, const cute_tiled_load_options_t* options, const char* path)
 {
 	cute_tiled_map_internal_t* m;
 	cute_tiled_layer_t* layer;
 	cute_tiled_tileset_t* tileset;
-	cute_tiled_error_line = 1;
 
 	if (!memory) {
 		// Make sure your map file was correctly found and loaded.
@@ -2971,7 +4533,14 @@ cute_tiled_map_t* cute_tiled_load_map_from_memory(const void* memory, int size_i
 		CUTE_TILED_CRASH();
 	}
 
-	m = cute_tiled_map_internal_alloc_internal((void*)memory, size_in_bytes, mem_ctx);
+	m = cute_tiled_map_internal_alloc_internal(memory, size_in_bytes, mem_ctx, options ? options->in_place : 0);
+	m->path = path;
+	if (options)
+	{
+		m->layer_filter = options->layer_filter;
+		m->layer_filter_udata = options->layer_filter_udata;
+		if (options->error) options->error->reason = 0;
+	}
 	layer = m->map.layers;
 	tileset = m->map.tilesets;
 	cute_tiled_expect(m, '{');
@@ -3000,47 +4569,140 @@ cute_tiled_map_t* cute_tiled_load_map_from_memory(const void* memory, int size_i
 	return &m->map;
 
 cute_tiled_err:
+	if (!m->error.reason) m->error.reason = "Failed to parse map (is this a valid JSON file?).";
+	if (!options || !options->error) CUTE_TILED_WARNING_AT(path, m->error.line, m->error.reason);
+	cute_tiled_report_error(m, options ? options->error : 0);
 	cute_tiled_free_map_internal(m);
-	CUTE_TILED_WARNING(cute_tiled_error_reason);
 	return 0;
 }
 
+cute_tiled_map_t* cute_tiled_load_map_from_memory(const void* memory, int size_in_bytes, void* mem_ctx)
+{
+	return cute_tiled_load_map_internal((void*)memory, size_in_bytes, mem_ctx, 0, 0);
+}
+
+cute_tiled_map_t* cute_tiled_load_map_from_memory_in_place(void* memory, int size_in_bytes, void* mem_ctx)
+{
+	cute_tiled_load_options_t options;
+	CUTE_TILED_MEMSET(&options, 0, sizeof(options));
+	options.in_place = 1;
+	return cute_tiled_load_map_internal(memory, size_in_bytes, mem_ctx, &options, 0);
+}
+
+cute_tiled_map_t* cute_tiled_load_map_from_memory_ex(void* memory, int size_in_bytes, const cute_tiled_load_options_t* options, void* mem_ctx)
+{
+	return cute_tiled_load_map_internal(memory, size_in_bytes, mem_ctx, options, 0);
+}
+
 void cute_tiled_free_map(cute_tiled_map_t* map)
 {
 	cute_tiled_map_internal_t* m = (cute_tiled_map_internal_t*)(((char*)map) - (size_t)(&((cute_tiled_map_internal_t*)0)->map));
 	cute_tiled_free_map_internal(m);
 }
 
+void cute_tiled_get_memory_stats(const cute_tiled_map_t* map, cute_tiled_memory_stats_t* stats)
+{
+	const cute_tiled_map_internal_t* m = (const cute_tiled_map_internal_t*)(((const char*)map) - (size_t)(&((cute_tiled_map_internal_t*)0)->map));
+	cute_tiled_page_t* page;
+	CUTE_TILED_MEMSET(stats, 0, sizeof(cute_tiled_memory_stats_t));
+
+	for (page = m->pages; page; page = page->next)
+	{
+		stats->page_count++;
+		stats->page_bytes += page->size;
+	}
+
+	for (page = m->large_blocks; page; page = page->next)
+	{
+		stats->large_block_count++;
+		stats->large_block_bytes += page->size;
+	}
+
+	stats->bytes_wasted = m->bytes_wasted + m->bytes_left_on_page;
+}
+
+int cute_tiled_map_owns(const cute_tiled_map_t* map, const void* ptr)
+{
+	const cute_tiled_map_internal_t* m = (const cute_tiled_map_internal_t*)(((const char*)map) - (size_t)(&((cute_tiled_map_internal_t*)0)->map));
+	const char* p = (const char*)ptr;
+	cute_tiled_page_t* page;
+
+	for (page = m->pages; page; page = page->next)
+	{
+		if (p >= (const char*)page->data && p < (const char*)page->data + page->size) return 1;
+	}
+
+	for (page = m->large_blocks; page; page = page->next)
+	{
+		if (p >= (const char*)page->data && p < (const char*)page->data + page->size) return 1;
+	}
+
+	return 0;
+}
+
 cute_tiled_tileset_t* cute_tiled_load_external_tileset(const char* path, void* mem_ctx)
 {
 	int size;
 	void* file;
 	cute_tiled_tileset_t* tileset;
-	cute_tiled_error_file = path;
 
 	file = cute_tiled_read_file_to_memory_and_null_terminate(path, &size, mem_ctx);
-	if (!file) CUTE_TILED_WARNING("Unable to find external tileset file.");
+	if (!file) CUTE_TILED_WARNING_AT(path, 0, "Unable to find external tileset file.");
 	tileset = cute_tiled_load_external_tileset_from_memory(file, size, mem_ctx);
 	CUTE_TILED_FREE(file, mem_ctx);
 
-	cute_tiled_error_file = NULL;
-
 	return tileset;
 }
 
-cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory(const void* memory, int size_in_bytes, void* mem_ctx)
+static cute_tiled_tileset_t* cute_tiled_load_external_tileset_internal(void* memory, int size_in_bytes, void* mem_ctx, const cute_tiled_load_options_t* options)
 {
-	cute_tiled_map_internal_t* m = cute_tiled_map_internal_alloc_internal((void*)memory, size_in_bytes, mem_ctx);
-	cute_tiled_tileset_t* tileset = cute_tiled_tileset(m);
-	cute_tiled_patch_tileset_strings(m, tileset);
+	cute_tiled_map_internal_t* m;
+	cute_tiled_tileset_t* tileset;
+
+	if (!memory) {
+		// Make sure your tileset file was correctly found and loaded.
+		CUTE_TILED_CRASH();
+	}
+
+	m = cute_tiled_map_internal_alloc_internal(memory, size_in_bytes, mem_ctx, options ? options->in_place : 0);
+	if (options && options->error) options->error->reason = 0;
+	tileset = cute_tiled_tileset(m);
+	if (!tileset) goto cute_tiled_err;
+	if (!m->in_place) cute_tiled_patch_tileset_strings(m, tileset);
 	CUTE_TILED_REVERSE_LIST(cute_tiled_tile_descriptor_t, tileset->tiles);
 	tileset->_internal = m;
 	return tileset;
+
+cute_tiled_err:
+	if (!m->error.reason) m->error.reason = "Failed to parse external tileset (is this a valid JSON file?).";
+	if (!options || !options->error) CUTE_TILED_WARNING_AT(m->path, m->error.line, m->error.reason);
+	cute_tiled_report_error(m, options ? options->error : 0);
+	cute_tiled_free_map_internal(m);
+	return 0;
+}
+
+cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory(const void* memory, int size_in_bytes, void* mem_ctx)
+{
+	return cute_tiled_load_external_tileset_internal((void*)memory, size_in_bytes, mem_ctx, 0);
+}
+
+cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory_in_place(void* memory, int size_in_bytes, void* mem_ctx)
+{
+	cute_tiled_load_options_t options;
+	CUTE_TILED_MEMSET(&options, 0, sizeof(options));
+	options.in_place = 1;
+	return cute_tiled_load_external_tileset_internal(memory, size_in_bytes, mem_ctx, &options);
+}
+
+cute_tiled_tileset_t* cute_tiled_load_external_tileset_from_memory_ex(void* memory, int size_in_bytes, const cute_tiled_load_options_t* options, void* mem_ctx)
+{
+	return cute_tiled_load_external_tileset_internal(memory, size_in_bytes, mem_ctx, options);
 }
 
 void cute_tiled_free_external_tileset(cute_tiled_tileset_t* tileset)
 {
 	cute_tiled_map_internal_t* m = (cute_tiled_map_internal_t*)tileset->_internal;
+	cute_tiled_free_tileset(tileset, m->mem_ctx);
 	cute_tiled_free_map_internal(m);
 }
 
@@ -10,7 +10,7 @@
 *
 *   DEVELOPER NOTES:
 *       There are a few cute_tiled_map_t properties that are used for pntr_tiled use:
-*       - tiledversion: Used for an array of pntr_image* subimages representing each tile source in the map.
+*       - tiledversion: Used for a pntr_tiled_map_data, holding the pntr_image* subimages for each tile source in the map.
 *       - nextlayerid: Used to track the current animation time in milliseconds.
 *
 *   LICENSE: zlib/libpng
@@ -60,10 +60,448 @@ extern "C" {
  * @return The loaded map data, or NULL on failure.
  */
 PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled(const char* fileName);
+
+/**
+ * Load a Tiled map by memory-mapping the file, rather than reading it into a heap buffer.
+ *
+ * The map is parsed directly from the mapping, and any external tilesets are mapped the same way.
+ * Falls back to reading the file normally on platforms without mmap, or with PNTR_TILED_NO_MMAP.
+ *
+ * @param fileName The name of the file to load.
+ * @return The loaded map data, or NULL on failure.
+ */
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_mapped(const char* fileName);
+
+/**
+ * A cache of images and external tilesets, that maps can share when loaded with pntr_load_tiled_ex().
+ *
+ * Entries are found by their resolved path, and are reference counted, so that each one is freed once the last map
+ * using it is unloaded. pntr_tiled_reload() only takes entries whose file has not changed since they were loaded.
+ *
+ * Maps on different threads can only share a cache when PNTR_TILED_THREADS is defined, which locks it.
+ *
+ * @see pntr_load_tiled_cache()
+ */
+typedef struct pntr_tiled_cache pntr_tiled_cache;
+
+/**
+ * Allocation callbacks for pntr_load_tiled_ex(), used for the parsed map and its tile table.
+ */
+typedef struct pntr_tiled_allocator {
+    /**
+     * Allocates the given number of bytes, or returns NULL on failure.
+     */
+    void* (*alloc)(size_t size, void* userData);
+
+    /**
+     * Frees memory from alloc.
+     */
+    void (*free)(void* ptr, void* userData);
+
+    /**
+     * Passed along to alloc and free.
+     */
+    void* userData;
+} pntr_tiled_allocator;
+
+/**
+ * Why a map failed to load, filled in through the error of pntr_tiled_load_options.
+ */
+typedef struct pntr_tiled_error {
+    /**
+     * The first problem the load ran into, along with the file it is about, or NULL if there was none.
+     *
+     * Images and external tilesets that fail to load are reported too, though the map still loads without them.
+     */
+    const char* reason;
+
+    /**
+     * The line of the JSON where parsing failed, or 0 when the problem was not with the JSON.
+     */
+    int line;
+
+    /**
+     * Holds the reason.
+     */
+    char message[256];
+} pntr_tiled_error;
+
+/**
+ * Where maps, external tilesets and images are read from, such as pntr_tiled_io_files() or pntr_tiled_io_pack().
+ *
+ * When a map loads with several threads, these may be called from all of them at once.
+ */
+typedef struct pntr_tiled_io {
+    /**
+     * Opens the given file, returning a handle to it, or NULL when it cannot be opened.
+     */
+    void* (*open)(const char* fileName, void* userData);
+
+    /**
+     * The size of the opened file, in bytes.
+     */
+    unsigned int (*size)(void* file, void* userData);
+
+    /**
+     * Lends out the contents of the opened file until it is closed, or returns NULL to have the file read instead. Can
+     * be NULL.
+     *
+     * When writable is true, the map or tileset is parsed in place, which writes to the view, so it must be private to
+     * the handle. The parser may peek one byte past the end of the view.
+     */
+    unsigned char* (*map)(void* file, bool writable, void* userData);
+
+    /**
+     * Reads the whole opened file into the given buffer, returning false on failure. Can be NULL when map always
+     * succeeds.
+     */
+    bool (*read)(void* file, unsigned char* buffer, unsigned int size, void* userData);
+
+    /**
+     * Closes the file, along with any view of it.
+     */
+    void (*close)(void* file, void* userData);
+
+    /**
+     * Passed along to each function. Must outlive the maps loaded through it.
+     */
+    void* userData;
+} pntr_tiled_io;
+
+/**
+ * A file within a pntr_tiled_pack.
+ */
+typedef struct pntr_tiled_pack_file {
+    /**
+     * The full path the file is found by, such as "resources/desert.tmj".
+     */
+    const char* fileName;
+
+    /**
+     * The contents of the file. The byte after it must be readable, such as the null terminator of a string.
+     */
+    const unsigned char* data;
+
+    /**
+     * The size of the file, in bytes.
+     */
+    unsigned int size;
+} pntr_tiled_pack_file;
+
+/**
+ * Files held in memory, read through pntr_tiled_io_pack().
+ */
+typedef struct pntr_tiled_pack {
+    const pntr_tiled_pack_file* files;
+    int fileCount;
+} pntr_tiled_pack;
+
+/**
+ * Options for loading a map with pntr_load_tiled_ex().
+ */
+typedef struct pntr_tiled_load_options {
+    /**
+     * Memory-map the map and its external tilesets, like pntr_load_tiled_mapped(). Only used when io is NULL.
+     */
+    bool mapped;
+
+    /**
+     * How many threads decode the tileset images, external tilesets and image layers. 0 or 1 loads them serially.
+     *
+     * Requires PNTR_TILED_THREADS to be defined, and linking with pthreads. The loaded map is the same either way.
+     */
+    int threadCount;
+
+    /**
+     * Share images and external tilesets with other maps loaded with the same cache, or NULL to not share them.
+     */
+    pntr_tiled_cache* cache;
+
+    /**
+     * Allocates the parsed map and its tile table, or NULL to use pntr_load_memory().
+     *
+     * Images are always loaded with pntr_load_image(), and anything in the cache with pntr_load_memory().
+     */
+    const pntr_tiled_allocator* allocator;
+
+    /**
+     * Places the whole map in a bump arena, taken from the allocator in a few large blocks, so that pntr_unload_tiled()
+     * frees it all at once rather than piece by piece.
+     */
+    bool arena;
+
+    /**
+     * Parse the map and its external tilesets without copying their strings. The strings point into the file data
+     * instead, which stays loaded until the map is unloaded, and are not limited to CUTE_TILED_INTERNAL_BUFFER_MAX.
+     *
+     * Memory-mapped files are read into memory first, so that the strings do not depend on the files staying as they
+     * are.
+     */
+    bool inPlace;
+
+    /**
+     * Decode each tileset image the first time pntr_tiled_tile_image() resolves one of its tiles, rather than while
+     * loading, so tilesets the map never draws are never decoded.
+     *
+     * @see pntr_tiled_preload_tilesets()
+     */
+    bool lazyImages;
+
+    /**
+     * Decides which layers to load from their name and type, such as "tilelayer" or "objectgroup", or NULL to load all
+     * of them. Rejected layers are skipped over while parsing, and a rejected group skips all of its children.
+     *
+     * The map keeps it, along with layerFilterUserData, to filter pntr_tiled_reload() too.
+     */
+    bool (*layerFilter)(const char* name, const char* type, void* userData);
+
+    /**
+     * Passed along to layerFilter.
+     */
+    void* layerFilterUserData;
+
+    /**
+     * Do not load any tileset or image layer images, such as for a headless server. Their image pointers are NULL.
+     */
+    bool noImages;
+
+    /**
+     * Do not build the tile table. pntr_tiled_tile_image() returns NULL, and tiles are not drawn, though tile layers
+     * still hold their gids.
+     */
+    bool noTileTable;
+
+    /**
+     * Where to report why the load failed, or NULL to print it instead.
+     */
+    pntr_tiled_error* error;
+
+    /**
+     * Where to read the map, its external tilesets and its images from, or NULL for pntr_tiled_io_files(). The map
+     * keeps a copy, to load lazy images and reload through it later.
+     *
+     * Cached images and tilesets are found by their path alone, so maps sharing a cache should share their io too.
+     */
+    const pntr_tiled_io* io;
+
+    /**
+     * Pack every tile that the map's layers and tile objects use, along with their animation frames, into a single
+     * atlas image without any margin or spacing, and unload the tileset images. Tiles of collection of images tilesets
+     * are packed from their own images.
+     *
+     * Tiles that nothing uses while loading are left out, and have no image, and the tilesets' image pointers are NULL.
+     * pntr_tiled_reload() packs the atlas again. Loads all the images up front, even with lazyImages. Should the atlas
+     * fail to build, the tiles stay within their tileset images.
+     */
+    bool atlas;
+
+    /**
+     * Index the objects of every object layer in a grid, so that drawing them and pntr_tiled_query_objects_rect() only
+     * visit the objects near the area in question. Objects moved after loading need pntr_tiled_update_object().
+     *
+     * @see pntr_tiled_index_objects()
+     */
+    bool indexObjects;
+} pntr_tiled_load_options;
+
+/**
+ * Load a Tiled map that is exported as a JSON file, with the given options.
+ *
+ * Every load keeps its own state, so independent maps can load on different threads at the same time. Only with
+ * PNTR_TILED_THREADS defined is the cache locked, so that they can share one. Otherwise, each thread needs its own.
+ *
+ * @param fileName The name of the file to load.
+ * @param options The options to load the map with, or NULL to use the defaults.
+ * @return The loaded map data, or NULL on failure.
+ */
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_ex(const char* fileName, const pntr_tiled_load_options* options);
+
+/**
+ * Reads files from the file system, the default io of pntr_load_tiled_ex().
+ *
+ * @param mapped Memory-map the files where possible, rather than reading them into memory.
+ * @return The io, which needs no unloading.
+ */
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_files(bool mapped);
+
+/**
+ * Reads files from a pack held in memory. Maps and tilesets that are not parsed in place, and images, are read
+ * straight from the pack without being copied.
+ *
+ * @param pack The files to read from, which must outlive the maps loaded through it.
+ * @return The io, which needs no unloading.
+ */
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_pack(const pntr_tiled_pack* pack);
+
+/**
+ * A map that is loading in the background, from pntr_load_tiled_async().
+ */
+typedef struct pntr_tiled_loading pntr_tiled_loading;
+
+/**
+ * The stages that loading a map goes through, in order.
+ */
+typedef enum pntr_tiled_load_stage {
+    PNTR_TILED_LOAD_READ = 0,       // Reading the map file.
+    PNTR_TILED_LOAD_PARSE,          // Parsing the map.
+    PNTR_TILED_LOAD_TILESETS,       // Parsing the external tilesets.
+    PNTR_TILED_LOAD_IMAGES,         // Decoding the tileset and image layer images.
+    PNTR_TILED_LOAD_TILE_TABLE,     // Building the tile table.
+    PNTR_TILED_LOAD_DONE,           // The map is loaded, and pntr_tiled_load_wait() returns it right away.
+    PNTR_TILED_LOAD_FAILED          // The map failed to load, and pntr_tiled_load_wait() returns NULL right away.
+} pntr_tiled_load_stage;
+
+/**
+ * Starts loading a Tiled map on a background thread, and returns right away.
+ *
+ * The options are copied, though anything they point to, like the cache, must outlive the load. Without
+ * PNTR_TILED_THREADS, or if the thread cannot start, the map loads a stage at a time in pntr_tiled_load_poll() instead.
+ *
+ * @param fileName The name of the file to load.
+ * @param options The options to load the map with, or NULL to use the defaults.
+ * @return The load to poll, and then finish with pntr_tiled_load_wait() or pntr_tiled_load_cancel(), or NULL on failure.
+ */
+PNTR_TILED_API pntr_tiled_loading* pntr_load_tiled_async(const char* fileName, const pntr_tiled_load_options* options);
+
+/**
+ * Checks on a map that is loading, without blocking.
+ *
+ * @param loading The load to check on.
+ * @param progress Where to write how far along the load is, from 0 to 1, or NULL.
+ * @return The stage the load is in.
+ */
+PNTR_TILED_API pntr_tiled_load_stage pntr_tiled_load_poll(pntr_tiled_loading* loading, float* progress);
+
+/**
+ * Waits for a map to finish loading, and frees the load.
+ *
+ * @param loading The load to finish.
+ * @return The loaded map, or NULL on failure.
+ */
+PNTR_TILED_API cute_tiled_map_t* pntr_tiled_load_wait(pntr_tiled_loading* loading);
+
+/**
+ * Stops loading a map as soon as the current job is done, and frees the load along with anything it loaded so far.
+ *
+ * @param loading The load to cancel.
+ */
+PNTR_TILED_API void pntr_tiled_load_cancel(pntr_tiled_loading* loading);
+
+/**
+ * Create a cache of images and external tilesets to share between maps.
+ *
+ * @return The new cache, or NULL on failure.
+ *
+ * @see pntr_tiled_load_options
+ */
+PNTR_TILED_API pntr_tiled_cache* pntr_load_tiled_cache(void);
+
+/**
+ * Unload the given cache. Unload all the maps that use the cache before unloading it.
+ *
+ * @param cache The cache to unload.
+ */
+PNTR_TILED_API void pntr_unload_tiled_cache(pntr_tiled_cache* cache);
 PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_memory(const unsigned char *fileData, unsigned int dataSize, const char* baseDir);
+
+/**
+ * Bake a Tiled map into a binary file, that pntr_load_tiled_baked() can load without parsing any JSON.
+ *
+ * The bake holds the layers, objects, properties, tilesets and tile table of the map, along with a hash of the map
+ * and its external tilesets. Images are not baked, and are loaded from their original paths.
+ *
+ * Baked files are specific to the architecture and version of pntr_tiled they were made with.
+ *
+ * @param fileName The Tiled JSON map to bake.
+ * @param bakedFileName Where to save the baked map.
+ * @return True on success, false otherwise.
+ */
+PNTR_TILED_API bool pntr_save_tiled_baked(const char* fileName, const char* bakedFileName);
+
+/**
+ * Load a map baked with pntr_save_tiled_baked(), with a single read and a pass to fix up its pointers.
+ *
+ * When a source file is given, the bake is checked against it. Stale or incompatible bakes are rebuilt from the source.
+ *
+ * @param bakedFileName The baked map file to load.
+ * @param sourceFileName The Tiled JSON map the bake was made from, or NULL to load the bake without checking it.
+ * @return The loaded map data, or NULL on failure.
+ */
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_baked(const char* bakedFileName, const char* sourceFileName);
+
+/**
+ * Load a map baked with pntr_save_tiled_baked() through the given io, like pntr_load_tiled_baked().
+ *
+ * The bake, its source, the external tilesets and the images are all read through the io, which the map keeps to load
+ * lazy images later. Stale bakes are rebuilt in memory, but only saved again when reading from the file system.
+ *
+ * @param bakedFileName The baked map file to load.
+ * @param sourceFileName The Tiled JSON map the bake was made from, or NULL to load the bake without checking it.
+ * @param io Where to read the files from, or NULL for pntr_tiled_io_files().
+ * @return The loaded map data, or NULL on failure.
+ */
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_baked_ex(const char* bakedFileName, const char* sourceFileName, const pntr_tiled_io* io);
 PNTR_TILED_API void pntr_unload_tiled(cute_tiled_map_t* map);
+
+/**
+ * Reload a map from its file, patching only what changed, so that pointers into the map stay valid.
+ *
+ * The map is reloaded with the options it was loaded with, such as its layerFilter, lazyImages and inPlace, though all
+ * on the calling thread.
+ *
+ * Layers and objects are matched by id. Matched ones keep their address and take on the fresh data, new ones are
+ * added, and removed ones are freed. Tileset and image layer images, and cached external tilesets, are reused when
+ * they came from the same path and their file has not changed since, and the tile table is only rebuilt when the
+ * tilesets cover different tiles or their images changed.
+ *
+ * Matched layers and objects stay in the memory of the parse that first loaded them, so each parse is kept for as
+ * long as any of them remain in the map.
+ *
+ * Problems are reported to the given error, like pntr_tiled_load_options::error. Images and external tilesets that fail
+ * to load are left out of the map, which is still reloaded, so a successful reload can still report an error.
+ *
+ * @param map The map to reload, which cannot be a baked map.
+ * @param fileName The Tiled JSON map to reload it from.
+ * @param error Filled in with the first problem, or a NULL reason if there was none. Can be NULL, in which case
+ *              problems with the files are printed instead.
+ * @return True on success, false otherwise, in which case the map is left as it was.
+ */
+PNTR_TILED_API bool pntr_tiled_reload(cute_tiled_map_t* map, const char* fileName, pntr_tiled_error* error);
 PNTR_TILED_API void pntr_draw_tiled(pntr_image* dst, cute_tiled_map_t* map, int posX, int posY, pntr_color tint);
 
+/**
+ * Options for pntr_draw_tiled_ex(). Zero initialize it to use the defaults.
+ */
+typedef struct pntr_tiled_draw_options {
+    /**
+     * The color to tint the map when drawing, or a zero color to draw it untinted, the same as PNTR_WHITE.
+     */
+    pntr_color tint;
+
+    /**
+     * Draw every layer as though its parallax factors were 1, so that they all move along with the view.
+     */
+    bool noParallax;
+} pntr_tiled_draw_options;
+
+/**
+ * Draw the area of the map that the view covers, placing the view's top left at the top left of the destination.
+ *
+ * Only the tiles, objects and images within the view, and within the destination's clipping rectangle, are visited,
+ * so drawing costs as much as the view shows rather than the size of the map. Layers are moved by the offsets of the
+ * groups they are in, and by their parallax factors, multiplied by those of their groups. Layers line up as they do
+ * in Tiled when the view is centered on 0, 0, as the map's parallax origin is not read.
+ *
+ * Rectangle, ellipse and polygon objects are rasterized into a cache within the map, which each draw updates, so
+ * drawing is not reentrant. A map can only be drawn on one thread at a time, even into different destinations.
+ *
+ * @param dst The destination of where to draw the map.
+ * @param map The map to draw.
+ * @param view The area of the map to draw, in pixels. A width or height of zero or less uses that of the destination.
+ * @param options The options to draw the map with, or NULL to use the defaults.
+ */
+PNTR_TILED_API void pntr_draw_tiled_ex(pntr_image* dst, cute_tiled_map_t* map, pntr_rectangle view, const pntr_tiled_draw_options* options);
+
 /**
  * Draw a tile from the map onto the provided image destination.
  *
@@ -83,12 +521,37 @@ PNTR_TILED_API void pntr_draw_tiled_layer_objectlayer(pntr_image* dst, cute_tile
  * Retrieves an image representing the desired tile from the given global tile ID.
  *
  * @param map The map to get the tile from.
- * @param gid The global tile ID for the tile. This cannot exceed the number of tiles in the map.
+ * @param gid The global tile ID for the tile.
  *
- * @return A subimage from the tileset for the given tile.
+ * @return A subimage from the tileset for the given tile, or NULL if the map has no such tile, or the image of its
+ *         lazy tileset failed to load.
  */
 PNTR_TILED_API pntr_image* pntr_tiled_tile_image(cute_tiled_map_t* map, int gid);
 
+/**
+ * Draws the tile layer from chunks of chunkSize by chunkSize pixels, each rendered the first time it comes into view,
+ * rather than drawing each of its tiles every time.
+ *
+ * pntr_set_layer_tile() marks only the chunks that the tile covers to render again, and chunks with animated tiles
+ * render again whenever one of their frames changes. Changing the layer's tiles in any other way needs another call to
+ * pntr_tiled_prerender_layer(). Tiles are rendered without the tint, which is applied as the chunks are drawn.
+ *
+ * @param map The map the layer belongs to.
+ * @param layer The tile layer to prerender.
+ * @param chunkSize How wide and high each chunk is, in pixels, such as 256. 0 stops prerendering the layer, and frees
+ *                  its chunks.
+ * @return True on success, false if the layer is not a tile layer, or on failure.
+ */
+PNTR_TILED_API bool pntr_tiled_prerender_layer(cute_tiled_map_t* map, cute_tiled_layer_t* layer, int chunkSize);
+
+/**
+ * Decodes any tileset images that a map loaded with lazyImages has not needed yet, such as during a loading screen.
+ *
+ * @param map The map to load the tileset images of.
+ * @return True when all of the map's tileset images are loaded, false if any failed to load.
+ */
+PNTR_TILED_API bool pntr_tiled_preload_tilesets(cute_tiled_map_t* map);
+
 /**
  * Generate an image of the given Tiled map.
  *
@@ -120,17 +583,21 @@ PNTR_TILED_API cute_tiled_layer_t* pntr_tiled_layer(cute_tiled_map_t* map, const
 /**
  * Get the gid of the tile at the given column and row.
  *
+ * For infinite maps, the column and row are relative to the map origin, and may be negative.
+ *
  * @param layer The layer to get the tile of.
  * @param column The x coordinate of the tile.
  * @param row The y coordinate of the tile.
  *
- * @return The gid of the given tile, without its flip status.
+ * @return The gid of the given tile, without its flip status, or 0 when it is outside of the layer.
  */
 PNTR_TILED_API int pntr_layer_tile(cute_tiled_layer_t* layer, int column, int row);
 
 /**
  * Set the gid of the tile at the given column and row.
  *
+ * For infinite maps, tiles can only be set within the chunks that were saved with the map.
+ *
  * @param layer The layer to set the tile of.
  * @param column The x coordinate of the tile.
  * @param row The y coordinate of the tile.
@@ -162,6 +629,79 @@ PNTR_TILED_API pntr_color pntr_tiled_color(uint32_t color);
  */ 
 PNTR_TILED_API cute_tiled_object_t* pntr_tiled_get_object(cute_tiled_layer_t* objects_layer, const char* name);
 
+/**
+ * Index the objects of an object layer in a uniform grid, so that drawing the layer and querying its objects only
+ * visit the objects near the area in question, and pntr_tiled_get_object() finds them by name with a binary search.
+ *
+ * The index is taken from the objects as they are. Call pntr_tiled_update_object() after moving, resizing or rotating
+ * one of them, and index the layer again after adding, removing or renaming any. pntr_tiled_reload() indexes the
+ * layer again.
+ *
+ * Drawing the layer and querying its objects mark the entries of the index as they go, and sort what a draw finds
+ * within it, so they are not reentrant. A map with indexed layers can only be drawn or queried on one thread at a
+ * time.
+ *
+ * @param map The map the layer is in.
+ * @param layer The object layer to index.
+ * @return True on success, false if the layer is not an object layer, or the index could not be built.
+ */
+PNTR_TILED_API bool pntr_tiled_index_objects(cute_tiled_map_t* map, cute_tiled_layer_t* layer);
+
+/**
+ * Move an object within its layer's index, after changing its position, size, rotation, vertices or gid.
+ *
+ * @param map The map the layer is in.
+ * @param layer The object layer that the object is in.
+ * @param object The object that changed.
+ * @return True if the index was updated, false if the layer has no index or the object is not in it.
+ */
+PNTR_TILED_API bool pntr_tiled_update_object(cute_tiled_map_t* map, cute_tiled_layer_t* layer, cute_tiled_object_t* object);
+
+/**
+ * Find the objects of an object layer that overlap the given rectangle, hidden ones included.
+ *
+ * Objects are matched by their bounding box, which for rotated objects holds them at any rotation. Layers without an
+ * index have all of their objects checked. Queries of indexed layers are not reentrant, see pntr_tiled_index_objects().
+ *
+ * @param map The map the layer is in.
+ * @param layer The object layer to search.
+ * @param x The left of the rectangle, in pixels from the layer's position.
+ * @param y The top of the rectangle.
+ * @param width The width of the rectangle.
+ * @param height The height of the rectangle.
+ * @param objects Where to write the objects that were found, in no particular order. Can be NULL to only count them.
+ * @param maxObjects How many objects to write at most.
+ * @return How many objects were found, which can be more than maxObjects.
+ */
+PNTR_TILED_API int pntr_tiled_query_objects_rect(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, float width, float height, cute_tiled_object_t** objects, int maxObjects);
+
+/**
+ * Find the objects of an object layer whose bounding box holds the given point, hidden ones included.
+ *
+ * @return How many objects were found, which can be more than maxObjects.
+ *
+ * @see pntr_tiled_query_objects_rect()
+ */
+PNTR_TILED_API int pntr_tiled_query_objects_point(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, cute_tiled_object_t** objects, int maxObjects);
+
+/**
+ * Find the objects of an object layer whose bounding box overlaps the given circle, hidden ones included.
+ *
+ * @return How many objects were found, which can be more than maxObjects.
+ *
+ * @see pntr_tiled_query_objects_rect()
+ */
+PNTR_TILED_API int pntr_tiled_query_objects_circle(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, float radius, cute_tiled_object_t** objects, int maxObjects);
+
+/**
+ * Report how much memory the parse pages of the map and its external tilesets take, to tune CUTE_TILED_PAGE_SIZE.
+ *
+ * @param map The map to get the stats of.
+ * @param stats Where to write the stats.
+ * @return True on success, false for baked maps, which have no parse pages.
+ */
+PNTR_TILED_API bool pntr_tiled_get_memory_stats(cute_tiled_map_t* map, cute_tiled_memory_stats_t* stats);
+
 #ifdef PNTR_ASSETSYS_API
 PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys, const char* fileName);
 #endif  // PNTR_ASSETSYS_API
@@ -174,6 +714,7 @@ PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys,
 
 // TODO: Remove stdio.h
 #include <stdio.h> // printf
+#include <stddef.h> // offsetof
 
 #ifdef PNTR_TILED_IMPLEMENTATION
 #ifndef PNTR_TILED_IMPLEMENTATION_ONCE
@@ -203,6 +744,11 @@ PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys,
     #define PNTR_STRLEN strlen
 #endif
 
+#ifndef PNTR_MEMCMP
+    #include <string.h>
+    #define PNTR_MEMCMP memcmp
+#endif
+
 #ifndef PNTR_PATH_MAX
     #ifdef PATH_MAX
         #define PNTR_PATH_MAX PATH_MAX
@@ -211,6 +757,20 @@ PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys,
     #endif
 #endif
 
+#ifndef PNTR_TILED_NO_MMAP
+    #if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+        #define PNTR_TILED_MMAP
+        #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <fcntl.h>
+        #include <unistd.h>
+    #endif
+#endif
+
+#ifdef PNTR_TILED_THREADS
+    #include <pthread.h>
+#endif
+
 #ifndef STRPOOL_EMBEDDED_ASSERT
     #ifdef PNTR_ASSERT
         #define STRPOOL_EMBEDDED_ASSERT PNTR_ASSERT
@@ -240,168 +800,1271 @@ PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys,
     // #endif
 #endif
 
-// cute_tiled
-#define CUTE_TILED_IMPLEMENTATION
-#define CUTE_TILED_ALLOC(size, ctx) pntr_load_memory(size)
-#define CUTE_TILED_FREE(mem, ctx) pntr_unload_memory(mem)
-#define CUTE_TILED_MEMCPY PNTR_MEMCPY
-#define CUTE_TILED_MEMSET PNTR_MEMSET
-#define CUTE_TILED_SEEK_SET 0
-#define CUTE_TILED_SEEK_END 0
-#define CUTE_TILED_FILE void
-#define CUTE_TILED_FOPEN(path, state) (void*)path
-#define CUTE_TILED_FSEEK(fp, num, seekpart)
-#define CUTE_TILED_FREAD(data, sz, num, fp)
-#define CUTE_TILED_FTELL(fp) 0
-#define CUTE_TILED_FCLOSE(fp) (void)fp
-#include PNTR_TILED_CUTE_TILED_H
+/**
+ * A block of memory within a pntr_tiled_memory arena.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_arena_block {
+    struct pntr_tiled_arena_block* next;
+    size_t size;
+    size_t used;
+} pntr_tiled_arena_block;
 
 /**
- * Internal pntr_tiled data for tiles within map tilesets.
+ * Where a map's memory comes from, when loaded with an allocator or arena. Passed to cute_tiled as its mem_ctx.
  *
- * Will be saved into map->tiledversion, and managed internally.
+ * In arena mode, this lives at the start of the first block.
  *
  * @private
  * @internal
  */
-typedef struct pntr_tiled_tile {
-    pntr_image image;
-    cute_tiled_tile_descriptor_t* descriptor;
-    int animationDuration;
-    cute_tiled_tileset_t* tileset;
-} pntr_tiled_tile;
+typedef struct pntr_tiled_memory {
+    pntr_tiled_allocator allocator;
+    bool arena;
+    pntr_tiled_arena_block* blocks;
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_t mutex;
+#endif
+} pntr_tiled_memory;
 
-#ifdef __cplusplus
-extern "C" {
+#ifndef PNTR_TILED_ARENA_ALIGNMENT
+    #define PNTR_TILED_ARENA_ALIGNMENT 16
 #endif
 
+#define _PNTR_TILED_ARENA_ALIGN(size) (((size) + (PNTR_TILED_ARENA_ALIGNMENT - 1)) & ~((size_t)PNTR_TILED_ARENA_ALIGNMENT - 1))
+
+static void* _pntr_tiled_default_alloc(size_t size, void* userData) {
+    PNTR_UNUSED(userData);
+    return pntr_load_memory(size);
+}
+
+static void _pntr_tiled_default_free(void* ptr, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_unload_memory(ptr);
+}
+
 /**
- * Finds the last slash in the given path.
+ * Allocates from the given memory, or with pntr_load_memory() when there is none.
  *
  * @internal
  * @private
  */
-static char* _pntr_tiled_find_last_slash(const char* str) {
-    const char *slash     = PNTR_STRRCHR(str, '/');
-    const char *backslash = PNTR_STRRCHR(str, '\\');
+static void* _pntr_tiled_alloc(pntr_tiled_memory* memory, size_t size) {
+    if (memory == NULL) {
+        return pntr_load_memory(size);
+    }
 
-    if (!slash || (backslash > slash)) {
-        return (char*)backslash;
+    if (!memory->arena) {
+        return memory->allocator.alloc(size, memory->allocator.userData);
     }
 
-    return (char*)slash;
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_lock(&memory->mutex);
+#endif
+
+    void* output = NULL;
+    size = _PNTR_TILED_ARENA_ALIGN(size);
+    pntr_tiled_arena_block* block = memory->blocks;
+    if (block->size - block->used < size) {
+        // Grow geometrically, so that even a badly estimated arena only takes a few blocks.
+        size_t blockSize = block->size * 2;
+        if (blockSize < size) {
+            blockSize = size;
+        }
+
+        block = (pntr_tiled_arena_block*)memory->allocator.alloc(_PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_arena_block)) + blockSize, memory->allocator.userData);
+        if (block != NULL) {
+            block->next = memory->blocks;
+            block->size = blockSize;
+            block->used = 0;
+            memory->blocks = block;
+        }
+    }
+
+    if (block != NULL) {
+        output = (unsigned char*)block + _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_arena_block)) + block->used;
+        block->used += size;
+    }
+
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_unlock(&memory->mutex);
+#endif
+
+    return output;
 }
 
 /**
- * Retrieves the base path of the given path.
+ * Frees memory from _pntr_tiled_alloc(). Arenas only free everything at once, in _pntr_tiled_unload_memory().
  *
  * @internal
  * @private
  */
-static void _pntr_tiled_path_basedir(char* path) {
-    char *last = NULL;
-    if (!path || path[0] == '\0' || path[1] == '\0') {
-        return;
-    }
-
-    if ((last = _pntr_tiled_find_last_slash(path))) {
-        last[1] = '\0';
+static void _pntr_tiled_free(pntr_tiled_memory* memory, void* ptr) {
+    if (memory == NULL) {
+        pntr_unload_memory(ptr);
     }
-    else {
-        path[0] = '\0';
+    else if (!memory->arena && ptr != NULL) {
+        memory->allocator.free(ptr, memory->allocator.userData);
     }
 }
 
 /**
- * Perform any internal loading of map data.
+ * Creates the memory a map will be loaded into, with an arena sized from the given hint.
  *
  * @internal
  * @private
  */
-static void _pntr_load_map_data(cute_tiled_map_t* map) {
-    if (map == NULL) {
-        return;
+static pntr_tiled_memory* _pntr_tiled_load_memory(const pntr_tiled_allocator* allocator, bool arena, size_t sizeHint) {
+    pntr_tiled_allocator defaultAllocator = { _pntr_tiled_default_alloc, _pntr_tiled_default_free, NULL };
+    if (allocator == NULL) {
+        allocator = &defaultAllocator;
     }
 
-    // Prepare the animation counter.
-    map->nextlayerid = 0;
+    pntr_tiled_memory* memory;
+    if (arena) {
+        // The first block holds the memory itself, followed by the space for the map.
+        size_t headerSize = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_arena_block)) + _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_memory));
+        pntr_tiled_arena_block* block = (pntr_tiled_arena_block*)allocator->alloc(headerSize + sizeHint, allocator->userData);
+        if (block == NULL) {
+            return NULL;
+        }
 
-    // Count how many tiles there are
-    int tileCount = 0;
-    cute_tiled_tileset_t* tileset = map->tilesets;
-    while (tileset) {
-        tileCount += tileset->tilecount;
-        tileset = tileset->next;
+        block->next = NULL;
+        block->size = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_memory)) + sizeHint;
+        block->used = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_memory));
+        memory = (pntr_tiled_memory*)((unsigned char*)block + _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_arena_block)));
+        memory->blocks = block;
     }
-
-    // Prepare the entire tiles set
-    pntr_tiled_tile* tiles = pntr_load_memory(sizeof(pntr_tiled_tile) * (size_t)tileCount);
-
-    // Build all the tiles from each tileset.
-    tileset = map->tilesets;
-    while (tileset) {
-        for (int i = 0; i < tileset->tilecount; i++) {
-            // Calculate the gid.
-            int gid = tileset->firstgid + i - 1;
-            pntr_tiled_tile* tile = tiles + gid;
-            tile->tileset = tileset;
-            tile->descriptor = NULL;
-            tile->animationDuration = 0;
-
-            // Figure out where the tile appears in the tileset.
-            int tileX = i % tileset->columns;
-            int tileY = i / tileset->columns;
-
-            // Build the source rectangle.
-            pntr_rectangle srcRect = {
-                .x = tileX * tileset->tilewidth + tileX * tileset->spacing + tileset->margin,
-                .y = tileY * tileset->tileheight  + tileY * tileset->spacing + tileset->margin,
-                .width = tileset->tilewidth,
-                .height = tileset->tileheight
-            };
-
-            // Build the subimage as part of the tiles array.
-            pntr_image* temporaryTile = pntr_image_subimage((pntr_image*)tileset->image.ptr, srcRect.x, srcRect.y, srcRect.width, srcRect.height);
-            pntr_image* tileImage = &tile->image;
-            pntr_memory_copy((void*)tileImage, (void*)temporaryTile, sizeof(pntr_image));
-            pntr_unload_image(temporaryTile);
-
-            // Find any tile descriptors
-            cute_tiled_tile_descriptor_t* descriptor = tileset->tiles;
-            while (descriptor) {
-                // Find the descriptor for the active tile.
-                if (descriptor->tile_index == i) {
-                    tile->descriptor = descriptor;
-
-                    // Animation: Calculate how long the full animation is.
-                    for (int frameNumber = 0; frameNumber < tile->descriptor->frame_count; frameNumber++) {
-                        tile->animationDuration += tile->descriptor->animation[frameNumber].duration;
-                    }
-                    break;
-                }
-                descriptor = descriptor->next;
-            }
+    else {
+        memory = (pntr_tiled_memory*)allocator->alloc(sizeof(pntr_tiled_memory), allocator->userData);
+        if (memory == NULL) {
+            return NULL;
         }
-
-        // Onto the next tileset
-        tileset = tileset->next;
+        memory->blocks = NULL;
     }
 
-    map->tiledversion.ptr = (const char*)tiles;
-}
+    memory->allocator = *allocator;
+    memory->arena = arena;
 
-PNTR_TILED_API pntr_image* pntr_tiled_tile_image(cute_tiled_map_t* map, int gid) {
-    if (gid <= 0) {
+#ifdef PNTR_TILED_THREADS
+    if (arena && pthread_mutex_init(&memory->mutex, NULL) != 0) {
+        allocator->free(memory->blocks, allocator->userData);
         return NULL;
     }
+#endif
 
-    pntr_tiled_tile* tile = (pntr_tiled_tile*)map->tiledversion.ptr;
-    tile = tile + gid - 1;
+    return memory;
+}
 
-    // Process any descriptive tile properties.
+/**
+ * Frees the given memory, along with everything in its arena.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_memory(pntr_tiled_memory* memory) {
+    if (memory == NULL) {
+        return;
+    }
+
+    pntr_tiled_allocator allocator = memory->allocator;
+    if (!memory->arena) {
+        allocator.free(memory, allocator.userData);
+        return;
+    }
+
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_destroy(&memory->mutex);
+#endif
+
+    // The memory itself is within the last block, so it goes with it.
+    pntr_tiled_arena_block* block = memory->blocks;
+    while (block) {
+        pntr_tiled_arena_block* next = block->next;
+        allocator.free(block, allocator.userData);
+        block = next;
+    }
+}
+
+// cute_tiled
+#define CUTE_TILED_IMPLEMENTATION
+#define CUTE_TILED_ALLOC(size, ctx) _pntr_tiled_alloc((pntr_tiled_memory*)(ctx), (size_t)(size))
+#define CUTE_TILED_FREE(mem, ctx) _pntr_tiled_free((pntr_tiled_memory*)(ctx), (mem))
+#define CUTE_TILED_MEMCPY PNTR_MEMCPY
+#define CUTE_TILED_MEMSET PNTR_MEMSET
+#define CUTE_TILED_SEEK_SET 0
+#define CUTE_TILED_SEEK_END 0
+#define CUTE_TILED_FILE void
+#define CUTE_TILED_FOPEN(path, state) (void*)path
+#define CUTE_TILED_FSEEK(fp, num, seekpart)
+#define CUTE_TILED_FREAD(data, sz, num, fp)
+#define CUTE_TILED_FTELL(fp) 0
+#define CUTE_TILED_FCLOSE(fp) (void)fp
+#include PNTR_TILED_CUTE_TILED_H
+
+/**
+ * Internal pntr_tiled data for tiles within map tilesets.
+ *
+ * Will be saved into map->tiledversion, and managed internally.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_tile {
+    pntr_image image;
+    cute_tiled_tile_descriptor_t* descriptor;
+    int animationDuration;
+    cute_tiled_tileset_t* tileset;
+    bool missing; // The image of its lazy tileset failed to load, so the tile has no image.
+} pntr_tiled_tile;
+
+/**
+ * A file opened through a pntr_tiled_io, with its data either lent out by the io, or read into memory.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_file {
+    unsigned char* data;
+    unsigned int size;
+    pntr_tiled_io io;
+    void* handle; // The open file while data is its view, or NULL when data was read into memory.
+} pntr_tiled_file;
+
+/**
+ * File data that a map parsed in place keeps loaded, since its strings point into it.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_source {
+    pntr_tiled_file file;
+    struct pntr_tiled_source* next;
+} pntr_tiled_source;
+
+/**
+ * A tileset whose image is loaded on first use, for maps loaded with lazyImages.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_lazy_tileset {
+    cute_tiled_tileset_t* tileset;
+    const char* path; // The full path of the tileset image, or NULL once it has been loaded.
+} pntr_tiled_lazy_tileset;
+
+/**
+ * Which file a tileset or image layer image was loaded from, so pntr_tiled_reload() can tell whether it changed.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_image_source {
+    const cute_tiled_string_t* image; // The image of the tileset or image layer.
+    uint64_t hash; // The _pntr_tiled_image_hash() of its path, or 0 if it has none.
+    uint64_t contentHash; // The _pntr_tiled_content_hash() of the file it was loaded from, or 0 until it is loaded.
+} pntr_tiled_image_source;
+
+/**
+ * The gids of a tileset, and where its tiles are within the tile table.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_gid_range {
+    int firstgid;
+    int count;
+    int offset; // The index of the tileset's first tile within the tile table.
+} pntr_tiled_gid_range;
+
+/**
+ * An animated tile within a prerendered chunk, along with the frame it was rendered with.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_chunk_frame {
+    int column;
+    int row;
+    pntr_image* frame;
+} pntr_tiled_chunk_frame;
+
+/**
+ * A chunk of a prerendered tile layer.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_layer_chunk {
+    pntr_image* image; // The rendered tiles, or NULL when the chunk has none.
+    bool rendered; // Whether the chunk was rendered since it was last marked dirty.
+    pntr_tiled_chunk_frame* frames; // The animated tiles of the chunk.
+    int frameCount;
+} pntr_tiled_layer_chunk;
+
+/**
+ * The chunks of a tile layer prerendered with pntr_tiled_prerender_layer(). Tile layers have no image, so their image
+ * points to it.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_layer_cache {
+    cute_tiled_layer_t* layer;
+    int chunkSize;
+    int tileWidth; // The size of the map's grid.
+    int tileHeight;
+    int originX; // Where the first chunk is, in pixels from the layer's first tile.
+    int originY;
+    int columns; // How many chunks there are across and down.
+    int rows;
+    int overflowX; // How far the largest tiles reach past the grid, in pixels.
+    int overflowY;
+    pntr_tiled_layer_chunk* chunks;
+    struct pntr_tiled_layer_cache* next;
+} pntr_tiled_layer_cache;
+
+/**
+ * The area an object covers, in pixels from the position of its layer.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_object_bounds {
+    float left;
+    float top;
+    float right;
+    float bottom;
+} pntr_tiled_object_bounds;
+
+/**
+ * An object within a pntr_tiled_object_index.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_object_entry {
+    cute_tiled_object_t* object;
+    pntr_tiled_object_bounds bounds; // Where the object was when it was last indexed.
+    int firstColumn; // The cells the object is in, or -1 when it covers too many and is in the last cell instead.
+    int firstRow;
+    int lastColumn;
+    int lastRow;
+    unsigned int mark; // The last query that came across the object.
+} pntr_tiled_object_entry;
+
+/**
+ * A cell of a pntr_tiled_object_index, listing the entries of the objects that overlap it.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_object_cell {
+    int* entries;
+    int count;
+    int capacity;
+    bool allocated; // Whether the entries grew out of the index's memory into their own.
+} pntr_tiled_object_cell;
+
+/**
+ * The uniform grid of an object layer indexed with pntr_tiled_index_objects(). Object layers have no image, so their
+ * image points to it.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_object_index {
+    cute_tiled_layer_t* layer;
+    pntr_tiled_object_entry* entries; // In the same order as the layer's objects.
+    int count;
+    pntr_tiled_object_entry** byObject; // The entries sorted by the address of their object.
+    pntr_tiled_object_entry** byName; // The entries of named objects, sorted by name.
+    int nameCount;
+    float originX; // Where the first cell is, in pixels from the layer's position.
+    float originY;
+    float cellSize;
+    int columns;
+    int rows;
+    pntr_tiled_object_cell* cells; // Across then down, followed by the objects that cover too many cells.
+    unsigned int mark; // The query in progress, which entries are marked with as it comes across them.
+    pntr_tiled_object_entry** found; // The entries that the last draw came across.
+    int foundCapacity;
+    struct pntr_tiled_object_index* next;
+} pntr_tiled_object_index;
+
+/**
+ * A rectangle, ellipse or polygon object rasterized into an image, within a pntr_tiled_shape_cache. Objects of the
+ * same shape, size, rotation and tint share it.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_shape {
+    uint64_t hash; // Hash of everything below, up to the image.
+    int ellipse;
+    float width;
+    float height;
+    float rotation;
+    uint32_t tint;
+    int vertCount;
+    float* vertices; // A copy of the polygon's vertices, allocated along with the shape.
+    pntr_image* image;
+    size_t size; // How much memory the image takes up.
+    struct pntr_tiled_shape* next; // The next shape in the same bucket.
+    struct pntr_tiled_shape* newer; // The shapes from the least to the most recently drawn.
+    struct pntr_tiled_shape* older;
+} pntr_tiled_shape;
+
+/**
+ * The rasterized shape objects of a map, dropping the least recently drawn to stay within
+ * PNTR_TILED_SHAPE_CACHE_SIZE. Every draw of a shape object moves it up, or adds it, without any locking.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_shape_cache {
+    pntr_tiled_shape** buckets;
+    int bucketCount;
+    int count;
+    pntr_tiled_shape* newest;
+    pntr_tiled_shape* oldest;
+    size_t size; // How much memory the images take up.
+} pntr_tiled_shape_cache;
+
+/**
+ * Internal pntr_tiled data for a map, holding the tile table.
+ *
+ * Will be saved into map->tiledversion, and managed internally.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_map_data {
+    pntr_tiled_tile* tiles; // Each tileset's tiles, one after the other, without any of the gaps between their gids.
+    int tileCount;
+    pntr_tiled_gid_range* ranges; // The gids of each tileset, sorted by firstgid.
+    int rangeCount;
+    int directCount; // Gids 1 to directCount have no gaps before them, so are found at tiles[gid - 1].
+    unsigned char* baked; // The baked file that holds the entire map, when loaded with pntr_load_tiled_baked().
+    pntr_tiled_cache* cache; // Where the images and external tilesets came from, if anywhere.
+    pntr_tiled_memory* memory; // Where the map and this data were allocated, or NULL for pntr_load_memory().
+    pntr_tiled_source* sources; // The file data the map's strings point into, when parsed in place.
+    pntr_tiled_lazy_tileset* lazy; // The tilesets with images to load on first use, when loaded with lazyImages.
+    int lazyCount;
+    pntr_tiled_image_source* images; // Where each tileset and image layer image came from.
+    int imageCount;
+    cute_tiled_map_t* generations; // Earlier parses that still hold layers, objects or tilesets of the map, linked through their tiledversion.
+    pntr_tiled_io io; // Where lazy images and pntr_tiled_reload() read files from.
+    pntr_image* atlas; // The image the tiles were packed into, when loaded with the atlas option.
+    pntr_tiled_layer_cache* layerCaches; // The layers prerendered with pntr_tiled_prerender_layer().
+    pntr_tiled_object_index* objectIndexes; // The object layers indexed with pntr_tiled_index_objects().
+    bool indexObjects; // Whether every object layer is indexed, when loaded with the indexObjects option.
+    pntr_tiled_load_options options; // What the map was loaded with, for pntr_tiled_reload(), without its error, io or allocator.
+    pntr_tiled_shape_cache shapes; // The rectangle, ellipse and polygon objects that were drawn.
+} pntr_tiled_map_data;
+
+/**
+ * An image or external tileset within a pntr_tiled_cache.
+ *
+ * @private
+ * @internal
+ */
+typedef struct pntr_tiled_cache_entry {
+    char* path;
+    uint32_t transparentColor;
+    pntr_image* image;
+    cute_tiled_tileset_t* tileset;
+    pntr_tiled_source* source; // The tileset's file data, when parsed in place.
+    uint64_t contentHash; // The _pntr_tiled_content_hash() of the file it came from.
+    int references;
+    struct pntr_tiled_cache_entry* next;
+} pntr_tiled_cache_entry;
+
+struct pntr_tiled_cache {
+    pntr_tiled_cache_entry* entries;
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_t mutex;
+#endif
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Finds the last slash in the given path.
+ *
+ * @internal
+ * @private
+ */
+static char* _pntr_tiled_find_last_slash(const char* str) {
+    const char *slash     = PNTR_STRRCHR(str, '/');
+    const char *backslash = PNTR_STRRCHR(str, '\\');
+
+    if (!slash || (backslash > slash)) {
+        return (char*)backslash;
+    }
+
+    return (char*)slash;
+}
+
+/**
+ * Retrieves the base path of the given path.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_path_basedir(char* path) {
+    char *last = NULL;
+    if (!path || path[0] == '\0' || path[1] == '\0') {
+        return;
+    }
+
+    if ((last = _pntr_tiled_find_last_slash(path))) {
+        last[1] = '\0';
+    }
+    else {
+        path[0] = '\0';
+    }
+}
+
+/**
+ * Loads the given file. When mapped is true, attempts to memory-map the file instead, and sets mapped to whether it was.
+ *
+ * @internal
+ * @private
+ */
+static unsigned char* _pntr_tiled_load_file(const char* fileName, unsigned int* bytesRead, bool* mapped) {
+#ifdef PNTR_TILED_MMAP
+    if (*mapped) {
+        int fd = open(fileName, O_RDONLY);
+        if (fd >= 0) {
+            struct stat st;
+            void* data = MAP_FAILED;
+
+            // Files ending on a page boundary are read normally, so the parser can always peek one byte past the end.
+            if (fstat(fd, &st) == 0 && st.st_size > 0 && (unsigned long long)st.st_size < 0xFFFFFFFFULL && st.st_size % sysconf(_SC_PAGESIZE) != 0) {
+                // Read only. Parsing in place copies the data instead, see _pntr_tiled_io_file_map().
+                data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            close(fd);
+
+            if (data != MAP_FAILED) {
+                *bytesRead = (unsigned int)st.st_size;
+                return (unsigned char*)data;
+            }
+        }
+    }
+#endif
+
+    *mapped = false;
+    return pntr_load_file(fileName, bytesRead);
+}
+
+/**
+ * Unloads a file that was loaded with _pntr_tiled_load_file().
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_file(unsigned char* data, unsigned int size, bool mapped) {
+#ifdef PNTR_TILED_MMAP
+    if (mapped) {
+        munmap((void*)data, (size_t)size);
+        return;
+    }
+#else
+    PNTR_UNUSED(mapped);
+#endif
+    PNTR_UNUSED(size);
+    pntr_unload_file(data);
+}
+
+/**
+ * A file opened by pntr_tiled_io_files().
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_io_file {
+    unsigned char* data;
+    unsigned int size;
+    bool mapped;
+} pntr_tiled_io_file;
+
+/**
+ * Loads the given file with _pntr_tiled_load_file(), memory-mapping it when asked to.
+ *
+ * @internal
+ * @private
+ */
+static void* _pntr_tiled_io_file_load(const char* fileName, bool mapped) {
+    pntr_tiled_io_file* file = (pntr_tiled_io_file*)pntr_load_memory(sizeof(pntr_tiled_io_file));
+    if (file == NULL) {
+        return NULL;
+    }
+
+    file->mapped = mapped;
+    file->data = _pntr_tiled_load_file(fileName, &file->size, &file->mapped);
+    if (file->data == NULL) {
+        pntr_unload_memory(file);
+        return NULL;
+    }
+
+    return file;
+}
+
+static void* _pntr_tiled_io_file_open(const char* fileName, void* userData) {
+    PNTR_UNUSED(userData);
+    return _pntr_tiled_io_file_load(fileName, false);
+}
+
+static void* _pntr_tiled_io_file_open_mapped(const char* fileName, void* userData) {
+    PNTR_UNUSED(userData);
+    return _pntr_tiled_io_file_load(fileName, true);
+}
+
+static unsigned int _pntr_tiled_io_file_size(void* file, void* userData) {
+    PNTR_UNUSED(userData);
+    return ((pntr_tiled_io_file*)file)->size;
+}
+
+/**
+ * Lends out the file data, which is private to the handle. A mapping is only lent out to read, as strings parsed in
+ * place point into the data for as long as the map is loaded, and the file changing under the mapping would pull
+ * them out from under it, or fault once it is truncated. Such loads copy the data with _pntr_tiled_io_file_read().
+ *
+ * @internal
+ * @private
+ */
+static unsigned char* _pntr_tiled_io_file_map(void* file, bool writable, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_tiled_io_file* ioFile = (pntr_tiled_io_file*)file;
+    return writable && ioFile->mapped ? NULL : ioFile->data;
+}
+
+static bool _pntr_tiled_io_file_read(void* file, unsigned char* buffer, unsigned int size, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_memory_copy((void*)buffer, (void*)((pntr_tiled_io_file*)file)->data, (size_t)size);
+    return true;
+}
+
+static void _pntr_tiled_io_file_close(void* file, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_tiled_io_file* ioFile = (pntr_tiled_io_file*)file;
+    _pntr_tiled_unload_file(ioFile->data, ioFile->size, ioFile->mapped);
+    pntr_unload_memory(ioFile);
+}
+
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_files(bool mapped) {
+    pntr_tiled_io io;
+    PNTR_MEMSET(&io, 0, sizeof(io));
+    io.open = mapped ? _pntr_tiled_io_file_open_mapped : _pntr_tiled_io_file_open;
+    io.size = _pntr_tiled_io_file_size;
+    io.map = _pntr_tiled_io_file_map;
+    io.read = _pntr_tiled_io_file_read;
+    io.close = _pntr_tiled_io_file_close;
+    return io;
+}
+
+/**
+ * Finds the given file within the pack by its exact path.
+ *
+ * @internal
+ * @private
+ */
+static void* _pntr_tiled_io_pack_open(const char* fileName, void* userData) {
+    const pntr_tiled_pack* pack = (const pntr_tiled_pack*)userData;
+    for (int i = 0; i < pack->fileCount; i++) {
+        if (PNTR_STRCMP(pack->files[i].fileName, fileName) == 0) {
+            return (void*)(pack->files + i);
+        }
+    }
+
+    return NULL;
+}
+
+static unsigned int _pntr_tiled_io_pack_size(void* file, void* userData) {
+    PNTR_UNUSED(userData);
+    return ((const pntr_tiled_pack_file*)file)->size;
+}
+
+/**
+ * Lends out the file straight from the pack, unless it is to be written to.
+ *
+ * @internal
+ * @private
+ */
+static unsigned char* _pntr_tiled_io_pack_map(void* file, bool writable, void* userData) {
+    PNTR_UNUSED(userData);
+    return writable ? NULL : (unsigned char*)((const pntr_tiled_pack_file*)file)->data;
+}
+
+static bool _pntr_tiled_io_pack_read(void* file, unsigned char* buffer, unsigned int size, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_memory_copy((void*)buffer, (void*)((const pntr_tiled_pack_file*)file)->data, (size_t)size);
+    return true;
+}
+
+static void _pntr_tiled_io_pack_close(void* file, void* userData) {
+    PNTR_UNUSED(file);
+    PNTR_UNUSED(userData);
+}
+
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_pack(const pntr_tiled_pack* pack) {
+    pntr_tiled_io io;
+    PNTR_MEMSET(&io, 0, sizeof(io));
+    io.open = _pntr_tiled_io_pack_open;
+    io.size = _pntr_tiled_io_pack_size;
+    io.map = _pntr_tiled_io_pack_map;
+    io.read = _pntr_tiled_io_pack_read;
+    io.close = _pntr_tiled_io_pack_close;
+    io.userData = (void*)pack;
+    return io;
+}
+
+/**
+ * Opens the given file through the io, borrowing its view when the io lends one out, and reading it into memory
+ * otherwise. When writable is true, the data can be written to, such as to parse it in place.
+ *
+ * @return True if the file was opened. Close it with _pntr_tiled_close_file().
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_open_file(const pntr_tiled_io* io, const char* fileName, bool writable, pntr_tiled_file* file) {
+    PNTR_MEMSET(file, 0, sizeof(pntr_tiled_file));
+    void* handle = io->open(fileName, io->userData);
+    if (handle == NULL) {
+        return false;
+    }
+
+    file->io = *io;
+    file->size = io->size(handle, io->userData);
+    if (io->map != NULL) {
+        file->data = io->map(handle, writable, io->userData);
+        if (file->data != NULL) {
+            file->handle = handle;
+            return true;
+        }
+    }
+
+    // Null terminated, as the parser may peek one byte past the end.
+    if (io->read != NULL && file->size < 0xFFFFFFFFU) {
+        file->data = (unsigned char*)pntr_load_memory((size_t)file->size + 1);
+        if (file->data != NULL && io->read(handle, file->data, file->size, io->userData)) {
+            file->data[file->size] = '\0';
+        }
+        else {
+            pntr_unload_memory(file->data);
+            file->data = NULL;
+        }
+    }
+
+    io->close(handle, io->userData);
+    return file->data != NULL;
+}
+
+/**
+ * Closes a file opened with _pntr_tiled_open_file().
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_close_file(pntr_tiled_file* file) {
+    if (file->handle != NULL) {
+        file->io.close(file->handle, file->io.userData);
+    }
+    else {
+        pntr_unload_memory(file->data);
+    }
+
+    file->data = NULL;
+    file->handle = NULL;
+}
+
+/**
+ * Unloads the given list of file data, kept for maps parsed in place.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_sources(pntr_tiled_source* source) {
+    while (source) {
+        pntr_tiled_source* next = source->next;
+        _pntr_tiled_close_file(&source->file);
+        pntr_unload_memory(source);
+        source = next;
+    }
+}
+
+/**
+ * Continues a 64-bit FNV-1a hash over the given data.
+ *
+ * @internal
+ * @private
+ */
+static uint64_t _pntr_tiled_hash(uint64_t hash, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * Identifies what a file holds, so that images and tilesets loaded from it can be told apart from those loaded before
+ * it changed.
+ *
+ * @return The hash, which is never 0.
+ *
+ * @internal
+ * @private
+ */
+static uint64_t _pntr_tiled_content_hash(const unsigned char* data, unsigned int size) {
+    uint64_t hash = _pntr_tiled_hash(14695981039346656037ULL, (const unsigned char*)&size, sizeof(size));
+    hash = _pntr_tiled_hash(hash, data, size);
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * Reads the given file through the io to find its _pntr_tiled_content_hash().
+ *
+ * @return The hash, or 0 if the file could not be read.
+ *
+ * @internal
+ * @private
+ */
+static uint64_t _pntr_tiled_file_hash(const pntr_tiled_io* io, const char* fileName) {
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, fileName, false, &file)) {
+        return 0;
+    }
+
+    uint64_t hash = _pntr_tiled_content_hash(file.data, file.size);
+    _pntr_tiled_close_file(&file);
+    return hash;
+}
+
+/**
+ * Sets up the first count tiles of the tileset, attaching their descriptors in a single pass over the tileset's
+ * descriptor list. Their images are left as they are.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_init_tiles(pntr_tiled_tile* tiles, cute_tiled_tileset_t* tileset, int count) {
+    for (int i = 0; i < count; i++) {
+        tiles[i].tileset = tileset;
+        tiles[i].descriptor = NULL;
+        tiles[i].animationDuration = 0;
+        tiles[i].missing = false;
+    }
+
+    cute_tiled_tile_descriptor_t* descriptor = tileset->tiles;
+    while (descriptor) {
+        // The first descriptor of a tile wins, should there be more than one.
+        int i = descriptor->tile_index;
+        if (i >= 0 && i < count && tiles[i].descriptor == NULL) {
+            tiles[i].descriptor = descriptor;
+
+            // Animation: Calculate how long the full animation is.
+            for (int frameNumber = 0; frameNumber < descriptor->frame_count; frameNumber++) {
+                tiles[i].animationDuration += descriptor->animation[frameNumber].duration;
+            }
+        }
+        descriptor = descriptor->next;
+    }
+}
+
+/**
+ * Finds where the given tile appears in its tileset image.
+ *
+ * @internal
+ * @private
+ */
+static pntr_rectangle _pntr_tiled_tile_source(cute_tiled_tileset_t* tileset, int i) {
+    int columns = tileset->columns > 0 ? tileset->columns : 1;
+    int tileX = i % columns;
+    int tileY = i / columns;
+
+    pntr_rectangle srcRect = {
+        .x = tileX * tileset->tilewidth + tileX * tileset->spacing + tileset->margin,
+        .y = tileY * tileset->tileheight  + tileY * tileset->spacing + tileset->margin,
+        .width = tileset->tilewidth,
+        .height = tileset->tileheight
+    };
+
+    return srcRect;
+}
+
+/**
+ * Builds a subimage of the given image in place, like pntr_image_subimage() without allocating. The view is left
+ * empty when there is no image, or the source falls outside it.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_view_image(pntr_image* view, pntr_image* image, pntr_rectangle srcRect) {
+    PNTR_MEMSET((void*)view, 0, sizeof(pntr_image));
+    if (image == NULL) {
+        return;
+    }
+
+    // Clip the source to the tileset image.
+    int right = srcRect.x + srcRect.width;
+    int bottom = srcRect.y + srcRect.height;
+    int x = srcRect.x > 0 ? srcRect.x : 0;
+    int y = srcRect.y > 0 ? srcRect.y : 0;
+    right = right < image->width ? right : image->width;
+    bottom = bottom < image->height ? bottom : image->height;
+    if (right <= x || bottom <= y) {
+        return;
+    }
+
+    view->data = (pntr_color*)((unsigned char*)image->data + (size_t)y * (size_t)image->pitch) + x;
+    view->width = right - x;
+    view->height = bottom - y;
+    view->pitch = image->pitch;
+    view->subimage = true;
+    view->clip.width = view->width;
+    view->clip.height = view->height;
+}
+
+/**
+ * Builds the tile's image as a subimage of its tileset image, in place within the tile table.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_load_tile_image(pntr_tiled_tile* tile, pntr_rectangle srcRect) {
+    _pntr_tiled_view_image(&tile->image, (pntr_image*)tile->tileset->image.ptr, srcRect);
+}
+
+/**
+ * Finds the range of tileset gids that the given gid falls within, or NULL if it is in none of them.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_gid_range* _pntr_tiled_find_range(pntr_tiled_map_data* data, int gid) {
+    int low = 0;
+    int high = data->rangeCount;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (data->ranges[middle].firstgid <= gid) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    if (low == 0 || gid - data->ranges[low - 1].firstgid >= data->ranges[low - 1].count) {
+        return NULL;
+    }
+
+    return data->ranges + low - 1;
+}
+
+/**
+ * Finds the given gid within the tile table, or NULL if no tileset has it.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_tile* _pntr_tiled_find_tile(pntr_tiled_map_data* data, int gid) {
+    // Most maps have no gaps between their tilesets, so their gids index the table directly.
+    unsigned int index = (unsigned int)gid - 1U;
+    if (index < (unsigned int)data->directCount) {
+        return data->tiles + index;
+    }
+
+    pntr_tiled_gid_range* range = gid > 0 ? _pntr_tiled_find_range(data, gid) : NULL;
+    if (range == NULL) {
+        return NULL;
+    }
+
+    return data->tiles + range->offset + (gid - range->firstgid);
+}
+
+/**
+ * Finds the tiles of the given tileset within the tile table.
+ *
+ * @return The tileset's first tile, or NULL if it has none in the table.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_tile* _pntr_tiled_tileset_tiles(pntr_tiled_map_data* data, cute_tiled_tileset_t* tileset, int* count) {
+    pntr_tiled_gid_range* range = _pntr_tiled_find_range(data, tileset->firstgid);
+    if (range == NULL || range->firstgid != tileset->firstgid) {
+        *count = 0;
+        return NULL;
+    }
+
+    *count = range->count;
+    return data->tiles + range->offset;
+}
+
+/**
+ * Sets up the tile table entries of the given tileset, and builds their images.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_load_tileset_tiles(pntr_tiled_map_data* data, cute_tiled_tileset_t* tileset) {
+    int count;
+    pntr_tiled_tile* tiles = _pntr_tiled_tileset_tiles(data, tileset, &count);
+    if (tiles == NULL) {
+        return;
+    }
+
+    _pntr_tiled_init_tiles(tiles, tileset, count);
+    for (int i = 0; i < count; i++) {
+        _pntr_tiled_load_tile_image(tiles + i, _pntr_tiled_tile_source(tileset, i));
+    }
+}
+
+/**
+ * Counts how many tiles the map's tilesets have, along with how many tilesets have any.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_tile_count(cute_tiled_map_t* map, int* rangeCount) {
+    int tileCount = 0;
+    *rangeCount = 0;
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->tilecount > 0) {
+            tileCount += tileset->tilecount;
+            (*rangeCount)++;
+        }
+        tileset = tileset->next;
+    }
+
+    return tileCount;
+}
+
+/**
+ * Indexes the gids of the map's tilesets, with their tiles placed one after the other in the tile table, in gid order.
+ *
+ * @param ranges Where to place the ranges, with room for each tileset counted by _pntr_tiled_tile_count().
+ * @param directCount Set to how many gids from 1 onward can index the table directly.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_index_tilesets(cute_tiled_map_t* map, pntr_tiled_gid_range* ranges, int* directCount) {
+    int rangeCount = 0;
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->tilecount > 0) {
+            // Tilesets are nearly always in order already, so insert each one into place.
+            pntr_tiled_gid_range range = { tileset->firstgid, tileset->tilecount, 0 };
+            int i = rangeCount++;
+            while (i > 0 && ranges[i - 1].firstgid > range.firstgid) {
+                ranges[i] = ranges[i - 1];
+                i--;
+            }
+            ranges[i] = range;
+        }
+        tileset = tileset->next;
+    }
+
+    int offset = 0;
+    for (int i = 0; i < rangeCount; i++) {
+        ranges[i].offset = offset;
+        offset += ranges[i].count;
+    }
+
+    // Gids can index the table directly for as long as the tilesets follow on from each other, starting from 1.
+    *directCount = 0;
+    for (int i = 0; i < rangeCount && ranges[i].firstgid == *directCount + 1; i++) {
+        *directCount += ranges[i].count;
+    }
+}
+
+/**
+ * How large the map data is, along with its tile table and gid ranges.
+ *
+ * @internal
+ * @private
+ */
+static size_t _pntr_tiled_map_data_size(int tileCount, int rangeCount) {
+    return sizeof(pntr_tiled_map_data) + sizeof(pntr_tiled_tile) * (size_t)tileCount + sizeof(pntr_tiled_gid_range) * (size_t)rangeCount;
+}
+
+/**
+ * Builds the tile table entries of each of the map's tilesets, within the table allocated after the map data.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_build_tile_table(pntr_tiled_map_data* data, cute_tiled_map_t* map, int tileCount, int rangeCount) {
+    data->tiles = (pntr_tiled_tile*)(data + 1);
+    data->tileCount = tileCount;
+    data->ranges = (pntr_tiled_gid_range*)(data->tiles + tileCount);
+    data->rangeCount = rangeCount;
+    data->directCount = 0;
+    if (rangeCount == 0) {
+        return;
+    }
+
+    _pntr_tiled_index_tilesets(map, data->ranges, &data->directCount);
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        _pntr_tiled_load_tileset_tiles(data, tileset);
+        tileset = tileset->next;
+    }
+}
+
+/**
+ * Perform any internal loading of map data.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_load_map_data(cute_tiled_map_t* map, pntr_tiled_memory* memory, bool tileTable) {
+    if (map == NULL) {
+        return false;
+    }
+
+    // Prepare the animation counter.
+    map->nextlayerid = 0;
+
+    // Count how many tiles there are
+    int rangeCount = 0;
+    int tileCount = tileTable ? _pntr_tiled_tile_count(map, &rangeCount) : 0;
+
+    // Prepare the entire tiles set, and the gid ranges, directly after the map data.
+    pntr_tiled_map_data* data = _pntr_tiled_alloc(memory, _pntr_tiled_map_data_size(tileCount, rangeCount));
+    if (data == NULL) {
+        map->tiledversion.ptr = NULL;
+        return false;
+    }
+    data->baked = NULL;
+    data->cache = NULL;
+    data->memory = memory;
+    data->sources = NULL;
+    data->lazy = NULL;
+    data->lazyCount = 0;
+    data->images = NULL;
+    data->imageCount = 0;
+    data->generations = NULL;
+    data->io = pntr_tiled_io_files(false);
+    data->atlas = NULL;
+    data->layerCaches = NULL;
+    data->objectIndexes = NULL;
+    data->indexObjects = false;
+    PNTR_MEMSET(&data->options, 0, sizeof(data->options));
+    PNTR_MEMSET(&data->shapes, 0, sizeof(data->shapes));
+
+    // Build all the tiles from each tileset.
+    _pntr_tiled_build_tile_table(data, map, tileCount, rangeCount);
+
+    map->tiledversion.ptr = (const char*)data;
+    return true;
+}
+
+/**
+ * Reports a problem with the given file to the error of a load, or prints it when there is none. Only the first
+ * problem is kept.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_report(pntr_tiled_error* error, const char* fileName, int line, const char* reason) {
+    if (error == NULL) {
+        if (line > 0) {
+            printf("pntr_tiled: %s:%d: %s\n", fileName, line, reason);
+        }
+        else {
+            printf("pntr_tiled: %s: %s\n", fileName, reason);
+        }
+        return;
+    }
+
+    if (error->reason != NULL) {
+        return;
+    }
+
+    // Long paths are cut short, to leave room for the reason.
+    int pathLength = (int)sizeof(error->message) / 2;
+    if (line > 0) {
+        snprintf(error->message, sizeof(error->message), "%.*s:%d: %s", pathLength, fileName, line, reason);
+    }
+    else {
+        snprintf(error->message, sizeof(error->message), "%.*s: %s", pathLength, fileName, reason);
+    }
+    error->reason = error->message;
+    error->line = line;
+}
+
+static pntr_image* _pntr_tiled_load_image(const pntr_tiled_io* io, const char* fileName, uint32_t transparentColor, pntr_tiled_cache* cache, bool current, uint64_t* contentHash);
+
+/**
+ * Loads the image of a lazy tileset, and builds the subimages of its tiles.
+ *
+ * @return True when the tileset image is loaded.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_load_lazy_tileset(pntr_tiled_map_data* data, pntr_tiled_lazy_tileset* lazy) {
+    cute_tiled_tileset_t* tileset = lazy->tileset;
+    if (lazy->path == NULL) {
+        return tileset->image.ptr != NULL;
+    }
+
+    // Only try once, even if the image fails to load.
+    const char* path = lazy->path;
+    lazy->path = NULL;
+    uint64_t contentHash = 0;
+    tileset->image.ptr = (const char*)_pntr_tiled_load_image(&data->io, path, tileset->transparentcolor, data->cache, false, &contentHash);
+
+    // So that pntr_tiled_reload() can tell whether the file changed since.
+    for (int i = 0; i < data->imageCount; i++) {
+        if (data->images[i].image == &tileset->image) {
+            data->images[i].contentHash = tileset->image.ptr != NULL ? contentHash : 0;
+        }
+    }
+
+    if (tileset->image.ptr == NULL) {
+        _pntr_tiled_report(NULL, path, 0, "Failed to load image");
+
+        // So that pntr_tiled_tile_image() gives up on its tiles right away.
+        int count;
+        pntr_tiled_tile* tiles = _pntr_tiled_tileset_tiles(data, tileset, &count);
+        for (int i = 0; tiles != NULL && i < count; i++) {
+            tiles[i].missing = true;
+        }
+        return false;
+    }
+
+    _pntr_tiled_load_tileset_tiles(data, tileset);
+    return true;
+}
+
+PNTR_TILED_API pntr_image* pntr_tiled_tile_image(cute_tiled_map_t* map, int gid) {
+    if (map == NULL || map->tiledversion.ptr == NULL) {
+        return NULL;
+    }
+
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    pntr_tiled_tile* tile = _pntr_tiled_find_tile(data, gid);
+    if (tile == NULL) {
+        return NULL;
+    }
+
+    // Process any descriptive tile properties.
     if (tile->descriptor != NULL) {
         // Animation
-        if (tile->descriptor->frame_count > 0) {
+        if (tile->descriptor->frame_count > 0 && tile->animationDuration > 0) {
             // Find the active frame.
             int desiredMilliseconds = map->nextlayerid % tile->animationDuration;
             int desiredFrame = 0;
@@ -411,355 +2074,4426 @@ PNTR_TILED_API pntr_image* pntr_tiled_tile_image(cute_tiled_map_t* map, int gid)
                 if (millisecondsCounter < desiredMilliseconds) {
                     break;
                 }
-                desiredFrame = i;
+                desiredFrame = i;
+            }
+
+            // Switch the tile to the animation frame, which is within the same tileset.
+            int frameIndex = tile->descriptor->animation[desiredFrame].tileid;
+            if (frameIndex >= 0 && frameIndex < tile->tileset->tilecount) {
+                tile = tile - tile->descriptor->tile_index + frameIndex;
+            }
+        }
+    }
+
+    // Load the tileset image the first time one of its tiles is needed.
+    if (tile->image.data == NULL && data->lazy != NULL && !tile->missing) {
+        for (int i = 0; i < data->lazyCount; i++) {
+            if (data->lazy[i].tileset == tile->tileset) {
+                _pntr_tiled_load_lazy_tileset(data, data->lazy + i);
+                break;
+            }
+        }
+    }
+
+    return tile->missing ? NULL : &tile->image;
+}
+
+PNTR_TILED_API bool pntr_tiled_preload_tilesets(cute_tiled_map_t* map) {
+    if (map == NULL || map->tiledversion.ptr == NULL) {
+        return false;
+    }
+
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    bool loaded = true;
+    for (int i = 0; i < data->lazyCount; i++) {
+        loaded = _pntr_tiled_load_lazy_tileset(data, data->lazy + i) && loaded;
+    }
+
+    return loaded;
+}
+
+PNTR_TILED_API pntr_tiled_cache* pntr_load_tiled_cache(void) {
+    pntr_tiled_cache* cache = (pntr_tiled_cache*)pntr_load_memory(sizeof(pntr_tiled_cache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    cache->entries = NULL;
+#ifdef PNTR_TILED_THREADS
+    if (pthread_mutex_init(&cache->mutex, NULL) != 0) {
+        pntr_unload_memory(cache);
+        return NULL;
+    }
+#endif
+
+    return cache;
+}
+
+static void _pntr_tiled_cache_lock(pntr_tiled_cache* cache) {
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_lock(&cache->mutex);
+#else
+    PNTR_UNUSED(cache);
+#endif
+}
+
+static void _pntr_tiled_cache_unlock(pntr_tiled_cache* cache) {
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_unlock(&cache->mutex);
+#else
+    PNTR_UNUSED(cache);
+#endif
+}
+
+static void _pntr_tiled_unload_cache_entry(pntr_tiled_cache_entry* entry) {
+    if (entry->image != NULL) {
+        pntr_unload_image(entry->image);
+    }
+    if (entry->tileset != NULL) {
+        cute_tiled_free_external_tileset(entry->tileset);
+    }
+    _pntr_tiled_unload_sources(entry->source);
+    pntr_unload_memory(entry->path);
+    pntr_unload_memory(entry);
+}
+
+PNTR_TILED_API void pntr_unload_tiled_cache(pntr_tiled_cache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    pntr_tiled_cache_entry* entry = cache->entries;
+    while (entry) {
+        pntr_tiled_cache_entry* next = entry->next;
+        _pntr_tiled_unload_cache_entry(entry);
+        entry = next;
+    }
+
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_destroy(&cache->mutex);
+#endif
+    pntr_unload_memory(cache);
+}
+
+/**
+ * Finds an image or tileset in the cache, and takes a reference to it. The cache must be locked.
+ *
+ * @param contentHash The _pntr_tiled_content_hash() of the file it must have come from, or 0 to take the most recent
+ * one from the path.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_cache_entry* _pntr_tiled_cache_find(pntr_tiled_cache* cache, const char* path, bool tileset, uint32_t transparentColor, uint64_t contentHash) {
+    pntr_tiled_cache_entry* entry = cache->entries;
+    while (entry) {
+        if ((entry->tileset != NULL) == tileset && entry->transparentColor == transparentColor &&
+            (contentHash == 0 || entry->contentHash == contentHash) && PNTR_STRCMP(entry->path, path) == 0) {
+            entry->references++;
+            return entry;
+        }
+        entry = entry->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Adds the image or tileset to the cache, unless another thread added the same one first. Entries loaded before their
+ * file changed stay for the maps still using them, behind the new one. The cache must be locked.
+ *
+ * @return The entry to use, or NULL if it could not be added.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_cache_entry* _pntr_tiled_cache_add(pntr_tiled_cache* cache, const char* path, uint32_t transparentColor, uint64_t contentHash, pntr_image* image, cute_tiled_tileset_t* tileset) {
+    pntr_tiled_cache_entry* entry = _pntr_tiled_cache_find(cache, path, tileset != NULL, transparentColor, contentHash);
+    if (entry != NULL) {
+        return entry;
+    }
+
+    size_t pathLength = PNTR_STRLEN(path);
+    entry = (pntr_tiled_cache_entry*)pntr_load_memory(sizeof(pntr_tiled_cache_entry));
+    char* pathCopy = (char*)pntr_load_memory(pathLength + 1);
+    if (entry == NULL || pathCopy == NULL) {
+        pntr_unload_memory(entry);
+        pntr_unload_memory(pathCopy);
+        return NULL;
+    }
+
+    pntr_memory_copy(pathCopy, (void*)path, pathLength + 1);
+    entry->path = pathCopy;
+    entry->transparentColor = transparentColor;
+    entry->image = image;
+    entry->tileset = tileset;
+    entry->source = NULL;
+    entry->contentHash = contentHash;
+    entry->references = 1;
+    entry->next = cache->entries;
+    cache->entries = entry;
+    return entry;
+}
+
+/**
+ * Releases a reference to the given cached image, or cached tileset's internal data.
+ *
+ * @return True if it was found in the cache, false otherwise.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_cache_release(pntr_tiled_cache* cache, const void* item) {
+    _pntr_tiled_cache_lock(cache);
+    pntr_tiled_cache_entry** link = &cache->entries;
+    while (*link) {
+        pntr_tiled_cache_entry* entry = *link;
+        if ((const void*)entry->image == item || (entry->tileset != NULL && entry->tileset->_internal == item)) {
+            if (--entry->references <= 0) {
+                *link = entry->next;
+                _pntr_tiled_unload_cache_entry(entry);
+            }
+            _pntr_tiled_cache_unlock(cache);
+            return true;
+        }
+        link = &entry->next;
+    }
+
+    _pntr_tiled_cache_unlock(cache);
+    return false;
+}
+
+/**
+ * Loads an image through the io, with the given transparent color cleared, through the cache when there is one.
+ *
+ * @param current Only take a cached image that was loaded from the file as it is now, rather than any from its path.
+ * @param contentHash Where to store the _pntr_tiled_content_hash() of the file the image came from, or NULL.
+ *
+ * @internal
+ * @private
+ */
+static pntr_image* _pntr_tiled_load_image(const pntr_tiled_io* io, const char* fileName, uint32_t transparentColor, pntr_tiled_cache* cache, bool current, uint64_t* contentHash) {
+    if (cache != NULL && !current) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_find(cache, fileName, false, transparentColor, 0);
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL) {
+            if (contentHash != NULL) {
+                *contentHash = entry->contentHash;
+            }
+            return entry->image;
+        }
+    }
+
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, fileName, false, &file)) {
+        return NULL;
+    }
+    uint64_t hash = _pntr_tiled_content_hash(file.data, file.size);
+    if (contentHash != NULL) {
+        *contentHash = hash;
+    }
+
+    if (cache != NULL && current) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_find(cache, fileName, false, transparentColor, hash);
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL) {
+            _pntr_tiled_close_file(&file);
+            return entry->image;
+        }
+    }
+
+    // Decode without holding the lock, so other images can load at the same time.
+    pntr_image* image = pntr_load_image_from_memory(pntr_get_file_image_type(fileName), file.data, file.size);
+    _pntr_tiled_close_file(&file);
+    if (image == NULL) {
+        return NULL;
+    }
+
+    if (transparentColor != 0) {
+        pntr_image_color_replace(image, pntr_tiled_color(transparentColor), PNTR_BLANK);
+    }
+
+    if (cache != NULL) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_add(cache, fileName, transparentColor, hash, image, NULL);
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL && entry->image != image) {
+            pntr_unload_image(image);
+            image = entry->image;
+        }
+    }
+
+    return image;
+}
+
+/**
+ * Unloads an image, or releases it back to the cache it came from.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_image(pntr_image* image, pntr_tiled_cache* cache) {
+    if (image == NULL) {
+        return;
+    }
+
+    if (cache == NULL || !_pntr_tiled_cache_release(cache, image)) {
+        pntr_unload_image(image);
+    }
+}
+
+/**
+ * Identifies an image by its full path and transparent color, so a reload can tell whether it changed.
+ *
+ * @internal
+ * @private
+ */
+static uint64_t _pntr_tiled_image_hash(const char* baseDir, const char* path, uint32_t transparentColor) {
+    uint64_t hash = _pntr_tiled_hash(14695981039346656037ULL, (const unsigned char*)baseDir, PNTR_STRLEN(baseDir));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)path, PNTR_STRLEN(path));
+    return _pntr_tiled_hash(hash, (const unsigned char*)&transparentColor, sizeof(transparentColor));
+}
+
+// What each row of a tile atlas is padded to, in bytes, such as the size of a cache line.
+#ifndef PNTR_TILED_ATLAS_ROW_ALIGNMENT
+    #define PNTR_TILED_ATLAS_ROW_ALIGNMENT 64
+#endif
+
+/**
+ * A tile being packed into the atlas.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_atlas_entry {
+    pntr_tiled_tile* tile;
+    pntr_image source; // Where the tile's pixels are, before packing.
+    pntr_image* loaded; // The image of a collection of images tile, to unload once packed.
+    int x;
+    int y;
+} pntr_tiled_atlas_entry;
+
+/**
+ * Marks the tile with the given gid as used, along with the frames of its animation.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_mark_tile(pntr_tiled_map_data* data, int gid, bool* used) {
+    pntr_tiled_tile* tile = _pntr_tiled_find_tile(data, cute_tiled_unset_flags(gid));
+    if (tile == NULL) {
+        return;
+    }
+
+    used[tile - data->tiles] = true;
+    cute_tiled_tile_descriptor_t* descriptor = tile->descriptor;
+    if (descriptor == NULL) {
+        return;
+    }
+
+    // Frames are within the same tileset.
+    for (int i = 0; i < descriptor->frame_count; i++) {
+        int frameIndex = descriptor->animation[i].tileid;
+        if (frameIndex >= 0 && frameIndex < tile->tileset->tilecount) {
+            used[tile - data->tiles - descriptor->tile_index + frameIndex] = true;
+        }
+    }
+}
+
+/**
+ * Marks the tiles that the given layers, and the layers within their groups, use.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_mark_layer_tiles(pntr_tiled_map_data* data, cute_tiled_layer_t* layer, bool* used) {
+    while (layer) {
+        if (PNTR_STRCMP(layer->type.ptr, "tilelayer") == 0) {
+            for (int i = 0; i < layer->data_count; i++) {
+                _pntr_tiled_mark_tile(data, layer->data[i], used);
+            }
+
+            cute_tiled_chunk_t* chunk = layer->chunks;
+            while (chunk) {
+                for (int i = 0; i < chunk->data_count; i++) {
+                    _pntr_tiled_mark_tile(data, chunk->data[i], used);
+                }
+                chunk = chunk->next;
+            }
+        }
+        else if (PNTR_STRCMP(layer->type.ptr, "objectgroup") == 0) {
+            cute_tiled_object_t* object = layer->objects;
+            while (object) {
+                if (object->gid != 0) {
+                    _pntr_tiled_mark_tile(data, object->gid, used);
+                }
+                object = object->next;
+            }
+        }
+        else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
+            _pntr_tiled_mark_layer_tiles(data, layer->layers, used);
+        }
+        layer = layer->next;
+    }
+}
+
+/**
+ * Orders atlas entries from the tallest to the shortest, so that each shelf wastes little height.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_atlas_entries(const void* a, const void* b) {
+    const pntr_tiled_atlas_entry* entryA = (const pntr_tiled_atlas_entry*)a;
+    const pntr_tiled_atlas_entry* entryB = (const pntr_tiled_atlas_entry*)b;
+    if (entryA->source.height != entryB->source.height) {
+        return entryB->source.height - entryA->source.height;
+    }
+    if (entryA->source.width != entryB->source.width) {
+        return entryB->source.width - entryA->source.width;
+    }
+
+    // Keep the table order otherwise, so that neighbouring tiles stay close.
+    return (entryA->tile > entryB->tile) - (entryA->tile < entryB->tile);
+}
+
+/**
+ * Packs the tiles that the map uses into a single atlas on shelves, points the tile table into it, and unloads the
+ * tileset images.
+ *
+ * @param baseDir The base directory that collection of images tiles are loaded from.
+ * @param error Where to report images that fail to load, or NULL to print them.
+ * @return True if the atlas was built, false if the tiles were left as they were.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_build_atlas(pntr_tiled_map_data* data, cute_tiled_map_t* map, const char* baseDir, pntr_tiled_error* error) {
+    if (data->tileCount <= 0) {
+        return false;
+    }
+
+    bool* used = (bool*)pntr_load_memory(sizeof(bool) * (size_t)data->tileCount);
+    if (used == NULL) {
+        return false;
+    }
+    PNTR_MEMSET(used, 0, sizeof(bool) * (size_t)data->tileCount);
+    _pntr_tiled_mark_layer_tiles(data, map->layers, used);
+
+    int count = 0;
+    for (int i = 0; i < data->tileCount; i++) {
+        count += used[i] ? 1 : 0;
+    }
+
+    pntr_tiled_atlas_entry* entries = count > 0 ? (pntr_tiled_atlas_entry*)pntr_load_memory(sizeof(pntr_tiled_atlas_entry) * (size_t)count) : NULL;
+    if (entries == NULL) {
+        pntr_unload_memory(used);
+        return false;
+    }
+
+    // Find the pixels of each used tile, loading the images of collection of images tiles.
+    int entryCount = 0;
+    for (int i = 0; i < data->tileCount; i++) {
+        if (!used[i]) {
+            continue;
+        }
+
+        pntr_tiled_tile* tile = data->tiles + i;
+        pntr_tiled_atlas_entry* entry = entries + entryCount;
+        entry->tile = tile;
+        entry->source = tile->image;
+        entry->loaded = NULL;
+        if (tile->image.data == NULL && tile->descriptor != NULL && tile->descriptor->image.ptr != NULL) {
+            char fullPath[PNTR_PATH_MAX];
+            fullPath[0] = '\0';
+            PNTR_STRCAT(fullPath, baseDir);
+            PNTR_STRCAT(fullPath, tile->descriptor->image.ptr);
+            entry->loaded = _pntr_tiled_load_image(&data->io, fullPath, tile->tileset->transparentcolor, data->cache, false, NULL);
+            if (entry->loaded == NULL) {
+                _pntr_tiled_report(error, fullPath, 0, "Failed to load image");
+            }
+            else {
+                pntr_rectangle all = { 0, 0, entry->loaded->width, entry->loaded->height };
+                _pntr_tiled_view_image(&entry->source, entry->loaded, all);
+            }
+        }
+
+        if (entry->source.data != NULL) {
+            entryCount++;
+        }
+    }
+    pntr_unload_memory(used);
+
+    // Rows of the atlas are padded to the alignment, so its width is a multiple of that many pixels.
+    int alignment = PNTR_TILED_ATLAS_ROW_ALIGNMENT / (int)sizeof(pntr_color);
+    alignment = alignment > 0 ? alignment : 1;
+    size_t area = 0;
+    int width = alignment;
+    for (int i = 0; i < entryCount; i++) {
+        area += (size_t)entries[i].source.width * (size_t)entries[i].source.height;
+        while (width < entries[i].source.width) {
+            width += alignment;
+        }
+    }
+
+    // Aim for a square atlas.
+    while ((size_t)width * (size_t)width < area) {
+        width += alignment;
+    }
+
+    qsort(entries, (size_t)entryCount, sizeof(pntr_tiled_atlas_entry), _pntr_tiled_compare_atlas_entries);
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (int i = 0; i < entryCount; i++) {
+        if (x + entries[i].source.width > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        entries[i].x = x;
+        entries[i].y = y;
+        x += entries[i].source.width;
+        shelfHeight = shelfHeight > entries[i].source.height ? shelfHeight : entries[i].source.height;
+    }
+
+    pntr_image* atlas = entryCount > 0 ? pntr_gen_image_color(width, y + shelfHeight, PNTR_BLANK) : NULL;
+    if (atlas != NULL) {
+        for (int i = 0; i < entryCount; i++) {
+            pntr_image* source = &entries[i].source;
+            for (int row = 0; row < source->height; row++) {
+                pntr_memory_copy(
+                    (unsigned char*)atlas->data + (size_t)(entries[i].y + row) * (size_t)atlas->pitch + sizeof(pntr_color) * (size_t)entries[i].x,
+                    (unsigned char*)source->data + (size_t)row * (size_t)source->pitch,
+                    sizeof(pntr_color) * (size_t)source->width);
+            }
+        }
+
+        // Only the packed tiles have images, as the tileset images are going away.
+        for (int i = 0; i < data->tileCount; i++) {
+            PNTR_MEMSET((void*)&data->tiles[i].image, 0, sizeof(pntr_image));
+        }
+        for (int i = 0; i < entryCount; i++) {
+            pntr_rectangle rect = { entries[i].x, entries[i].y, entries[i].source.width, entries[i].source.height };
+            _pntr_tiled_view_image(&entries[i].tile->image, atlas, rect);
+        }
+
+        cute_tiled_tileset_t* tileset = map->tilesets;
+        while (tileset) {
+            _pntr_tiled_unload_image((pntr_image*)tileset->image.ptr, data->cache);
+            tileset->image.ptr = NULL;
+            tileset = tileset->next;
+        }
+        data->atlas = atlas;
+    }
+
+    for (int i = 0; i < entryCount; i++) {
+        _pntr_tiled_unload_image(entries[i].loaded, data->cache);
+    }
+    pntr_unload_memory(entries);
+
+    return atlas != NULL;
+}
+
+static void _pntr_tiled_loading_report(pntr_tiled_loading* loading, const char* fileName, int line, const char* reason);
+
+/**
+ * Replaces the "image" with pntr_image.
+ *
+ * @param image The string image to replace.
+ * @param baseDir The base directory where the map file was loaded.
+ * @param transparentColor The color to make transparent, or 0 to leave the image as is.
+ * @param io Where to read the image from.
+ * @param cache The cache to share the image through, or NULL.
+ * @param loading The load to report a missing image to, or NULL to print it.
+ * @param contentHash Where to store the _pntr_tiled_content_hash() of the file the image came from, or NULL.
+ */
+static void _pntr_load_tiled_string_texture(cute_tiled_string_t* image, const char* baseDir, uint32_t transparentColor, const pntr_tiled_io* io, pntr_tiled_cache* cache, pntr_tiled_loading* loading, uint64_t* contentHash) {
+    if (image == NULL || image->ptr == NULL) {
+        return;
+    }
+
+    // TODO: Allow loading images from a base64 embedded image: https://github.com/RobLoach/TiledExportExtensions
+    // Concatenate the baseDir with the image path.
+    char fullPath[PNTR_PATH_MAX];
+    fullPath[0] = '\0';
+    PNTR_STRCAT(fullPath, baseDir);
+    PNTR_STRCAT(fullPath, image->ptr);
+
+    // Replace the image string with a pointer to the new image.
+    image->ptr = (const char*)_pntr_tiled_load_image(io, fullPath, transparentColor, cache, false, contentHash);
+    if (image->ptr == NULL) {
+        _pntr_tiled_loading_report(loading, fullPath, 0, "Failed to load image");
+    }
+}
+
+static void _pntr_load_tiled_layer_images(cute_tiled_layer_t* layer, const char* baseDir, const pntr_tiled_io* io) {
+    if (layer == NULL) {
+        return;
+    }
+
+    if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+        _pntr_load_tiled_string_texture(&layer->image, baseDir, 0, io, NULL, NULL, NULL);
+    }
+    else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
+        cute_tiled_layer_t* childLayers = layer->layers;
+        while (childLayers) {
+            _pntr_load_tiled_layer_images(childLayers, baseDir, io);
+            childLayers = childLayers->next;
+        }
+    }
+}
+
+/**
+ * Parses the given external tileset file, through the cache when there is one.
+ *
+ * When sources is given, the tileset is parsed in place, and its file data is added to sources, or kept by the cache.
+ *
+ * @param current Only take a cached tileset that was parsed from the file as it is now, rather than any from its path.
+ * @param parseError Where to put why the file failed to parse, or NULL to have cute_tiled print it.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_tileset_t* _pntr_tiled_load_external_tileset(const char* fileName, const pntr_tiled_io* io, pntr_tiled_cache* cache, pntr_tiled_memory* memory, pntr_tiled_source** sources, bool current, cute_tiled_error_t* parseError) {
+    if (cache != NULL && !current) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_find(cache, fileName, true, 0, 0);
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL) {
+            return entry->tileset;
+        }
+    }
+
+    // Parsing in place writes to the file data, so it is hashed first.
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, fileName, sources != NULL, &file)) {
+        return NULL;
+    }
+    uint64_t contentHash = _pntr_tiled_content_hash(file.data, file.size);
+
+    if (cache != NULL && current) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_find(cache, fileName, true, 0, contentHash);
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL) {
+            _pntr_tiled_close_file(&file);
+            return entry->tileset;
+        }
+    }
+
+    // Cached tilesets outlive the map, so they cannot use its memory.
+    void* tilesetMemory = cache != NULL ? NULL : memory;
+    cute_tiled_load_options_t parseOptions;
+    PNTR_MEMSET(&parseOptions, 0, sizeof(parseOptions));
+    parseOptions.in_place = sources != NULL;
+    parseOptions.error = parseError;
+    pntr_tiled_source* source = NULL;
+    cute_tiled_tileset_t* tileset;
+    if (sources != NULL) {
+        source = (pntr_tiled_source*)pntr_load_memory(sizeof(pntr_tiled_source));
+        if (source == NULL) {
+            _pntr_tiled_close_file(&file);
+            return NULL;
+        }
+        source->file = file;
+        source->next = NULL;
+        tileset = cute_tiled_load_external_tileset_from_memory_ex((void*)file.data, (int)file.size, &parseOptions, tilesetMemory);
+        if (tileset == NULL) {
+            _pntr_tiled_unload_sources(source);
+            return NULL;
+        }
+    }
+    else {
+        tileset = cute_tiled_load_external_tileset_from_memory_ex((void*)file.data, (int)file.size, &parseOptions, tilesetMemory);
+        _pntr_tiled_close_file(&file);
+        if (tileset == NULL) {
+            return NULL;
+        }
+    }
+
+    if (cache != NULL) {
+        _pntr_tiled_cache_lock(cache);
+        pntr_tiled_cache_entry* entry = _pntr_tiled_cache_add(cache, fileName, 0, contentHash, NULL, tileset);
+        if (entry != NULL && entry->tileset == tileset) {
+            entry->source = source;
+            source = NULL;
+        }
+        _pntr_tiled_cache_unlock(cache);
+        if (entry != NULL && entry->tileset != tileset) {
+            cute_tiled_free_external_tileset(tileset);
+            _pntr_tiled_unload_sources(source);
+            return entry->tileset;
+        }
+    }
+
+    if (source != NULL) {
+        source->next = *sources;
+        *sources = source;
+    }
+
+    return tileset;
+}
+
+// this grabs external tilesets and injects them as if they are internal
+static void _pntr_tiled_load_external_tilesets(cute_tiled_tileset_t* tileset, const char* baseDir, const pntr_tiled_io* io, pntr_tiled_cache* cache, pntr_tiled_memory* memory, pntr_tiled_source** sources, bool current, cute_tiled_error_t* parseError) {
+    if (tileset->source.ptr != NULL) {
+        char fullPath[PNTR_PATH_MAX];
+        fullPath[0] = '\0';
+        PNTR_STRCAT(fullPath, baseDir);
+        PNTR_STRCAT(fullPath, tileset->source.ptr);
+
+        int originalFirstgid = tileset->firstgid;
+        cute_tiled_tileset_t* originalNext = tileset->next;
+        cute_tiled_string_t originalSource = tileset->source;
+
+        // The map shares the external tileset's data, which is freed by _pntr_tiled_unload_external_tilesets().
+        cute_tiled_tileset_t* tt = _pntr_tiled_load_external_tileset(fullPath, io, cache, memory, sources, current, parseError);
+        if (tt != NULL) {
+            pntr_memory_copy((void*)tileset, (void*)tt, sizeof(cute_tiled_tileset_t));
+            tileset->firstgid = originalFirstgid;
+            tileset->next = originalNext;
+            tileset->source = originalSource;
+        }
+    }
+}
+
+/**
+ * Frees an external tileset injected into the map, or releases it back to the cache it came from.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_external_tileset(cute_tiled_tileset_t* tileset, pntr_tiled_cache* cache) {
+    if (tileset->_internal == NULL) {
+        return;
+    }
+
+    if (cache == NULL || !_pntr_tiled_cache_release(cache, tileset->_internal)) {
+        cute_tiled_free_external_tileset(tileset);
+    }
+
+    // The map no longer owns any of the tileset's data.
+    tileset->_internal = NULL;
+    tileset->properties = NULL;
+    tileset->property_count = 0;
+    tileset->tiles = NULL;
+}
+
+/**
+ * Frees the external tilesets injected into the map, or releases them back to the cache they came from.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_external_tilesets(cute_tiled_map_t* map, pntr_tiled_cache* cache) {
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        _pntr_tiled_unload_external_tileset(tileset, cache);
+        tileset = tileset->next;
+    }
+}
+
+/**
+ * Parses the map, and injects any external tilesets, without loading any images.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_map_t* _pntr_tiled_parse(const unsigned char *fileData, unsigned int dataSize, const char* baseDir, const pntr_tiled_io* io) {
+    cute_tiled_map_t* map = cute_tiled_load_map_from_memory(fileData, (int)dataSize, 0);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    // Load all the tileset externaal tilesets.
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        _pntr_tiled_load_external_tilesets(tileset, baseDir, io, NULL, NULL, NULL, false, NULL);
+        tileset = tileset->next;
+    }
+
+    return map;
+}
+
+/**
+ * A tileset or image layer to load, which is independent of all the others.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_load_job {
+    cute_tiled_tileset_t* tileset;
+    cute_tiled_layer_t* layer;
+    pntr_tiled_source* sources;
+    bool imageLoaded; // Whether the image path has been replaced with the loaded image.
+    uint64_t imageHash; // The _pntr_tiled_image_hash() of the image path.
+    uint64_t contentHash; // The _pntr_tiled_content_hash() of the image file, once loaded.
+} pntr_tiled_load_job;
+
+/**
+ * A map going through the load stages, either on its own thread, or step by step.
+ *
+ * @internal
+ * @private
+ */
+struct pntr_tiled_loading {
+    pntr_tiled_load_options options;
+    pntr_tiled_load_stage stage;
+    bool cancelled;
+    char fileName[PNTR_PATH_MAX];
+    char baseDir[PNTR_PATH_MAX];
+    pntr_tiled_io io;
+    pntr_tiled_file file; // The map file, or just its data when it was given to the load.
+    bool ownsFile; // Whether the file was opened by the load, rather than given to it.
+    pntr_tiled_memory* memory;
+    cute_tiled_map_t* map;
+    pntr_tiled_source* sources; // The file data the map's strings point into, when parsed in place.
+
+    // The jobs of the current stage, shared between the loading threads. Tilesets come first.
+    pntr_tiled_load_job* jobs;
+    int tilesetCount;
+    int totalJobCount;
+    int jobCount;
+    int nextJob;
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    bool threaded; // Whether the stages run on their own thread, from pntr_load_tiled_async().
+#endif
+};
+
+/**
+ * Collects the image layers within the given layers. When jobs is NULL, only counts them.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_collect_image_layers(cute_tiled_layer_t* layer, pntr_tiled_load_job* jobs, int count) {
+    while (layer) {
+        if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+            if (jobs != NULL) {
+                jobs[count].tileset = NULL;
+                jobs[count].layer = layer;
+            }
+            count++;
+        }
+        else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
+            count = _pntr_tiled_collect_image_layers(layer->layers, jobs, count);
+        }
+        layer = layer->next;
+    }
+
+    return count;
+}
+
+static void _pntr_tiled_loading_lock(pntr_tiled_loading* loading) {
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_lock(&loading->mutex);
+#else
+    PNTR_UNUSED(loading);
+#endif
+}
+
+static void _pntr_tiled_loading_unlock(pntr_tiled_loading* loading) {
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_unlock(&loading->mutex);
+#else
+    PNTR_UNUSED(loading);
+#endif
+}
+
+/**
+ * Reports a problem to the error of the given load, from any of its threads, or prints it when loading is NULL.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_loading_report(pntr_tiled_loading* loading, const char* fileName, int line, const char* reason) {
+    if (loading == NULL) {
+        _pntr_tiled_report(NULL, fileName, line, reason);
+        return;
+    }
+
+    _pntr_tiled_loading_lock(loading);
+    _pntr_tiled_report(loading->options.error, fileName, line, reason);
+    _pntr_tiled_loading_unlock(loading);
+}
+
+/**
+ * Takes jobs of the current stage until there are none left, or the load is cancelled. Each job only writes to its
+ * own tileset or layer, so the result does not depend on which thread ran it.
+ *
+ * @internal
+ * @private
+ */
+static void* _pntr_tiled_run_load_jobs(void* data) {
+    pntr_tiled_loading* loading = (pntr_tiled_loading*)data;
+    const pntr_tiled_load_options* options = &loading->options;
+    for (;;) {
+        _pntr_tiled_loading_lock(loading);
+        int index = loading->cancelled ? loading->jobCount : loading->nextJob++;
+        _pntr_tiled_loading_unlock(loading);
+        if (index >= loading->jobCount) {
+            return NULL;
+        }
+
+        pntr_tiled_load_job* job = loading->jobs + index;
+        if (loading->stage == PNTR_TILED_LOAD_TILESETS) {
+            cute_tiled_error_t parseError;
+            parseError.reason = NULL;
+            _pntr_tiled_load_external_tilesets(job->tileset, loading->baseDir, &loading->io, options->cache, loading->memory, options->inPlace ? &job->sources : NULL, false, &parseError);
+            if (job->tileset->source.ptr != NULL && job->tileset->_internal == NULL) {
+                if (parseError.reason != NULL) {
+                    _pntr_tiled_loading_report(loading, job->tileset->source.ptr, parseError.line, parseError.reason);
+                }
+                else {
+                    _pntr_tiled_loading_report(loading, job->tileset->source.ptr, 0, "Failed to load external tileset");
+                }
+            }
+        }
+        else if (job->tileset != NULL) {
+            cute_tiled_tileset_t* tileset = job->tileset;
+            if (tileset->image.ptr != NULL) {
+                job->imageHash = _pntr_tiled_image_hash(loading->baseDir, tileset->image.ptr, tileset->transparentcolor);
+            }
+
+            if (options->noImages) {
+                tileset->image.ptr = NULL;
+                job->imageLoaded = true;
+            }
+            else if (!options->lazyImages || options->atlas) {
+                _pntr_load_tiled_string_texture(&tileset->image, loading->baseDir, tileset->transparentcolor, &loading->io, options->cache, loading, &job->contentHash);
+                job->imageLoaded = true;
+            }
+        }
+        else {
+            if (job->layer->image.ptr != NULL) {
+                job->imageHash = _pntr_tiled_image_hash(loading->baseDir, job->layer->image.ptr, 0);
+            }
+
+            if (options->noImages) {
+                job->layer->image.ptr = NULL;
+            }
+            else {
+                _pntr_load_tiled_string_texture(&job->layer->image, loading->baseDir, 0, &loading->io, options->cache, loading, &job->contentHash);
+            }
+            job->imageLoaded = true;
+        }
+    }
+}
+
+/**
+ * Runs the first jobCount jobs for the current stage, across threads when asked to.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_run_load_stage(pntr_tiled_loading* loading, int jobCount) {
+    _pntr_tiled_loading_lock(loading);
+    loading->jobCount = jobCount;
+    loading->nextJob = 0;
+    _pntr_tiled_loading_unlock(loading);
+
+#ifdef PNTR_TILED_THREADS
+    int threadCount = loading->options.threadCount < jobCount ? loading->options.threadCount : jobCount;
+    if (threadCount > 1) {
+        // The calling thread works through the jobs too, so the stage finishes even if no threads could start.
+        pthread_t* threads = (pthread_t*)pntr_load_memory(sizeof(pthread_t) * (size_t)(threadCount - 1));
+        int started = 0;
+        while (threads != NULL && started < threadCount - 1 && pthread_create(threads + started, NULL, _pntr_tiled_run_load_jobs, loading) == 0) {
+            started++;
+        }
+
+        _pntr_tiled_run_load_jobs(loading);
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+
+        pntr_unload_memory(threads);
+        return;
+    }
+#endif
+
+    _pntr_tiled_run_load_jobs(loading);
+}
+
+/**
+ * Collects the file data kept by each job into the load's sources.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_collect_sources(pntr_tiled_loading* loading) {
+    for (int i = 0; i < loading->totalJobCount; i++) {
+        while (loading->jobs[i].sources) {
+            pntr_tiled_source* source = loading->jobs[i].sources;
+            loading->jobs[i].sources = source->next;
+            source->next = loading->sources;
+            loading->sources = source;
+        }
+    }
+}
+
+/**
+ * Takes the image paths out of the map's tilesets, so that their images load on first use.
+ *
+ * The lazy tilesets and their full paths are allocated together, and freed along with the map data.
+ *
+ * @return The lazy tilesets, or NULL if there are none, or on failure.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_lazy_tileset* _pntr_tiled_defer_tileset_images(cute_tiled_map_t* map, const char* baseDir, pntr_tiled_memory* memory, int* count) {
+    size_t baseDirLength = PNTR_STRLEN(baseDir);
+    size_t size = 0;
+    *count = 0;
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->image.ptr != NULL) {
+            size += sizeof(pntr_tiled_lazy_tileset) + baseDirLength + PNTR_STRLEN(tileset->image.ptr) + 1;
+            (*count)++;
+        }
+        tileset = tileset->next;
+    }
+
+    if (*count == 0) {
+        return NULL;
+    }
+
+    pntr_tiled_lazy_tileset* lazy = (pntr_tiled_lazy_tileset*)_pntr_tiled_alloc(memory, size);
+    if (lazy == NULL) {
+        *count = 0;
+        return NULL;
+    }
+
+    char* path = (char*)(lazy + *count);
+    int index = 0;
+    tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->image.ptr != NULL) {
+            size_t length = PNTR_STRLEN(tileset->image.ptr);
+            pntr_memory_copy(path, (void*)baseDir, baseDirLength);
+            pntr_memory_copy(path + baseDirLength, (void*)tileset->image.ptr, length + 1);
+            lazy[index].tileset = tileset;
+            lazy[index].path = path;
+            path += baseDirLength + length + 1;
+            index++;
+
+            // Nothing is loaded until the image is needed.
+            tileset->image.ptr = NULL;
+        }
+        tileset = tileset->next;
+    }
+
+    return lazy;
+}
+
+/**
+ * Passes the layer filter of the load options through to cute_tiled.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_layer_filter(const char* name, const char* type, void* userData) {
+    const pntr_tiled_load_options* options = (const pntr_tiled_load_options*)userData;
+    return options->layerFilter(name, type, options->layerFilterUserData) ? 1 : 0;
+}
+
+static void _pntr_tiled_unload_map(cute_tiled_map_t* map, pntr_tiled_cache* cache, pntr_tiled_memory* memory, pntr_tiled_source* sources, cute_tiled_map_t* generations);
+
+/**
+ * Prepares to load the given file, or the given file data when fileName is NULL.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_load_begin(pntr_tiled_loading* loading, const char* fileName, const unsigned char* fileData, unsigned int dataSize, const char* baseDir, const pntr_tiled_load_options* options) {
+    PNTR_MEMSET(loading, 0, sizeof(pntr_tiled_loading));
+    if (options != NULL) {
+        loading->options = *options;
+    }
+
+    if (loading->options.error != NULL) {
+        PNTR_MEMSET(loading->options.error, 0, sizeof(pntr_tiled_error));
+    }
+
+    loading->io = loading->options.io != NULL ? *loading->options.io : pntr_tiled_io_files(loading->options.mapped);
+
+    if (fileName != NULL) {
+        size_t fileNameLength = PNTR_STRLEN(fileName);
+        if (fileNameLength >= PNTR_PATH_MAX) {
+            return false;
+        }
+
+        // Copy the fileName, along with its null terminator to find the basePath.
+        pntr_memory_copy((void*)loading->fileName, (void*)fileName, fileNameLength + 1);
+        pntr_memory_copy((void*)loading->baseDir, (void*)fileName, fileNameLength + 1);
+        _pntr_tiled_path_basedir(loading->baseDir);
+        loading->stage = PNTR_TILED_LOAD_READ;
+    }
+    else {
+        size_t baseDirLength = baseDir != NULL ? PNTR_STRLEN(baseDir) : 0;
+        if (fileData == NULL || baseDirLength >= PNTR_PATH_MAX) {
+            return false;
+        }
+
+        if (baseDirLength > 0) {
+            pntr_memory_copy((void*)loading->baseDir, (void*)baseDir, baseDirLength + 1);
+        }
+        loading->file.data = (unsigned char*)fileData;
+        loading->file.size = dataSize;
+        loading->stage = PNTR_TILED_LOAD_PARSE;
+    }
+
+#ifdef PNTR_TILED_THREADS
+    if (pthread_mutex_init(&loading->mutex, NULL) != 0) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * Parses the map, and sets up the jobs for its tilesets and image layers.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_load_parse(pntr_tiled_loading* loading) {
+    const pntr_tiled_load_options* options = &loading->options;
+    if (options->allocator != NULL || options->arena) {
+        // The parsed map takes several times the size of its JSON, mostly in the string pool and parse pages. Guess
+        // high, so that the map fits in a single block. Pages of the block that are never touched cost nothing.
+        loading->memory = _pntr_tiled_load_memory(options->allocator, options->arena, (size_t)loading->file.size * 12 + 64 * 1024);
+        if (loading->memory == NULL) {
+            return false;
+        }
+    }
+
+    // Only parsing in place writes to the file data.
+    cute_tiled_load_options_t parseOptions;
+    PNTR_MEMSET(&parseOptions, 0, sizeof(parseOptions));
+    parseOptions.in_place = options->inPlace;
+    if (options->layerFilter != NULL) {
+        parseOptions.layer_filter = _pntr_tiled_layer_filter;
+        parseOptions.layer_filter_udata = (void*)options;
+    }
+
+    cute_tiled_error_t parseError;
+    parseOptions.error = &parseError;
+    loading->map = cute_tiled_load_map_from_memory_ex((void*)loading->file.data, (int)loading->file.size, &parseOptions, loading->memory);
+    if (loading->map == NULL) {
+        // cute_tiled leaves it to be reported here, as it was given somewhere to put it.
+        _pntr_tiled_report(options->error, loading->fileName[0] != '\0' ? loading->fileName : "memory", parseError.line, parseError.reason);
+        return false;
+    }
+
+    if (loading->ownsFile) {
+        if (options->inPlace) {
+            // Maps parsed in place keep their file data, as their strings point into it.
+            pntr_tiled_source* source = (pntr_tiled_source*)pntr_load_memory(sizeof(pntr_tiled_source));
+            if (source == NULL) {
+                return false;
+            }
+            source->file = loading->file;
+            source->next = loading->sources;
+            loading->sources = source;
+        }
+        else {
+            _pntr_tiled_close_file(&loading->file);
+        }
+        loading->file.data = NULL;
+        loading->ownsFile = false;
+    }
+
+    // Tilesets first, then image layers, in the same order as they appear in the map.
+    cute_tiled_tileset_t* tileset = loading->map->tilesets;
+    while (tileset) {
+        loading->tilesetCount++;
+        tileset = tileset->next;
+    }
+
+    loading->totalJobCount = loading->tilesetCount + _pntr_tiled_collect_image_layers(loading->map->layers, NULL, 0);
+    if (loading->totalJobCount == 0) {
+        return true;
+    }
+
+    loading->jobs = (pntr_tiled_load_job*)pntr_load_memory(sizeof(pntr_tiled_load_job) * (size_t)loading->totalJobCount);
+    if (loading->jobs == NULL) {
+        return false;
+    }
+    PNTR_MEMSET(loading->jobs, 0, sizeof(pntr_tiled_load_job) * (size_t)loading->totalJobCount);
+
+    int index = 0;
+    tileset = loading->map->tilesets;
+    while (tileset) {
+        loading->jobs[index].tileset = tileset;
+        loading->jobs[index].layer = NULL;
+        index++;
+        tileset = tileset->next;
+    }
+    _pntr_tiled_collect_image_layers(loading->map->layers, loading->jobs, index);
+
+    return true;
+}
+
+static void _pntr_tiled_index_object_layers(cute_tiled_map_t* map, cute_tiled_layer_t* layers);
+
+/**
+ * Builds the tile table, and hands everything the load holds over to the map.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_load_tile_table(pntr_tiled_loading* loading) {
+    cute_tiled_map_t* map = loading->map;
+    int lazyCount = 0;
+    pntr_tiled_lazy_tileset* lazy = NULL;
+    if (loading->options.lazyImages && !loading->options.atlas) {
+        lazy = _pntr_tiled_defer_tileset_images(map, loading->baseDir, loading->memory, &lazyCount);
+    }
+
+    // Remember where each image came from, for pntr_tiled_reload().
+    pntr_tiled_image_source* images = NULL;
+    if (loading->totalJobCount > 0) {
+        images = (pntr_tiled_image_source*)_pntr_tiled_alloc(loading->memory, sizeof(pntr_tiled_image_source) * (size_t)loading->totalJobCount);
+        if (images == NULL) {
+            _pntr_tiled_free(loading->memory, lazy);
+            return false;
+        }
+
+        for (int i = 0; i < loading->totalJobCount; i++) {
+            pntr_tiled_load_job* job = loading->jobs + i;
+            images[i].image = job->tileset != NULL ? &job->tileset->image : &job->layer->image;
+            images[i].hash = job->imageHash;
+            images[i].contentHash = job->imageLoaded && images[i].image->ptr != NULL ? job->contentHash : 0;
+        }
+    }
+
+    // Load the individual tiles as subimages, apart from those of lazy tilesets.
+    if (!_pntr_load_map_data(map, loading->memory, !loading->options.noTileTable)) {
+        _pntr_tiled_free(loading->memory, images);
+        _pntr_tiled_free(loading->memory, lazy);
+        return false;
+    }
+
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    data->cache = loading->options.cache;
+    data->sources = loading->sources;
+    data->lazy = lazy;
+    data->lazyCount = lazyCount;
+    data->images = images;
+    data->imageCount = loading->totalJobCount;
+    data->io = loading->io;
+    data->options = loading->options;
+    data->options.error = NULL;
+    data->options.io = NULL;
+    data->options.allocator = NULL;
+    loading->sources = NULL;
+    loading->memory = NULL;
+
+    // The tiles stay within their tileset images when the atlas cannot be built.
+    if (loading->options.atlas && !loading->options.noImages) {
+        _pntr_tiled_build_atlas(data, map, loading->baseDir, loading->options.error);
+    }
+
+    // Layers whose index cannot be built are drawn and searched without one.
+    if (loading->options.indexObjects) {
+        data->indexObjects = true;
+        _pntr_tiled_index_object_layers(map, map->layers);
+    }
+
+    return true;
+}
+
+/**
+ * Runs the current stage of the load, and moves on to the next one.
+ *
+ * @return True if there are more stages to run.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_load_step(pntr_tiled_loading* loading) {
+    _pntr_tiled_loading_lock(loading);
+    pntr_tiled_load_stage stage = loading->stage;
+    if (loading->cancelled && stage < PNTR_TILED_LOAD_DONE) {
+        stage = loading->stage = PNTR_TILED_LOAD_FAILED;
+    }
+    _pntr_tiled_loading_unlock(loading);
+
+    bool success = true;
+    switch (stage) {
+        case PNTR_TILED_LOAD_READ:
+            // Parsing in place writes to the file data.
+            loading->ownsFile = _pntr_tiled_open_file(&loading->io, loading->fileName, loading->options.inPlace, &loading->file);
+            success = loading->ownsFile;
+            if (!success && loading->options.error != NULL) {
+                _pntr_tiled_report(loading->options.error, loading->fileName, 0, "Failed to read the map file");
+            }
+            break;
+        case PNTR_TILED_LOAD_PARSE:
+            success = _pntr_tiled_load_parse(loading);
+            break;
+        case PNTR_TILED_LOAD_TILESETS:
+            _pntr_tiled_run_load_stage(loading, loading->tilesetCount);
+            _pntr_tiled_collect_sources(loading);
+            break;
+        case PNTR_TILED_LOAD_IMAGES:
+            _pntr_tiled_run_load_stage(loading, loading->totalJobCount);
+            break;
+        case PNTR_TILED_LOAD_TILE_TABLE:
+            success = _pntr_tiled_load_tile_table(loading);
+            break;
+        default:
+            return false;
+    }
+
+    _pntr_tiled_loading_lock(loading);
+    loading->stage = success ? (pntr_tiled_load_stage)(stage + 1) : PNTR_TILED_LOAD_FAILED;
+    loading->nextJob = 0;
+    stage = loading->stage;
+    _pntr_tiled_loading_unlock(loading);
+
+    return stage < PNTR_TILED_LOAD_DONE;
+}
+
+/**
+ * Finishes the load, freeing anything it loaded unless the whole map made it.
+ *
+ * @return The loaded map, or NULL if the load failed or was cancelled.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_map_t* _pntr_tiled_load_end(pntr_tiled_loading* loading) {
+    cute_tiled_map_t* map = loading->map;
+    if (loading->stage != PNTR_TILED_LOAD_DONE) {
+        if (loading->options.error != NULL) {
+            _pntr_tiled_report(loading->options.error, loading->fileName[0] != '\0' ? loading->fileName : "memory", 0, loading->cancelled ? "The load was cancelled" : "Failed to load the map");
+        }
+
+        if (map != NULL) {
+            // Images that were never loaded are still paths.
+            for (int i = 0; i < loading->totalJobCount; i++) {
+                pntr_tiled_load_job* job = loading->jobs + i;
+                if (!job->imageLoaded) {
+                    if (job->tileset != NULL) {
+                        job->tileset->image.ptr = NULL;
+                    }
+                    else {
+                        job->layer->image.ptr = NULL;
+                    }
+                }
+            }
+
+            _pntr_tiled_collect_sources(loading);
+            _pntr_tiled_unload_map(map, loading->options.cache, loading->memory, loading->sources, NULL);
+        }
+        else {
+            _pntr_tiled_unload_memory(loading->memory);
+            _pntr_tiled_unload_sources(loading->sources);
+        }
+        map = NULL;
+    }
+
+    if (loading->ownsFile) {
+        _pntr_tiled_close_file(&loading->file);
+    }
+    pntr_unload_memory(loading->jobs);
+#ifdef PNTR_TILED_THREADS
+    pthread_mutex_destroy(&loading->mutex);
+#endif
+
+    return map;
+}
+
+/**
+ * Runs all of the load stages on the calling thread.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_map_t* _pntr_tiled_load(const char* fileName, const unsigned char* fileData, unsigned int dataSize, const char* baseDir, const pntr_tiled_load_options* options) {
+    pntr_tiled_loading loading;
+    if (!_pntr_tiled_load_begin(&loading, fileName, fileData, dataSize, baseDir, options)) {
+        return NULL;
+    }
+
+    while (_pntr_tiled_load_step(&loading)) {}
+    return _pntr_tiled_load_end(&loading);
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_ex(const char* fileName, const pntr_tiled_load_options* options) {
+    if (fileName == NULL) {
+        return NULL;
+    }
+
+    return _pntr_tiled_load(fileName, NULL, 0, NULL, options);
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled(const char* fileName) {
+    return pntr_load_tiled_ex(fileName, NULL);
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_mapped(const char* fileName) {
+    pntr_tiled_load_options options;
+    PNTR_MEMSET(&options, 0, sizeof(options));
+    options.mapped = true;
+    return pntr_load_tiled_ex(fileName, &options);
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_memory(const unsigned char *fileData, unsigned int dataSize, const char* baseDir) {
+    return _pntr_tiled_load(NULL, fileData, dataSize, baseDir, NULL);
+}
+
+#ifdef PNTR_TILED_THREADS
+static void* _pntr_tiled_load_thread(void* data) {
+    while (_pntr_tiled_load_step((pntr_tiled_loading*)data)) {}
+    return NULL;
+}
+#endif
+
+/**
+ * Whether the load runs on its own thread, rather than a stage at a time when polled.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_loading_threaded(pntr_tiled_loading* loading) {
+#ifdef PNTR_TILED_THREADS
+    return loading->threaded;
+#else
+    PNTR_UNUSED(loading);
+    return false;
+#endif
+}
+
+PNTR_TILED_API pntr_tiled_loading* pntr_load_tiled_async(const char* fileName, const pntr_tiled_load_options* options) {
+    if (fileName == NULL) {
+        return NULL;
+    }
+
+    pntr_tiled_loading* loading = (pntr_tiled_loading*)pntr_load_memory(sizeof(pntr_tiled_loading));
+    if (loading == NULL) {
+        return NULL;
+    }
+
+    if (!_pntr_tiled_load_begin(loading, fileName, NULL, 0, NULL, options)) {
+        pntr_unload_memory(loading);
+        return NULL;
+    }
+
+#ifdef PNTR_TILED_THREADS
+    loading->threaded = pthread_create(&loading->thread, NULL, _pntr_tiled_load_thread, loading) == 0;
+#endif
+
+    return loading;
+}
+
+PNTR_TILED_API pntr_tiled_load_stage pntr_tiled_load_poll(pntr_tiled_loading* loading, float* progress) {
+    if (loading == NULL) {
+        if (progress != NULL) {
+            *progress = 0.0f;
+        }
+        return PNTR_TILED_LOAD_FAILED;
+    }
+
+    if (!_pntr_tiled_loading_threaded(loading)) {
+        _pntr_tiled_load_step(loading);
+    }
+
+    _pntr_tiled_loading_lock(loading);
+    pntr_tiled_load_stage stage = loading->stage;
+    float stageProgress = 0.0f;
+    if ((stage == PNTR_TILED_LOAD_TILESETS || stage == PNTR_TILED_LOAD_IMAGES) && loading->jobCount > 0) {
+        int started = loading->nextJob < loading->jobCount ? loading->nextJob : loading->jobCount;
+        stageProgress = (float)started / (float)loading->jobCount;
+    }
+    _pntr_tiled_loading_unlock(loading);
+
+    if (progress != NULL) {
+        *progress = stage >= PNTR_TILED_LOAD_DONE ? 1.0f : ((float)stage + stageProgress) / (float)PNTR_TILED_LOAD_DONE;
+    }
+
+    return stage;
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_tiled_load_wait(pntr_tiled_loading* loading) {
+    if (loading == NULL) {
+        return NULL;
+    }
+
+    if (_pntr_tiled_loading_threaded(loading)) {
+#ifdef PNTR_TILED_THREADS
+        pthread_join(loading->thread, NULL);
+#endif
+    }
+    else {
+        while (_pntr_tiled_load_step(loading)) {}
+    }
+
+    cute_tiled_map_t* map = _pntr_tiled_load_end(loading);
+    pntr_unload_memory(loading);
+    return map;
+}
+
+PNTR_TILED_API void pntr_tiled_load_cancel(pntr_tiled_loading* loading) {
+    if (loading == NULL) {
+        return;
+    }
+
+    _pntr_tiled_loading_lock(loading);
+    loading->cancelled = true;
+    _pntr_tiled_loading_unlock(loading);
+
+    // Whatever made it through is unloaded along with the load.
+    pntr_unload_tiled(pntr_tiled_load_wait(loading));
+}
+
+static void _pntr_unload_tiled_layer_images(cute_tiled_layer_t* layer, pntr_tiled_cache* cache) {
+    if (layer == NULL) {
+        return;
+    }
+
+    if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+        _pntr_tiled_unload_image((pntr_image*)layer->image.ptr, cache);
+        layer->image.ptr = NULL;
+    }
+    else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
+        cute_tiled_layer_t* childLayers = layer->layers;
+        while (childLayers) {
+            _pntr_unload_tiled_layer_images(childLayers, cache);
+            childLayers = childLayers->next;
+        }
+    }
+}
+
+/**
+ * Unloads the tileset and image layer images of the map.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_map_images(cute_tiled_map_t* map, pntr_tiled_cache* cache) {
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        _pntr_tiled_unload_image((pntr_image*)tileset->image.ptr, cache);
+        tileset->image.ptr = NULL;
+        tileset = tileset->next;
+    }
+
+    // Unload all the internal raylib data.
+    cute_tiled_layer_t* layer = map->layers;
+    while (layer) {
+        _pntr_unload_tiled_layer_images(layer, cache);
+        layer = layer->next;
+    }
+}
+
+/**
+ * Unloads a parsed map, along with everything it took from the cache, its memory, and the file data it points into.
+ *
+ * @param generations Earlier parses of the map, kept by pntr_tiled_reload() as its layers and objects live in them.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_map(cute_tiled_map_t* map, pntr_tiled_cache* cache, pntr_tiled_memory* memory, pntr_tiled_source* sources, cute_tiled_map_t* generations) {
+    _pntr_tiled_unload_map_images(map, cache);
+    _pntr_tiled_unload_external_tilesets(map, cache);
+
+    // Everything else in an arena goes at once.
+    if (memory == NULL || !memory->arena) {
+        cute_tiled_free_map(map);
+
+        // Reloads only leave each generation its pages and strings to free.
+        while (generations) {
+            cute_tiled_map_t* next = (cute_tiled_map_t*)generations->tiledversion.ptr;
+            cute_tiled_free_map(generations);
+            generations = next;
+        }
+    }
+    _pntr_tiled_unload_memory(memory);
+
+    // The strings of maps parsed in place are within their files.
+    _pntr_tiled_unload_sources(sources);
+}
+
+/**
+ * Frees the chunks of a prerendered layer, without touching the layer itself.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_layer_cache(pntr_tiled_layer_cache* cache) {
+    for (int i = 0; i < cache->columns * cache->rows; i++) {
+        pntr_unload_image(cache->chunks[i].image);
+        pntr_unload_memory(cache->chunks[i].frames);
+    }
+    pntr_unload_memory(cache);
+}
+
+/**
+ * Frees the chunks of all the map's prerendered layers.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_layer_caches(pntr_tiled_map_data* data) {
+    while (data->layerCaches) {
+        pntr_tiled_layer_cache* next = data->layerCaches->next;
+        _pntr_tiled_unload_layer_cache(data->layerCaches);
+        data->layerCaches = next;
+    }
+}
+
+/**
+ * Frees the grid of an indexed object layer.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_object_index(pntr_tiled_object_index* index) {
+    if (index->cells != NULL) {
+        for (int i = 0; i <= index->columns * index->rows; i++) {
+            if (index->cells[i].allocated) {
+                pntr_unload_memory(index->cells[i].entries);
+            }
+        }
+    }
+    pntr_unload_memory(index->cells);
+    pntr_unload_memory(index->found);
+    pntr_unload_memory(index);
+}
+
+/**
+ * Frees the grids of all the map's indexed object layers.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_object_indexes(pntr_tiled_map_data* data) {
+    while (data->objectIndexes) {
+        pntr_tiled_object_index* next = data->objectIndexes->next;
+        _pntr_tiled_unload_object_index(data->objectIndexes);
+        data->objectIndexes = next;
+    }
+}
+
+/**
+ * Frees the images of all the map's rasterized shape objects.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_unload_shapes(pntr_tiled_shape_cache* shapes) {
+    while (shapes->newest) {
+        pntr_tiled_shape* older = shapes->newest->older;
+        pntr_unload_image(shapes->newest->image);
+        pntr_unload_memory(shapes->newest);
+        shapes->newest = older;
+    }
+    pntr_unload_memory(shapes->buckets);
+    PNTR_MEMSET(shapes, 0, sizeof(pntr_tiled_shape_cache));
+}
+
+PNTR_TILED_API void pntr_unload_tiled(cute_tiled_map_t* map) {
+    if (map == NULL) {
+        return;
+    }
+
+    // Baked maps live entirely within the baked file's memory.
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    if (data == NULL) {
+        _pntr_tiled_unload_map(map, NULL, NULL, NULL, NULL);
+        return;
+    }
+    _pntr_tiled_unload_layer_caches(data);
+    _pntr_tiled_unload_object_indexes(data);
+    _pntr_tiled_unload_shapes(&data->shapes);
+    if (data->baked != NULL) {
+        _pntr_tiled_unload_map_images(map, NULL);
+        pntr_unload_file(data->baked);
+        return;
+    }
+
+    // Unload the internal tiles.
+    pntr_tiled_cache* cache = data->cache;
+    pntr_tiled_memory* memory = data->memory;
+    pntr_tiled_source* sources = data->sources;
+    cute_tiled_map_t* generations = data->generations;
+    pntr_unload_image(data->atlas);
+    _pntr_tiled_free(memory, (void*)data->images);
+    _pntr_tiled_free(memory, (void*)data->lazy);
+    _pntr_tiled_free(memory, (void*)data);
+
+    _pntr_tiled_unload_map(map, cache, memory, sources, generations);
+}
+
+/**
+ * An old layer or object of a pntr_tiled_reload(), sorted by id to match the fresh ones against.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_reload_match {
+    int id;
+    int order; // Where it was among the old ones, so that of any sharing an id, the first is matched first.
+    void* item; // The old layer or object, or NULL once it has been matched.
+} pntr_tiled_reload_match;
+
+/**
+ * The state of a pntr_tiled_reload(), as it matches the fresh parse of the map to what the map already has.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_reloading {
+    pntr_tiled_map_data* data;
+    const char* baseDir;
+    pntr_tiled_error* error; // Where to report what failed to load, or NULL to print it.
+    pntr_tiled_image_source* images; // Where the reloaded images came from, replacing data->images once done.
+    int imageCount;
+    pntr_tiled_reload_match* matches; // Room for the old layers of each level being matched, and the objects of one layer.
+    int matchCount; // How many of the matches are taken by the levels being matched.
+} pntr_tiled_reloading;
+
+/**
+ * Counts the layers, along with those within their groups, and the most objects in any one of them, to know how many
+ * matches a reload of them takes.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_count_reload_matches(cute_tiled_layer_t* layer, int* layerCount, int* objectCount) {
+    while (layer) {
+        int objects = 0;
+        cute_tiled_object_t* object = layer->objects;
+        while (object) {
+            objects++;
+            object = object->next;
+        }
+
+        (*layerCount)++;
+        *objectCount = objects > *objectCount ? objects : *objectCount;
+        _pntr_tiled_count_reload_matches(layer->layers, layerCount, objectCount);
+        layer = layer->next;
+    }
+}
+
+/**
+ * Orders the matches of a reload by id, and then by where they were among the old ones.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_reload_matches(const void* a, const void* b) {
+    const pntr_tiled_reload_match* matchA = (const pntr_tiled_reload_match*)a;
+    const pntr_tiled_reload_match* matchB = (const pntr_tiled_reload_match*)b;
+    if (matchA->id != matchB->id) {
+        return (matchA->id > matchB->id) - (matchA->id < matchB->id);
+    }
+    return (matchA->order > matchB->order) - (matchA->order < matchB->order);
+}
+
+/**
+ * Takes the first old layer or object with the given id that has not been matched yet.
+ *
+ * @return The old layer or object, or NULL if there is none.
+ *
+ * @internal
+ * @private
+ */
+static void* _pntr_tiled_take_reload_match(pntr_tiled_reload_match* matches, int count, int id) {
+    if (id == 0) {
+        return NULL;
+    }
+
+    int low = 0;
+    int high = count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (matches[middle].id < id) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    for (; low < count && matches[low].id == id; low++) {
+        if (matches[low].item != NULL) {
+            void* item = matches[low].item;
+            matches[low].item = NULL;
+            return item;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Finds where the given tileset or image layer image was loaded from.
+ *
+ * @return Where the image came from, or NULL if it is not known.
+ *
+ * @internal
+ * @private
+ */
+static const pntr_tiled_image_source* _pntr_tiled_find_image_source(pntr_tiled_map_data* data, const cute_tiled_string_t* image) {
+    for (int i = 0; i < data->imageCount; i++) {
+        if (data->images[i].image == image) {
+            return data->images + i;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Joins the directory of the reloaded map with the given image path.
+ *
+ * @return The full path, or NULL if there is no image, or the path is too long.
+ *
+ * @internal
+ * @private
+ */
+static const char* _pntr_tiled_reload_path(pntr_tiled_reloading* reload, const char* image, char* fullPath) {
+    if (image == NULL) {
+        return NULL;
+    }
+
+    size_t baseDirLength = PNTR_STRLEN(reload->baseDir);
+    size_t length = PNTR_STRLEN(image);
+    if (baseDirLength + length >= PNTR_PATH_MAX) {
+        return NULL;
+    }
+
+    pntr_memory_copy((void*)fullPath, (void*)reload->baseDir, baseDirLength);
+    pntr_memory_copy((void*)(fullPath + baseDirLength), (void*)image, length + 1);
+    return fullPath;
+}
+
+/**
+ * Records where the image of a reloaded tileset or image layer comes from. The previous image is taken when it came
+ * from the same path, and the file has not changed since, or the image is loaded otherwise.
+ *
+ * @param path The full path of the image, or NULL if it has none.
+ * @param previous The previous image, to take or unload, or NULL.
+ * @param previousSource Where the previous image came from, or NULL.
+ * @param lazy Leave the image for its lazy tileset to load on first use, unless the previous one is taken.
+ * @return Whether the image was taken or loaded.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_reload_image(pntr_tiled_reloading* reload, cute_tiled_string_t* image, const char* path, pntr_image* previous, const pntr_tiled_image_source* previousSource, uint32_t transparentColor, bool lazy) {
+    pntr_tiled_map_data* data = reload->data;
+    pntr_tiled_image_source* source = reload->images + reload->imageCount++;
+    source->image = image;
+    source->hash = path != NULL ? _pntr_tiled_image_hash("", path, transparentColor) : 0;
+    source->contentHash = 0;
+    image->ptr = NULL;
+
+    if (previous != NULL && previousSource != NULL && source->hash != 0 && source->hash == previousSource->hash) {
+        uint64_t contentHash = _pntr_tiled_file_hash(&data->io, path);
+        if (contentHash != 0 && contentHash == previousSource->contentHash) {
+            image->ptr = (const char*)previous;
+            source->contentHash = contentHash;
+            return true;
+        }
+    }
+
+    _pntr_tiled_unload_image(previous, data->cache);
+    if (path == NULL || lazy || data->options.noImages) {
+        return false;
+    }
+
+    // Cached images from before the file changed are passed over.
+    image->ptr = (const char*)_pntr_tiled_load_image(&data->io, path, transparentColor, data->cache, true, &source->contentHash);
+    if (image->ptr == NULL) {
+        source->contentHash = 0;
+        _pntr_tiled_report(reload->error, path, 0, "Failed to load image");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Matches the fresh objects to the old ones by id. Each match is overwritten with the fresh object, so that pointers
+ * to it stay valid, and the old objects left without a match are freed.
+ *
+ * @return The reloaded objects, in the fresh order.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_object_t* _pntr_tiled_reload_objects(pntr_tiled_reloading* reload, cute_tiled_object_t* objects, cute_tiled_object_t* fresh) {
+    pntr_tiled_memory* memory = reload->data->memory;
+    pntr_tiled_reload_match* matches = reload->matches + reload->matchCount;
+    int count = 0;
+    while (objects) {
+        matches[count].id = objects->id;
+        matches[count].order = count;
+        matches[count].item = objects;
+        count++;
+        objects = objects->next;
+    }
+    qsort(matches, (size_t)count, sizeof(pntr_tiled_reload_match), _pntr_tiled_compare_reload_matches);
+
+    cute_tiled_object_t* head = NULL;
+    cute_tiled_object_t** tail = &head;
+    while (fresh) {
+        cute_tiled_object_t* next = fresh->next;
+        cute_tiled_object_t* object = (cute_tiled_object_t*)_pntr_tiled_take_reload_match(matches, count, fresh->id);
+        if (object != NULL) {
+            object->next = NULL;
+            cute_tiled_free_objects(object, memory);
+            *object = *fresh;
+        }
+        else {
+            object = fresh;
+        }
+
+        object->next = NULL;
+        *tail = object;
+        tail = &object->next;
+        fresh = next;
+    }
+
+    // The old objects left over were removed from the layer.
+    for (int i = 0; i < count; i++) {
+        cute_tiled_object_t* object = (cute_tiled_object_t*)matches[i].item;
+        if (object != NULL) {
+            object->next = NULL;
+            cute_tiled_free_objects(object, memory);
+        }
+    }
+
+    return head;
+}
+
+/**
+ * Matches the fresh layers to the old ones by id, like _pntr_tiled_reload_objects(), along with their child layers,
+ * objects and images.
+ *
+ * @return The reloaded layers, in the fresh order.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_layer_t* _pntr_tiled_reload_layers(pntr_tiled_reloading* reload, cute_tiled_layer_t* layers, cute_tiled_layer_t* fresh) {
+    pntr_tiled_map_data* data = reload->data;
+    pntr_tiled_reload_match* matches = reload->matches + reload->matchCount;
+    int count = 0;
+    while (layers) {
+        matches[count].id = layers->id;
+        matches[count].order = count;
+        matches[count].item = layers;
+        count++;
+        layers = layers->next;
+    }
+    qsort(matches, (size_t)count, sizeof(pntr_tiled_reload_match), _pntr_tiled_compare_reload_matches);
+
+    // The child layers and objects take their matches after these.
+    reload->matchCount += count;
+
+    cute_tiled_layer_t* head = NULL;
+    cute_tiled_layer_t** tail = &head;
+    while (fresh) {
+        cute_tiled_layer_t* next = fresh->next;
+        cute_tiled_layer_t* layer = (cute_tiled_layer_t*)_pntr_tiled_take_reload_match(matches, count, fresh->id);
+        cute_tiled_layer_t* children = NULL;
+        cute_tiled_object_t* objects = NULL;
+        pntr_image* image = NULL;
+        const pntr_tiled_image_source* imageSource = NULL;
+        if (layer != NULL) {
+            children = layer->layers;
+            objects = layer->objects;
+            if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+                image = (pntr_image*)layer->image.ptr;
+                imageSource = _pntr_tiled_find_image_source(data, &layer->image);
+            }
+
+            // Free the old tile data and properties, leaving the children and objects to be matched.
+            layer->layers = NULL;
+            layer->objects = NULL;
+            layer->next = NULL;
+            cute_tiled_free_layers(layer, data->memory);
+            *layer = *fresh;
+        }
+        else {
+            layer = fresh;
+        }
+
+        layer->layers = _pntr_tiled_reload_layers(reload, children, fresh->layers);
+        layer->objects = _pntr_tiled_reload_objects(reload, objects, fresh->objects);
+        if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+            char fullPath[PNTR_PATH_MAX];
+            const char* path = _pntr_tiled_reload_path(reload, layer->image.ptr, fullPath);
+            _pntr_tiled_reload_image(reload, &layer->image, path, image, imageSource, 0, false);
+        }
+        else {
+            _pntr_tiled_unload_image(image, data->cache);
+        }
+
+        layer->next = NULL;
+        *tail = layer;
+        tail = &layer->next;
+        fresh = next;
+    }
+
+    // The old layers left over were removed from the map.
+    for (int i = 0; i < count; i++) {
+        cute_tiled_layer_t* layer = (cute_tiled_layer_t*)matches[i].item;
+        if (layer != NULL) {
+            layer->next = NULL;
+            _pntr_unload_tiled_layer_images(layer, data->cache);
+            cute_tiled_free_layers(layer, data->memory);
+        }
+    }
+    reload->matchCount -= count;
+
+    return head;
+}
+
+/**
+ * Whether the given layer is one of the layers, or within one of their groups.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_has_layer(cute_tiled_layer_t* layers, cute_tiled_layer_t* layer) {
+    while (layers) {
+        if (layers == layer || _pntr_tiled_has_layer(layers->layers, layer)) {
+            return true;
+        }
+        layers = layers->next;
+    }
+
+    return false;
+}
+
+/**
+ * Whether the fresh tilesets cover the same tiles, from the same images, as the map's tilesets.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_same_tilesets(pntr_tiled_reloading* reload, cute_tiled_tileset_t* tileset, cute_tiled_tileset_t* fresh) {
+    while (tileset && fresh) {
+        char fullPath[PNTR_PATH_MAX];
+        const char* path = _pntr_tiled_reload_path(reload, fresh->image.ptr, fullPath);
+        const pntr_tiled_image_source* source = _pntr_tiled_find_image_source(reload->data, &tileset->image);
+        if (tileset->firstgid != fresh->firstgid || tileset->tilecount != fresh->tilecount || tileset->columns != fresh->columns ||
+            tileset->tilewidth != fresh->tilewidth || tileset->tileheight != fresh->tileheight ||
+            tileset->margin != fresh->margin || tileset->spacing != fresh->spacing || path == NULL || source == NULL ||
+            source->hash != _pntr_tiled_image_hash("", path, fresh->transparentcolor)) {
+            return false;
+        }
+
+        // The tiles were cut from the image as it was, so they go when its file changed.
+        if (source->contentHash != 0 && source->contentHash != _pntr_tiled_file_hash(&reload->data->io, path)) {
+            return false;
+        }
+
+        tileset = tileset->next;
+        fresh = fresh->next;
+    }
+
+    return tileset == NULL && fresh == NULL;
+}
+
+/**
+ * Copies the fresh tilesets over the map's matching ones, keeping their images and tile subimages.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_reload_tilesets(pntr_tiled_reloading* reload, cute_tiled_tileset_t* tileset, cute_tiled_tileset_t* fresh) {
+    pntr_tiled_map_data* data = reload->data;
+    while (tileset && fresh) {
+        cute_tiled_string_t image = tileset->image;
+        cute_tiled_tileset_t* next = tileset->next;
+        reload->images[reload->imageCount] = *_pntr_tiled_find_image_source(data, &tileset->image);
+        reload->imageCount++;
+
+        _pntr_tiled_unload_external_tileset(tileset, data->cache);
+        cute_tiled_free_tileset(tileset, data->memory);
+        *tileset = *fresh;
+        tileset->image = image;
+        tileset->next = next;
+
+        // The tile descriptors moved along with the tileset, while the tile images stay.
+        int count;
+        pntr_tiled_tile* tiles = _pntr_tiled_tileset_tiles(data, tileset, &count);
+        if (tiles != NULL) {
+            _pntr_tiled_init_tiles(tiles, tileset, count);
+        }
+
+        tileset = next;
+        fresh = fresh->next;
+    }
+}
+
+/**
+ * Replaces the map's tilesets with the fresh ones, taking any of the old images whose file is still the same.
+ *
+ * @param lazy The fresh tilesets whose paths were taken to load their images on first use, in the same order.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_swap_tilesets(pntr_tiled_reloading* reload, cute_tiled_map_t* map, cute_tiled_tileset_t* fresh, pntr_tiled_lazy_tileset* lazy, int lazyCount) {
+    pntr_tiled_map_data* data = reload->data;
+    int lazyIndex = 0;
+    cute_tiled_tileset_t* tileset = fresh;
+    while (tileset) {
+        char fullPath[PNTR_PATH_MAX];
+        pntr_tiled_lazy_tileset* deferred = lazyIndex < lazyCount && lazy[lazyIndex].tileset == tileset ? lazy + lazyIndex++ : NULL;
+        const char* path = deferred != NULL ? deferred->path : _pntr_tiled_reload_path(reload, tileset->image.ptr, fullPath);
+
+        // An old image from the same path is taken, should its file not have changed.
+        pntr_image* image = NULL;
+        const pntr_tiled_image_source* imageSource = NULL;
+        if (path != NULL) {
+            uint64_t hash = _pntr_tiled_image_hash("", path, tileset->transparentcolor);
+            cute_tiled_tileset_t* old = map->tilesets;
+            while (old && imageSource == NULL) {
+                const pntr_tiled_image_source* source = old->image.ptr != NULL ? _pntr_tiled_find_image_source(data, &old->image) : NULL;
+                if (source != NULL && source->hash == hash) {
+                    image = (pntr_image*)old->image.ptr;
+                    imageSource = source;
+                    old->image.ptr = NULL;
+                }
+                old = old->next;
+            }
+        }
+
+        if (_pntr_tiled_reload_image(reload, &tileset->image, path, image, imageSource, tileset->transparentcolor, deferred != NULL) && deferred != NULL) {
+            deferred->path = NULL;
+        }
+        tileset = tileset->next;
+    }
+
+    tileset = map->tilesets;
+    while (tileset) {
+        _pntr_tiled_unload_image((pntr_image*)tileset->image.ptr, data->cache);
+        _pntr_tiled_unload_external_tileset(tileset, data->cache);
+        cute_tiled_free_tileset(tileset, data->memory);
+        tileset = tileset->next;
+    }
+
+    map->tilesets = fresh;
+}
+
+/**
+ * Whether any of the layers, or their objects and child layers, live within the pages of the given parse.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_generation_has_layers(cute_tiled_map_t* generation, cute_tiled_layer_t* layer) {
+    while (layer) {
+        if (cute_tiled_map_owns(generation, layer) || _pntr_tiled_generation_has_layers(generation, layer->layers)) {
+            return true;
+        }
+
+        cute_tiled_object_t* object = layer->objects;
+        while (object) {
+            if (cute_tiled_map_owns(generation, object)) {
+                return true;
+            }
+            object = object->next;
+        }
+        layer = layer->next;
+    }
+
+    return false;
+}
+
+/**
+ * Frees the earlier parses of a reloaded map that none of its layers, objects or tilesets live in any more. The newest
+ * stays, as the map's strings come from it.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_free_generations(pntr_tiled_map_data* data, cute_tiled_map_t* map) {
+    // Everything in an arena goes at once.
+    if (data->generations == NULL || (data->memory != NULL && data->memory->arena)) {
+        return;
+    }
+
+    const char** link = &data->generations->tiledversion.ptr;
+    while (*link != NULL) {
+        cute_tiled_map_t* generation = (cute_tiled_map_t*)*link;
+        bool used = _pntr_tiled_generation_has_layers(generation, map->layers);
+        cute_tiled_tileset_t* tileset = map->tilesets;
+        while (tileset && !used) {
+            used = cute_tiled_map_owns(generation, tileset) != 0;
+            tileset = tileset->next;
+        }
+
+        if (used) {
+            link = &generation->tiledversion.ptr;
+        }
+        else {
+            *link = generation->tiledversion.ptr;
+            cute_tiled_free_map(generation);
+        }
+    }
+}
+
+PNTR_TILED_API bool pntr_tiled_reload(cute_tiled_map_t* map, const char* fileName, pntr_tiled_error* error) {
+    if (error != NULL) {
+        PNTR_MEMSET(error, 0, sizeof(pntr_tiled_error));
+    }
+
+    if (map == NULL || fileName == NULL || map->tiledversion.ptr == NULL) {
+        return false;
+    }
+
+    // Baked maps cannot grow.
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    if (data->baked != NULL) {
+        if (error != NULL) {
+            _pntr_tiled_report(error, fileName, 0, "Baked maps cannot be reloaded");
+        }
+        return false;
+    }
+
+    size_t fileNameLength = PNTR_STRLEN(fileName);
+    if (fileNameLength >= PNTR_PATH_MAX) {
+        if (error != NULL) {
+            _pntr_tiled_report(error, fileName, 0, "The path is too long");
+        }
+        return false;
+    }
+
+    char baseDir[PNTR_PATH_MAX];
+    pntr_memory_copy((void*)baseDir, (void*)fileName, fileNameLength + 1);
+    _pntr_tiled_path_basedir(baseDir);
+
+    // Parsing in place writes to the file data.
+    const pntr_tiled_load_options* options = &data->options;
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(&data->io, fileName, options->inPlace, &file)) {
+        if (error != NULL) {
+            _pntr_tiled_report(error, fileName, 0, "Failed to read the map file");
+        }
+        return false;
+    }
+
+    pntr_tiled_memory* memory = data->memory;
+    cute_tiled_load_options_t parseOptions;
+    PNTR_MEMSET(&parseOptions, 0, sizeof(parseOptions));
+    parseOptions.in_place = options->inPlace;
+    if (options->layerFilter != NULL) {
+        parseOptions.layer_filter = _pntr_tiled_layer_filter;
+        parseOptions.layer_filter_udata = (void*)options;
+    }
+    cute_tiled_error_t parseError;
+    parseOptions.error = &parseError;
+    cute_tiled_map_t* fresh = cute_tiled_load_map_from_memory_ex((void*)file.data, (int)file.size, &parseOptions, memory);
+    if (fresh == NULL) {
+        _pntr_tiled_report(error, fileName, parseError.line, parseError.reason);
+    }
+
+    // Strings parsed in place point into the file data, so it is kept, replacing the old file data once done.
+    pntr_tiled_source* sources = NULL;
+    if (fresh != NULL && options->inPlace) {
+        sources = (pntr_tiled_source*)pntr_load_memory(sizeof(pntr_tiled_source));
+        if (sources == NULL) {
+            if (memory == NULL || !memory->arena) {
+                cute_tiled_free_map(fresh);
+            }
+            fresh = NULL;
+        }
+        else {
+            sources->file = file;
+            sources->next = NULL;
+        }
+    }
+    if (sources == NULL) {
+        _pntr_tiled_close_file(&file);
+    }
+    if (fresh == NULL) {
+        return false;
+    }
+
+    // Cached external tilesets from before their file changed are passed over.
+    int imageCount = _pntr_tiled_collect_image_layers(fresh->layers, NULL, 0);
+    cute_tiled_tileset_t* tileset = fresh->tilesets;
+    while (tileset) {
+        parseError.reason = NULL;
+        _pntr_tiled_load_external_tilesets(tileset, baseDir, &data->io, data->cache, memory, options->inPlace ? &sources : NULL, true, &parseError);
+        if (tileset->source.ptr != NULL && tileset->_internal == NULL) {
+            if (parseError.reason != NULL) {
+                _pntr_tiled_report(error, tileset->source.ptr, parseError.line, parseError.reason);
+            }
+            else {
+                _pntr_tiled_report(error, tileset->source.ptr, 0, "Failed to load external tileset");
+            }
+        }
+        imageCount++;
+        tileset = tileset->next;
+    }
+
+    pntr_tiled_reloading reload;
+    reload.data = data;
+    reload.baseDir = baseDir;
+    reload.error = error;
+    reload.imageCount = 0;
+    reload.matchCount = 0;
+
+    // Atlases only hold the tiles that were used, so the tilesets are loaded again to pack the tiles used now.
+    bool atlas = options->atlas && !options->noImages;
+    bool sameTilesets = !atlas && _pntr_tiled_same_tilesets(&reload, map->tilesets, fresh->tilesets);
+
+    // Everything that could fail is allocated before the map is touched. Different tiles need a new tile table,
+    // unless the map was loaded without one.
+    int rangeCount = 0;
+    int tileCount = !options->noTileTable ? _pntr_tiled_tile_count(fresh, &rangeCount) : 0;
+    int layerMatches = 0;
+    int objectMatches = 0;
+    _pntr_tiled_count_reload_matches(map->layers, &layerMatches, &objectMatches);
+    pntr_tiled_map_data* tileData = NULL;
+    pntr_tiled_lazy_tileset* lazy = NULL;
+    int lazyCount = 0;
+    bool failed = false;
+    reload.images = (pntr_tiled_image_source*)_pntr_tiled_alloc(memory, sizeof(pntr_tiled_image_source) * (size_t)(imageCount > 0 ? imageCount : 1));
+    reload.matches = (pntr_tiled_reload_match*)pntr_load_memory(sizeof(pntr_tiled_reload_match) * (size_t)(layerMatches + objectMatches + 1));
+    if (reload.images == NULL || reload.matches == NULL) {
+        failed = true;
+    }
+    else if (!sameTilesets) {
+        tileData = (pntr_tiled_map_data*)_pntr_tiled_alloc(memory, _pntr_tiled_map_data_size(tileCount, rangeCount));
+        failed = tileData == NULL;
+
+        // Changed tilesets of lazy maps stay lazy, so their paths are taken before the old images are matched up.
+        if (!failed && options->lazyImages && !atlas && !options->noImages) {
+            lazy = _pntr_tiled_defer_tileset_images(fresh, baseDir, memory, &lazyCount);
+            for (tileset = fresh->tilesets; tileset != NULL && lazy == NULL; tileset = tileset->next) {
+                failed = failed || tileset->image.ptr != NULL;
+            }
+        }
+    }
+
+    if (failed) {
+        _pntr_tiled_free(memory, (void*)reload.images);
+        pntr_unload_memory(reload.matches);
+        _pntr_tiled_free(memory, (void*)tileData);
+        _pntr_tiled_unload_external_tilesets(fresh, data->cache);
+        if (memory == NULL || !memory->arena) {
+            cute_tiled_free_map(fresh);
+        }
+        _pntr_tiled_unload_sources(sources);
+        if (error != NULL) {
+            _pntr_tiled_report(error, fileName, 0, "Failed to reload the map");
+        }
+        return false;
+    }
+
+    if (sameTilesets) {
+        _pntr_tiled_reload_tilesets(&reload, map->tilesets, fresh->tilesets);
+    }
+    else {
+        _pntr_tiled_swap_tilesets(&reload, map, fresh->tilesets, lazy, lazyCount);
+        *tileData = *data;
+        tileData->lazy = lazy;
+        tileData->lazyCount = lazyCount;
+        tileData->atlas = NULL;
+        _pntr_tiled_build_tile_table(tileData, map, tileCount, rangeCount);
+    }
+    fresh->tilesets = NULL;
+
+    map->layers = _pntr_tiled_reload_layers(&reload, map->layers, fresh->layers);
+    fresh->layers = NULL;
+    pntr_unload_memory(reload.matches);
+
+    _pntr_tiled_free(memory, (void*)map->properties);
+    map->properties = fresh->properties;
+    map->property_count = fresh->property_count;
+    fresh->properties = NULL;
+    fresh->property_count = 0;
+
+    // The animation timer in nextlayerid, and the map data in tiledversion, stay as they are.
+    map->backgroundcolor = fresh->backgroundcolor;
+    map->class_ = fresh->class_;
+    map->width = fresh->width;
+    map->height = fresh->height;
+    map->infinite = fresh->infinite;
+    map->nextobjectid = fresh->nextobjectid;
+    map->orientation = fresh->orientation;
+    map->renderorder = fresh->renderorder;
+    map->tilewidth = fresh->tilewidth;
+    map->tileheight = fresh->tileheight;
+    map->type = fresh->type;
+    map->version = fresh->version;
+
+    if (tileData != NULL) {
+        if (atlas) {
+            _pntr_tiled_build_atlas(tileData, map, baseDir, error);
+        }
+        pntr_unload_image(data->atlas);
+    }
+
+    _pntr_tiled_free(memory, (void*)data->images);
+    if (tileData != NULL) {
+        _pntr_tiled_free(memory, (void*)data->lazy);
+        _pntr_tiled_free(memory, (void*)data);
+        data = tileData;
+        map->tiledversion.ptr = (const char*)data;
+    }
+    data->images = reload.images;
+    data->imageCount = reload.imageCount;
+
+    // Every string of the map now comes from the fresh parse, so the old file data can go.
+    _pntr_tiled_unload_sources(data->sources);
+    data->sources = sources;
+
+    // Matched layers and objects stay where they were, so earlier parses are kept for as long as any of them remain.
+    fresh->tiledversion.ptr = (const char*)data->generations;
+    data->generations = fresh;
+    _pntr_tiled_free_generations(data, map);
+
+    // Prerendered layers that are still in the map render again from their reloaded tiles.
+    pntr_tiled_layer_cache* caches = data->layerCaches;
+    data->layerCaches = NULL;
+    while (caches) {
+        pntr_tiled_layer_cache* next = caches->next;
+        cute_tiled_layer_t* layer = _pntr_tiled_has_layer(map->layers, caches->layer) ? caches->layer : NULL;
+        int chunkSize = caches->chunkSize;
+        _pntr_tiled_unload_layer_cache(caches);
+        if (layer != NULL) {
+            pntr_tiled_prerender_layer(map, layer, chunkSize);
+        }
+        caches = next;
+    }
+
+    // Indexed object layers that are still in the map are indexed again from their reloaded objects.
+    pntr_tiled_object_index* indexes = data->objectIndexes;
+    data->objectIndexes = NULL;
+    while (indexes) {
+        pntr_tiled_object_index* next = indexes->next;
+        cute_tiled_layer_t* layer = _pntr_tiled_has_layer(map->layers, indexes->layer) ? indexes->layer : NULL;
+        _pntr_tiled_unload_object_index(indexes);
+        if (layer != NULL && !data->indexObjects) {
+            pntr_tiled_index_objects(map, layer);
+        }
+        indexes = next;
+    }
+    if (data->indexObjects) {
+        _pntr_tiled_index_object_layers(map, map->layers);
+    }
+
+    return true;
+}
+
+#define PNTR_TILED_BAKED_MAGIC 0x4B425450 // "PTBK"
+#define PNTR_TILED_BAKED_VERSION 13
+
+/**
+ * The header at the start of a baked map file.
+ *
+ * Every pointer within a baked file is stored as an offset from the start of the file, and listed in the relocation
+ * table so that it can be fixed up after loading. Offset 0 is the header itself, so it stands in for NULL.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_baked_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layout;                // Structure sizes, to reject bakes from other architectures or builds.
+    uint32_t size;                  // The size of the entire baked file.
+    uint64_t sourceHash;            // Hash of the source map and its external tilesets.
+    uint32_t relocationsOffset;     // Array of offsets of each pointer within the file.
+    uint32_t relocationCount;
+    cute_tiled_map_t* map;
+    pntr_tiled_map_data* data;
+    pntr_rectangle* tileSources;    // Where each tile appears in its tileset image.
+} pntr_tiled_baked_header;
+
+/**
+ * Builds up a baked map file in memory.
+ *
+ * @internal
+ * @private
+ */
+typedef struct pntr_tiled_baker {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    uint32_t* relocations;
+    size_t relocationCount;
+    size_t relocationCapacity;
+    const void** keys;              // Hash table of what each source pointer was baked to.
+    size_t* offsets;
+    size_t tableCapacity;
+    size_t tableCount;
+    const char* baseDir;
+    bool failed;
+} pntr_tiled_baker;
+
+/**
+ * Layout signature of the structures that are baked, which differs between architectures and builds.
+ *
+ * @internal
+ * @private
+ */
+static uint32_t _pntr_tiled_baked_layout(void) {
+    return (uint32_t)(sizeof(void*) | sizeof(pntr_image) << 4 | sizeof(pntr_tiled_tile) << 12 | sizeof(cute_tiled_map_t) << 20)
+        ^ (uint32_t)(sizeof(cute_tiled_layer_t) | sizeof(cute_tiled_tileset_t) << 10 | sizeof(cute_tiled_object_t) << 20)
+        ^ (uint32_t)(sizeof(cute_tiled_tile_descriptor_t) << 3 | sizeof(cute_tiled_property_t) << 13 | sizeof(cute_tiled_chunk_t) << 23);
+}
+
+/**
+ * Hashes the source map file, along with any of its external tilesets, reading them through the io.
+ *
+ * @return True if all the files were found, false otherwise.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_source_hash(const pntr_tiled_io* io, const char* fileName, const char* baseDir, cute_tiled_map_t* map, uint64_t* hash) {
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, fileName, false, &file)) {
+        return false;
+    }
+
+    *hash = _pntr_tiled_hash(14695981039346656037ULL, file.data, file.size);
+    _pntr_tiled_close_file(&file);
+
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->source.ptr != NULL) {
+            size_t baseDirLength = PNTR_STRLEN(baseDir);
+            size_t length = PNTR_STRLEN(tileset->source.ptr);
+            if (baseDirLength + length >= PNTR_PATH_MAX) {
+                return false;
+            }
+
+            char fullPath[PNTR_PATH_MAX];
+            pntr_memory_copy((void*)fullPath, (void*)baseDir, baseDirLength);
+            pntr_memory_copy((void*)(fullPath + baseDirLength), (void*)tileset->source.ptr, length + 1);
+
+            if (!_pntr_tiled_open_file(io, fullPath, false, &file)) {
+                return false;
+            }
+            *hash = _pntr_tiled_hash(*hash, file.data, file.size);
+            _pntr_tiled_close_file(&file);
+        }
+        tileset = tileset->next;
+    }
+
+    return true;
+}
+
+/**
+ * Ensures the given array can hold the needed number of elements.
+ *
+ * @internal
+ * @private
+ */
+static void* _pntr_tiled_bake_grow(pntr_tiled_baker* baker, void* array, size_t elementSize, size_t count, size_t* capacity, size_t needed) {
+    if (needed <= *capacity) {
+        return array;
+    }
+
+    size_t newCapacity = *capacity > 0 ? *capacity : 1024;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+
+    void* output = pntr_load_memory(newCapacity * elementSize);
+    if (output == NULL) {
+        baker->failed = true;
+        return array;
+    }
+
+    if (array != NULL) {
+        pntr_memory_copy(output, array, count * elementSize);
+        pntr_unload_memory(array);
+    }
+
+    *capacity = newCapacity;
+    return output;
+}
+
+/**
+ * Appends the given data to the bake, aligned for any of the baked structures.
+ *
+ * @param source The data to copy in, or NULL to zero it.
+ *
+ * @return The offset of the data within the bake, or 0 on failure.
+ *
+ * @internal
+ * @private
+ */
+static size_t _pntr_tiled_bake_write(pntr_tiled_baker* baker, const void* source, size_t size) {
+    size_t offset = (baker->size + 7) & ~(size_t)7;
+    baker->data = (unsigned char*)_pntr_tiled_bake_grow(baker, baker->data, 1, baker->size, &baker->capacity, offset + size);
+    if (baker->failed || offset + size >= 0xFFFFFFFFU) {
+        baker->failed = true;
+        return 0;
+    }
+
+    PNTR_MEMSET(baker->data + baker->size, 0, offset - baker->size);
+    if (source != NULL) {
+        pntr_memory_copy(baker->data + offset, (void*)source, size);
+    }
+    else {
+        PNTR_MEMSET(baker->data + offset, 0, size);
+    }
+
+    baker->size = offset + size;
+    return offset;
+}
+
+/**
+ * Sets the pointer at the given offset to point to the target offset, and registers it for relocation.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_bake_pointer(pntr_tiled_baker* baker, size_t field, size_t target) {
+    if (baker->failed) {
+        return;
+    }
+
+    uintptr_t value = (uintptr_t)target;
+    pntr_memory_copy(baker->data + field, &value, sizeof(value));
+    if (target == 0) {
+        return;
+    }
+
+    baker->relocations = (uint32_t*)_pntr_tiled_bake_grow(baker, baker->relocations, sizeof(uint32_t), baker->relocationCount, &baker->relocationCapacity, baker->relocationCount + 1);
+    if (!baker->failed) {
+        baker->relocations[baker->relocationCount++] = (uint32_t)field;
+    }
+}
+
+/**
+ * Finds what the given source pointer was baked to.
+ *
+ * @return The offset within the bake, or 0 if it has not been baked.
+ *
+ * @internal
+ * @private
+ */
+static size_t _pntr_tiled_bake_find(pntr_tiled_baker* baker, const void* key) {
+    if (key == NULL || baker->tableCapacity == 0) {
+        return 0;
+    }
+
+    size_t mask = baker->tableCapacity - 1;
+    size_t index = ((uintptr_t)key >> 3) * 2654435761U & mask;
+    while (baker->keys[index] != NULL) {
+        if (baker->keys[index] == key) {
+            return baker->offsets[index];
+        }
+        index = (index + 1) & mask;
+    }
+
+    return 0;
+}
+
+/**
+ * Remembers what the given source pointer was baked to, so that other references to it can be resolved.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_bake_remember(pntr_tiled_baker* baker, const void* key, size_t offset) {
+    if (baker->failed) {
+        return;
+    }
+
+    // Keep the table at most half full.
+    if ((baker->tableCount + 1) * 2 > baker->tableCapacity) {
+        size_t oldCapacity = baker->tableCapacity;
+        const void** oldKeys = baker->keys;
+        size_t* oldOffsets = baker->offsets;
+
+        size_t capacity = oldCapacity > 0 ? oldCapacity * 2 : 256;
+        baker->keys = (const void**)pntr_load_memory(sizeof(void*) * capacity);
+        baker->offsets = (size_t*)pntr_load_memory(sizeof(size_t) * capacity);
+        if (baker->keys == NULL || baker->offsets == NULL) {
+            pntr_unload_memory((void*)baker->keys);
+            pntr_unload_memory(baker->offsets);
+            baker->keys = oldKeys;
+            baker->offsets = oldOffsets;
+            baker->failed = true;
+            return;
+        }
+
+        PNTR_MEMSET((void*)baker->keys, 0, sizeof(void*) * capacity);
+        baker->tableCapacity = capacity;
+        baker->tableCount = 0;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldKeys[i] != NULL) {
+                _pntr_tiled_bake_remember(baker, oldKeys[i], oldOffsets[i]);
+            }
+        }
+        pntr_unload_memory((void*)oldKeys);
+        pntr_unload_memory(oldOffsets);
+    }
+
+    size_t mask = baker->tableCapacity - 1;
+    size_t index = ((uintptr_t)key >> 3) * 2654435761U & mask;
+    while (baker->keys[index] != NULL) {
+        index = (index + 1) & mask;
+    }
+
+    baker->keys[index] = key;
+    baker->offsets[index] = offset;
+    baker->tableCount++;
+}
+
+/**
+ * Bakes a string. Interned strings are shared, so each one is only baked once.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_bake_string(pntr_tiled_baker* baker, size_t field, const char* str) {
+    size_t target = 0;
+    if (str != NULL) {
+        target = _pntr_tiled_bake_find(baker, str);
+        if (target == 0) {
+            target = _pntr_tiled_bake_write(baker, str, PNTR_STRLEN(str) + 1);
+            _pntr_tiled_bake_remember(baker, str, target);
+        }
+    }
+
+    // Clear the whole union, so 32-bit bakes are deterministic.
+    if (!baker->failed) {
+        PNTR_MEMSET(baker->data + field, 0, sizeof(cute_tiled_string_t));
+    }
+    _pntr_tiled_bake_pointer(baker, field, target);
+}
+
+/**
+ * Bakes a file path relative to the map, as a path relative to the working directory.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_bake_path(pntr_tiled_baker* baker, size_t field, const char* path) {
+    if (path == NULL) {
+        _pntr_tiled_bake_string(baker, field, NULL);
+        return;
+    }
+
+    size_t baseDirLength = PNTR_STRLEN(baker->baseDir);
+    size_t pathLength = PNTR_STRLEN(path);
+    size_t target = _pntr_tiled_bake_write(baker, NULL, baseDirLength + pathLength + 1);
+    if (!baker->failed) {
+        pntr_memory_copy(baker->data + target, (void*)baker->baseDir, baseDirLength);
+        pntr_memory_copy(baker->data + target + baseDirLength, (void*)path, pathLength);
+        PNTR_MEMSET(baker->data + field, 0, sizeof(cute_tiled_string_t));
+    }
+    _pntr_tiled_bake_pointer(baker, field, target);
+}
+
+/**
+ * Bakes an array, and sets the pointer at the given field to it.
+ *
+ * @return The offset of the baked array, or 0 if there is nothing to bake.
+ *
+ * @internal
+ * @private
+ */
+static size_t _pntr_tiled_bake_array(pntr_tiled_baker* baker, size_t field, const void* array, size_t size) {
+    size_t target = (array != NULL && size > 0) ? _pntr_tiled_bake_write(baker, array, size) : 0;
+    _pntr_tiled_bake_pointer(baker, field, target);
+    return target;
+}
+
+static void _pntr_tiled_bake_properties(pntr_tiled_baker* baker, size_t field, cute_tiled_property_t* properties, int count) {
+    size_t offset = _pntr_tiled_bake_array(baker, field, properties, sizeof(cute_tiled_property_t) * (size_t)count);
+    if (offset == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        size_t property = offset + sizeof(cute_tiled_property_t) * (size_t)i;
+        _pntr_tiled_bake_string(baker, property + offsetof(cute_tiled_property_t, name), properties[i].name.ptr);
+        if (properties[i].type == CUTE_TILED_PROPERTY_STRING || properties[i].type == CUTE_TILED_PROPERTY_FILE) {
+            _pntr_tiled_bake_string(baker, property + offsetof(cute_tiled_property_t, data), properties[i].data.string.ptr);
+        }
+    }
+}
+
+static void _pntr_tiled_bake_objects(pntr_tiled_baker* baker, size_t field, cute_tiled_object_t* object) {
+    while (object != NULL && !baker->failed) {
+        size_t offset = _pntr_tiled_bake_write(baker, object, sizeof(cute_tiled_object_t));
+        _pntr_tiled_bake_pointer(baker, field, offset);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_object_t, name), object->name.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_object_t, type), object->type.ptr);
+        _pntr_tiled_bake_array(baker, offset + offsetof(cute_tiled_object_t, vertices), object->vertices, sizeof(float) * 2 * (size_t)object->vert_count);
+        _pntr_tiled_bake_properties(baker, offset + offsetof(cute_tiled_object_t, properties), object->properties, object->property_count);
+
+        field = offset + offsetof(cute_tiled_object_t, next);
+        object = object->next;
+    }
+
+    _pntr_tiled_bake_pointer(baker, field, 0);
+}
+
+static void _pntr_tiled_bake_chunks(pntr_tiled_baker* baker, size_t field, cute_tiled_chunk_t* chunk) {
+    while (chunk != NULL && !baker->failed) {
+        size_t offset = _pntr_tiled_bake_write(baker, chunk, sizeof(cute_tiled_chunk_t));
+        _pntr_tiled_bake_remember(baker, chunk, offset);
+        _pntr_tiled_bake_pointer(baker, field, offset);
+        _pntr_tiled_bake_array(baker, offset + offsetof(cute_tiled_chunk_t, data), chunk->data, sizeof(int) * (size_t)chunk->data_count);
+
+        field = offset + offsetof(cute_tiled_chunk_t, next);
+        chunk = chunk->next;
+    }
+
+    _pntr_tiled_bake_pointer(baker, field, 0);
+}
+
+static void _pntr_tiled_bake_chunk_table(pntr_tiled_baker* baker, size_t field, cute_tiled_chunk_table_t* table) {
+    if (table == NULL) {
+        _pntr_tiled_bake_pointer(baker, field, 0);
+        return;
+    }
+
+    // The chunks are baked already, so each slot can be pointed at its baked chunk.
+    size_t slotCount = (size_t)table->mask + 1;
+    size_t offset = _pntr_tiled_bake_array(baker, field, table, sizeof(cute_tiled_chunk_table_t) + sizeof(cute_tiled_chunk_t*) * (slotCount - 1));
+    for (size_t i = 0; i < slotCount && offset != 0; i++) {
+        _pntr_tiled_bake_pointer(baker, offset + offsetof(cute_tiled_chunk_table_t, slots) + sizeof(cute_tiled_chunk_t*) * i, _pntr_tiled_bake_find(baker, table->slots[i]));
+    }
+}
+
+static void _pntr_tiled_bake_layers(pntr_tiled_baker* baker, size_t field, cute_tiled_layer_t* layer) {
+    while (layer != NULL && !baker->failed) {
+        size_t offset = _pntr_tiled_bake_write(baker, layer, sizeof(cute_tiled_layer_t));
+        _pntr_tiled_bake_pointer(baker, field, offset);
+        _pntr_tiled_bake_chunks(baker, offset + offsetof(cute_tiled_layer_t, chunks), layer->chunks);
+        _pntr_tiled_bake_chunk_table(baker, offset + offsetof(cute_tiled_layer_t, _chunk_table), (cute_tiled_chunk_table_t*)layer->_chunk_table);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, class_), layer->class_.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, compression), layer->compression.ptr);
+        _pntr_tiled_bake_array(baker, offset + offsetof(cute_tiled_layer_t, data), layer->data, sizeof(int) * (size_t)layer->data_count);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, draworder), layer->draworder.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, encoding), layer->encoding.ptr);
+        _pntr_tiled_bake_layers(baker, offset + offsetof(cute_tiled_layer_t, layers), layer->layers);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, name), layer->name.ptr);
+        _pntr_tiled_bake_objects(baker, offset + offsetof(cute_tiled_layer_t, objects), layer->objects);
+        _pntr_tiled_bake_properties(baker, offset + offsetof(cute_tiled_layer_t, properties), layer->properties, layer->property_count);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, type), layer->type.ptr);
+        if (layer->type.ptr != NULL && PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
+            _pntr_tiled_bake_path(baker, offset + offsetof(cute_tiled_layer_t, image), layer->image.ptr);
+        }
+        else {
+            _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_layer_t, image), layer->image.ptr);
+        }
+
+        field = offset + offsetof(cute_tiled_layer_t, next);
+        layer = layer->next;
+    }
+
+    _pntr_tiled_bake_pointer(baker, field, 0);
+}
+
+static void _pntr_tiled_bake_tile_descriptors(pntr_tiled_baker* baker, size_t field, cute_tiled_tile_descriptor_t* descriptor) {
+    while (descriptor != NULL && !baker->failed) {
+        size_t offset = _pntr_tiled_bake_write(baker, descriptor, sizeof(cute_tiled_tile_descriptor_t));
+        _pntr_tiled_bake_remember(baker, descriptor, offset);
+        _pntr_tiled_bake_pointer(baker, field, offset);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tile_descriptor_t, type), descriptor->type.ptr);
+        _pntr_tiled_bake_array(baker, offset + offsetof(cute_tiled_tile_descriptor_t, animation), descriptor->animation, sizeof(cute_tiled_frame_t) * (size_t)descriptor->frame_count);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tile_descriptor_t, image), descriptor->image.ptr);
+        _pntr_tiled_bake_layers(baker, offset + offsetof(cute_tiled_tile_descriptor_t, objectgroup), descriptor->objectgroup);
+        _pntr_tiled_bake_properties(baker, offset + offsetof(cute_tiled_tile_descriptor_t, properties), descriptor->properties, descriptor->property_count);
+
+        field = offset + offsetof(cute_tiled_tile_descriptor_t, next);
+        descriptor = descriptor->next;
+    }
+
+    _pntr_tiled_bake_pointer(baker, field, 0);
+}
+
+static void _pntr_tiled_bake_tilesets(pntr_tiled_baker* baker, size_t field, cute_tiled_tileset_t* tileset) {
+    while (tileset != NULL && !baker->failed) {
+        size_t offset = _pntr_tiled_bake_write(baker, tileset, sizeof(cute_tiled_tileset_t));
+        _pntr_tiled_bake_remember(baker, tileset, offset);
+        _pntr_tiled_bake_pointer(baker, field, offset);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, class_), tileset->class_.ptr);
+        _pntr_tiled_bake_path(baker, offset + offsetof(cute_tiled_tileset_t, image), tileset->image.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, name), tileset->name.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, objectalignment), tileset->objectalignment.ptr);
+        _pntr_tiled_bake_properties(baker, offset + offsetof(cute_tiled_tileset_t, properties), tileset->properties, tileset->property_count);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, tiledversion), tileset->tiledversion.ptr);
+        _pntr_tiled_bake_tile_descriptors(baker, offset + offsetof(cute_tiled_tileset_t, tiles), tileset->tiles);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, type), tileset->type.ptr);
+        _pntr_tiled_bake_string(baker, offset + offsetof(cute_tiled_tileset_t, source), tileset->source.ptr);
+        _pntr_tiled_bake_pointer(baker, offset + offsetof(cute_tiled_tileset_t, _internal), 0);
+
+        field = offset + offsetof(cute_tiled_tileset_t, next);
+        tileset = tileset->next;
+    }
+
+    _pntr_tiled_bake_pointer(baker, field, 0);
+}
+
+/**
+ * Bakes the given map file into memory, reading it and its external tilesets through the io.
+ *
+ * @return The baked map, or NULL on failure. Unload with pntr_unload_memory().
+ *
+ * @internal
+ * @private
+ */
+static unsigned char* _pntr_tiled_bake(const pntr_tiled_io* io, const char* fileName, unsigned int* size) {
+    size_t fileNameLength = PNTR_STRLEN(fileName);
+    if (fileNameLength >= PNTR_PATH_MAX) {
+        return NULL;
+    }
+
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, fileName, false, &file)) {
+        return NULL;
+    }
+
+    // Copy the fileName, along with its null terminator to find the basePath.
+    char baseDir[PNTR_PATH_MAX];
+    pntr_memory_copy((void*)baseDir, (void*)fileName, fileNameLength);
+    baseDir[fileNameLength] = '\0';
+    _pntr_tiled_path_basedir(baseDir);
+
+    cute_tiled_map_t* map = _pntr_tiled_parse(file.data, file.size, baseDir, io);
+    _pntr_tiled_close_file(&file);
+    if (map == NULL) {
+        return NULL;
+    }
+
+    pntr_tiled_baked_header header;
+    PNTR_MEMSET(&header, 0, sizeof(header));
+    header.magic = PNTR_TILED_BAKED_MAGIC;
+    header.version = PNTR_TILED_BAKED_VERSION;
+    header.layout = _pntr_tiled_baked_layout();
+
+    pntr_tiled_baker baker;
+    PNTR_MEMSET(&baker, 0, sizeof(baker));
+    baker.baseDir = baseDir;
+    baker.failed = !_pntr_tiled_source_hash(io, fileName, baseDir, map, &header.sourceHash);
+    _pntr_tiled_bake_write(&baker, &header, sizeof(header));
+
+    // The map itself, with the tiledversion replaced by the tile table.
+    size_t mapOffset = _pntr_tiled_bake_write(&baker, map, sizeof(cute_tiled_map_t));
+    _pntr_tiled_bake_pointer(&baker, offsetof(pntr_tiled_baked_header, map), mapOffset);
+    _pntr_tiled_bake_string(&baker, mapOffset + offsetof(cute_tiled_map_t, class_), map->class_.ptr);
+    _pntr_tiled_bake_layers(&baker, mapOffset + offsetof(cute_tiled_map_t, layers), map->layers);
+    _pntr_tiled_bake_string(&baker, mapOffset + offsetof(cute_tiled_map_t, orientation), map->orientation.ptr);
+    _pntr_tiled_bake_properties(&baker, mapOffset + offsetof(cute_tiled_map_t, properties), map->properties, map->property_count);
+    _pntr_tiled_bake_string(&baker, mapOffset + offsetof(cute_tiled_map_t, renderorder), map->renderorder.ptr);
+    _pntr_tiled_bake_tilesets(&baker, mapOffset + offsetof(cute_tiled_map_t, tilesets), map->tilesets);
+    _pntr_tiled_bake_string(&baker, mapOffset + offsetof(cute_tiled_map_t, type), map->type.ptr);
+    if (!baker.failed) {
+        ((cute_tiled_map_t*)(baker.data + mapOffset))->nextlayerid = 0;
+    }
+
+    // The tile table, with where each tile is within its tileset image, and the gid ranges that index it.
+    int rangeCount = 0;
+    int tileCount = _pntr_tiled_tile_count(map, &rangeCount);
+    pntr_tiled_map_data data;
+    PNTR_MEMSET(&data, 0, sizeof(data));
+    data.tileCount = tileCount;
+    data.rangeCount = rangeCount;
+    pntr_tiled_gid_range* ranges = NULL;
+    if (rangeCount > 0) {
+        ranges = (pntr_tiled_gid_range*)pntr_load_memory(sizeof(pntr_tiled_gid_range) * (size_t)rangeCount);
+        if (ranges == NULL) {
+            baker.failed = true;
+        }
+        else {
+            _pntr_tiled_index_tilesets(map, ranges, &data.directCount);
+        }
+    }
+    size_t dataOffset = _pntr_tiled_bake_write(&baker, &data, sizeof(data));
+    _pntr_tiled_bake_string(&baker, mapOffset + offsetof(cute_tiled_map_t, tiledversion), NULL);
+    _pntr_tiled_bake_pointer(&baker, mapOffset + offsetof(cute_tiled_map_t, tiledversion), dataOffset);
+    _pntr_tiled_bake_pointer(&baker, offsetof(pntr_tiled_baked_header, data), dataOffset);
+    size_t tilesOffset = _pntr_tiled_bake_write(&baker, NULL, sizeof(pntr_tiled_tile) * (size_t)tileCount);
+    size_t sourcesOffset = _pntr_tiled_bake_write(&baker, NULL, sizeof(pntr_rectangle) * (size_t)tileCount);
+    if (tileCount > 0) {
+        _pntr_tiled_bake_pointer(&baker, dataOffset + offsetof(pntr_tiled_map_data, tiles), tilesOffset);
+        _pntr_tiled_bake_pointer(&baker, offsetof(pntr_tiled_baked_header, tileSources), sourcesOffset);
+    }
+    if (ranges != NULL) {
+        size_t rangesOffset = _pntr_tiled_bake_write(&baker, ranges, sizeof(pntr_tiled_gid_range) * (size_t)rangeCount);
+        _pntr_tiled_bake_pointer(&baker, dataOffset + offsetof(pntr_tiled_map_data, ranges), rangesOffset);
+    }
+
+    // Find where each tileset's tiles go through the ranges.
+    data.ranges = ranges;
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset && !baker.failed) {
+        pntr_tiled_gid_range* range = _pntr_tiled_find_range(&data, tileset->firstgid);
+        if (tileset->tilecount <= 0 || range == NULL || range->firstgid != tileset->firstgid) {
+            tileset = tileset->next;
+            continue;
+        }
+
+        pntr_tiled_tile* tiles = (pntr_tiled_tile*)pntr_load_memory(sizeof(pntr_tiled_tile) * (size_t)tileset->tilecount);
+        if (tiles == NULL) {
+            baker.failed = true;
+            break;
+        }
+        PNTR_MEMSET(tiles, 0, sizeof(pntr_tiled_tile) * (size_t)tileset->tilecount);
+        _pntr_tiled_init_tiles(tiles, tileset, tileset->tilecount);
+
+        for (int i = 0; i < tileset->tilecount && !baker.failed; i++) {
+            size_t index = (size_t)(range->offset + i);
+            pntr_rectangle source = _pntr_tiled_tile_source(tileset, i);
+            size_t tileOffset = tilesOffset + sizeof(pntr_tiled_tile) * index;
+            pntr_memory_copy(baker.data + sourcesOffset + sizeof(pntr_rectangle) * index, &source, sizeof(source));
+            pntr_memory_copy(baker.data + tileOffset, tiles + i, sizeof(pntr_tiled_tile));
+            _pntr_tiled_bake_pointer(&baker, tileOffset + offsetof(pntr_tiled_tile, descriptor), _pntr_tiled_bake_find(&baker, tiles[i].descriptor));
+            _pntr_tiled_bake_pointer(&baker, tileOffset + offsetof(pntr_tiled_tile, tileset), _pntr_tiled_bake_find(&baker, tileset));
+        }
+        pntr_unload_memory(tiles);
+        tileset = tileset->next;
+    }
+    pntr_unload_memory(ranges);
+    _pntr_tiled_unload_external_tilesets(map, NULL);
+    cute_tiled_free_map(map);
+
+    // Finish with the relocation table.
+    size_t relocationCount = baker.relocationCount;
+    size_t relocationsOffset = _pntr_tiled_bake_write(&baker, baker.relocations, sizeof(uint32_t) * relocationCount);
+    if (!baker.failed) {
+        pntr_tiled_baked_header* output = (pntr_tiled_baked_header*)baker.data;
+        output->size = (uint32_t)baker.size;
+        output->relocationsOffset = (uint32_t)relocationsOffset;
+        output->relocationCount = (uint32_t)relocationCount;
+    }
+
+    pntr_unload_memory(baker.relocations);
+    pntr_unload_memory((void*)baker.keys);
+    pntr_unload_memory(baker.offsets);
+    if (baker.failed) {
+        pntr_unload_memory(baker.data);
+        return NULL;
+    }
+
+    *size = (unsigned int)baker.size;
+    return baker.data;
+}
+
+PNTR_TILED_API bool pntr_save_tiled_baked(const char* fileName, const char* bakedFileName) {
+    if (fileName == NULL || bakedFileName == NULL) {
+        return false;
+    }
+
+    unsigned int size;
+    pntr_tiled_io io = pntr_tiled_io_files(false);
+    unsigned char* baked = _pntr_tiled_bake(&io, fileName, &size);
+    if (baked == NULL) {
+        return false;
+    }
+
+    bool output = pntr_save_file(bakedFileName, baked, size);
+    pntr_unload_memory(baked);
+    return output;
+}
+
+/**
+ * Checks that the given range lies within the baked data, after its header.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_baked_within(const unsigned char* baked, unsigned int size, const void* ptr, size_t length) {
+    // Compared as integers, as the pointer may be a raw offset from anywhere.
+    uintptr_t start = (uintptr_t)ptr;
+    uintptr_t end = (uintptr_t)baked + size;
+    return start >= (uintptr_t)baked + sizeof(pntr_tiled_baked_header) && start <= end && length <= end - start;
+}
+
+/**
+ * Validates the baked data, and fixes up all of its pointers.
+ *
+ * @return The baked map, or NULL if the data is not a valid bake for this build.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_map_t* _pntr_tiled_relocate_baked(unsigned char* baked, unsigned int size) {
+    if (baked == NULL || size < sizeof(pntr_tiled_baked_header)) {
+        return NULL;
+    }
+
+    pntr_tiled_baked_header* header = (pntr_tiled_baked_header*)baked;
+    if (header->magic != PNTR_TILED_BAKED_MAGIC || header->version != PNTR_TILED_BAKED_VERSION || header->layout != _pntr_tiled_baked_layout() || header->size != size) {
+        return NULL;
+    }
+
+    if (header->relocationsOffset > size || header->relocationCount > (size - header->relocationsOffset) / sizeof(uint32_t)) {
+        return NULL;
+    }
+
+    // Each pointer is an offset from the start of the file, so relocate it to the loaded address.
+    const uint32_t* relocations = (const uint32_t*)(baked + header->relocationsOffset);
+    for (uint32_t i = 0; i < header->relocationCount; i++) {
+        uint32_t field = relocations[i];
+        uintptr_t value;
+        if (field > size - sizeof(uintptr_t)) {
+            return NULL;
+        }
+
+        pntr_memory_copy(&value, baked + field, sizeof(value));
+        if (value >= size) {
+            return NULL;
+        }
+
+        value += (uintptr_t)baked;
+        pntr_memory_copy(baked + field, &value, sizeof(value));
+    }
+
+    // A bake that is missing the relocation of its header would leave raw offsets there.
+    if (!_pntr_tiled_baked_within(baked, size, header->map, sizeof(cute_tiled_map_t)) ||
+        !_pntr_tiled_baked_within(baked, size, header->data, sizeof(pntr_tiled_map_data))) {
+        return NULL;
+    }
+    if (header->data->tileCount > 0 &&
+        !_pntr_tiled_baked_within(baked, size, header->tileSources, sizeof(pntr_rectangle) * (size_t)header->data->tileCount)) {
+        return NULL;
+    }
+
+    return header->map;
+}
+
+/**
+ * Loads the images for a relocated bake through the io, which the map keeps for its lazy images.
+ *
+ * @internal
+ * @private
+ */
+static cute_tiled_map_t* _pntr_tiled_load_baked(unsigned char* baked, const pntr_tiled_io* io) {
+    pntr_tiled_baked_header* header = (pntr_tiled_baked_header*)baked;
+    cute_tiled_map_t* map = header->map;
+    header->data->baked = baked;
+    header->data->io = *io;
+
+    // Image paths are already relative to the working directory.
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        _pntr_load_tiled_string_texture(&tileset->image, "", tileset->transparentcolor, &header->data->io, NULL, NULL, NULL);
+        tileset = tileset->next;
+    }
+
+    cute_tiled_layer_t* layer = map->layers;
+    while (layer) {
+        _pntr_load_tiled_layer_images(layer, "", &header->data->io);
+        layer = layer->next;
+    }
+
+    // Build the tile subimages from their precomputed sources.
+    pntr_tiled_tile* tiles = header->data->tiles;
+    for (int i = 0; i < header->data->tileCount; i++) {
+        if (tiles[i].tileset != NULL) {
+            _pntr_tiled_load_tile_image(tiles + i, header->tileSources[i]);
+        }
+    }
+
+    return map;
+}
+
+/**
+ * Reads a baked map through the io into memory of its own, as relocating it writes to it, and the map keeps it.
+ *
+ * @return The baked data, or NULL on failure. Unload with pntr_unload_file().
+ *
+ * @internal
+ * @private
+ */
+static unsigned char* _pntr_tiled_read_baked(const pntr_tiled_io* io, const char* bakedFileName, unsigned int* size) {
+    pntr_tiled_file file;
+    if (!_pntr_tiled_open_file(io, bakedFileName, false, &file)) {
+        return NULL;
+    }
+
+    // Files that were read into memory are taken as they are, while views of the file are copied.
+    *size = file.size;
+    if (file.handle == NULL) {
+        return file.data;
+    }
+
+    unsigned char* baked = (unsigned char*)pntr_load_memory(file.size > 0 ? file.size : 1);
+    if (baked != NULL) {
+        pntr_memory_copy((void*)baked, (void*)file.data, file.size);
+    }
+    _pntr_tiled_close_file(&file);
+    return baked;
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_baked(const char* bakedFileName, const char* sourceFileName) {
+    return pntr_load_tiled_baked_ex(bakedFileName, sourceFileName, NULL);
+}
+
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_baked_ex(const char* bakedFileName, const char* sourceFileName, const pntr_tiled_io* io) {
+    if (bakedFileName == NULL || (sourceFileName != NULL && PNTR_STRLEN(sourceFileName) >= PNTR_PATH_MAX)) {
+        return NULL;
+    }
+
+    pntr_tiled_io files = pntr_tiled_io_files(false);
+    const pntr_tiled_io* fileIO = io != NULL ? io : &files;
+    unsigned int size = 0;
+    unsigned char* baked = _pntr_tiled_read_baked(fileIO, bakedFileName, &size);
+    cute_tiled_map_t* map = _pntr_tiled_relocate_baked(baked, size);
+
+    // Make sure the bake is up to date with its source.
+    if (map != NULL && sourceFileName != NULL) {
+        char baseDir[PNTR_PATH_MAX];
+        size_t fileNameLength = PNTR_STRLEN(sourceFileName);
+        pntr_memory_copy((void*)baseDir, (void*)sourceFileName, fileNameLength);
+        baseDir[fileNameLength] = '\0';
+        _pntr_tiled_path_basedir(baseDir);
+
+        uint64_t sourceHash;
+        if (!_pntr_tiled_source_hash(fileIO, sourceFileName, baseDir, map, &sourceHash) || sourceHash != ((pntr_tiled_baked_header*)baked)->sourceHash) {
+            map = NULL;
+        }
+    }
+
+    if (map != NULL) {
+        return _pntr_tiled_load_baked(baked, fileIO);
+    }
+
+    pntr_unload_file(baked);
+    if (sourceFileName == NULL) {
+        return NULL;
+    }
+
+    // Rebuild the stale bake, and load from it directly.
+    baked = _pntr_tiled_bake(fileIO, sourceFileName, &size);
+    if (baked == NULL) {
+        pntr_tiled_load_options options;
+        PNTR_MEMSET(&options, 0, sizeof(options));
+        options.io = io;
+        return pntr_load_tiled_ex(sourceFileName, &options);
+    }
+
+    // Other ios may not be writable, so only bakes from the file system are saved again.
+    if (io == NULL) {
+        pntr_save_file(bakedFileName, baked, size);
+    }
+    _pntr_tiled_relocate_baked(baked, size);
+    return _pntr_tiled_load_baked(baked, fileIO);
+}
+
+static int* _pntr_layer_tile_gid(cute_tiled_layer_t* layer, int column, int row);
+
+/**
+ * Marks the chunks of a prerendered layer that the tile at the given column and row covers to render again.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_mark_layer_cache(pntr_tiled_layer_cache* cache, int column, int row) {
+    int left = column * cache->tileWidth - cache->originX;
+    int top = row * cache->tileHeight - cache->originY;
+    int firstX = cute_tiled_floor_div(left, cache->chunkSize);
+    int firstY = cute_tiled_floor_div(top, cache->chunkSize);
+    int lastX = cute_tiled_floor_div(left + cache->tileWidth + cache->overflowX - 1, cache->chunkSize);
+    int lastY = cute_tiled_floor_div(top + cache->tileHeight + cache->overflowY - 1, cache->chunkSize);
+    for (int y = firstY > 0 ? firstY : 0; y <= lastY && y < cache->rows; y++) {
+        for (int x = firstX > 0 ? firstX : 0; x <= lastX && x < cache->columns; x++) {
+            cache->chunks[y * cache->columns + x].rendered = false;
+        }
+    }
+}
+
+/**
+ * Copies the image onto the destination as it is, rather than blending it, clipped to the destination.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_copy_image(pntr_image* dst, pntr_image* src, int posX, int posY) {
+    if (src == NULL || src->data == NULL) {
+        return;
+    }
+
+    int left = posX > 0 ? posX : 0;
+    int top = posY > 0 ? posY : 0;
+    int right = posX + src->width < dst->width ? posX + src->width : dst->width;
+    int bottom = posY + src->height < dst->height ? posY + src->height : dst->height;
+    for (int y = top; y < bottom; y++) {
+        pntr_memory_copy(
+            (unsigned char*)dst->data + (size_t)y * (size_t)dst->pitch + sizeof(pntr_color) * (size_t)left,
+            (unsigned char*)src->data + (size_t)(y - posY) * (size_t)src->pitch + sizeof(pntr_color) * (size_t)(left - posX),
+            sizeof(pntr_color) * (size_t)(right - left));
+    }
+}
+
+/**
+ * Renders the tiles that reach into the given chunk, remembering the frames of any animated ones.
+ *
+ * @return True on success, false if the chunk could not be rendered.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_render_layer_chunk(pntr_tiled_layer_cache* cache, cute_tiled_map_t* map, int chunkX, int chunkY) {
+    pntr_tiled_layer_chunk* chunk = cache->chunks + chunkY * cache->columns + chunkX;
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    int left = cache->originX + chunkX * cache->chunkSize;
+    int top = cache->originY + chunkY * cache->chunkSize;
+
+    // Tiles larger than the grid reach into the chunk from the columns and rows before it.
+    int firstColumn = cute_tiled_floor_div(left - map->tilewidth - cache->overflowX, map->tilewidth) + 1;
+    int firstRow = cute_tiled_floor_div(top - map->tileheight - cache->overflowY, map->tileheight) + 1;
+    int lastColumn = cute_tiled_floor_div(left + cache->chunkSize - 1, map->tilewidth);
+    int lastRow = cute_tiled_floor_div(top + cache->chunkSize - 1, map->tileheight);
+
+    // Finite layers have no tiles outside of their grid.
+    if (cache->layer->chunks == NULL) {
+        firstColumn = firstColumn > 0 ? firstColumn : 0;
+        firstRow = firstRow > 0 ? firstRow : 0;
+        lastColumn = lastColumn < cache->layer->width - 1 ? lastColumn : cache->layer->width - 1;
+        lastRow = lastRow < cache->layer->height - 1 ? lastRow : cache->layer->height - 1;
+    }
+
+    chunk->frameCount = 0;
+    int frameCapacity = 0;
+    bool empty = true;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) {
+            int* gid = _pntr_layer_tile_gid(cache->layer, column, row);
+            pntr_tiled_tile* tile = gid != NULL && data != NULL ? _pntr_tiled_find_tile(data, cute_tiled_unset_flags(*gid)) : NULL;
+            if (tile == NULL) {
+                continue;
+            }
+
+            if (empty) {
+                if (chunk->image == NULL) {
+                    chunk->image = pntr_gen_image_color(cache->chunkSize, cache->chunkSize, PNTR_BLANK);
+                    if (chunk->image == NULL) {
+                        return false;
+                    }
+                }
+                else {
+                    pntr_clear_background(chunk->image, PNTR_BLANK);
+                }
+                empty = false;
+            }
+
+            // Blending onto the blank chunk would round partly transparent pixels, so tiles that cannot overlap are
+            // copied instead, and blended only once the chunk is drawn.
+            if (cache->overflowX == 0 && cache->overflowY == 0 && cute_tiled_unset_flags(*gid) == *gid) {
+                _pntr_tiled_copy_image(chunk->image, pntr_tiled_tile_image(map, *gid), column * map->tilewidth - left, row * map->tileheight - top);
+            }
+            else {
+                pntr_draw_tiled_tile(chunk->image, map, *gid, column * map->tilewidth - left, row * map->tileheight - top, PNTR_WHITE);
+            }
+            if (tile->descriptor == NULL || tile->descriptor->frame_count <= 0) {
+                continue;
+            }
+
+            if (chunk->frameCount == frameCapacity) {
+                frameCapacity = frameCapacity > 0 ? frameCapacity * 2 : 8;
+                pntr_tiled_chunk_frame* frames = (pntr_tiled_chunk_frame*)pntr_load_memory(sizeof(pntr_tiled_chunk_frame) * (size_t)frameCapacity);
+                if (frames == NULL) {
+                    return false;
+                }
+                if (chunk->frameCount > 0) {
+                    pntr_memory_copy(frames, chunk->frames, sizeof(pntr_tiled_chunk_frame) * (size_t)chunk->frameCount);
+                }
+                pntr_unload_memory(chunk->frames);
+                chunk->frames = frames;
+            }
+            chunk->frames[chunk->frameCount].column = column;
+            chunk->frames[chunk->frameCount].row = row;
+            chunk->frames[chunk->frameCount].frame = pntr_tiled_tile_image(map, cute_tiled_unset_flags(*gid));
+            chunk->frameCount++;
+        }
+    }
+
+    // Chunks without any tiles keep no image.
+    if (empty) {
+        pntr_unload_image(chunk->image);
+        chunk->image = NULL;
+    }
+    chunk->rendered = true;
+    return true;
+}
+
+/**
+ * Whether any of the chunk's animated tiles have moved on to another frame since it was rendered.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_layer_chunk_animated(pntr_tiled_layer_cache* cache, cute_tiled_map_t* map, pntr_tiled_layer_chunk* chunk) {
+    for (int i = 0; i < chunk->frameCount; i++) {
+        int* gid = _pntr_layer_tile_gid(cache->layer, chunk->frames[i].column, chunk->frames[i].row);
+        if (gid == NULL || pntr_tiled_tile_image(map, cute_tiled_unset_flags(*gid)) != chunk->frames[i].frame) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Finds the range of cells of the given size, laid out from the given position, that are within the destination's
+ * clipping rectangle.
+ *
+ * @return True when any of the destination is left to draw on, false otherwise.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_visible_cells(pntr_image* dst, int posX, int posY, int cellWidth, int cellHeight, int* firstColumn, int* firstRow, int* lastColumn, int* lastRow) {
+    if (dst->clip.width <= 0 || dst->clip.height <= 0 || cellWidth <= 0 || cellHeight <= 0) {
+        return false;
+    }
+
+    *firstColumn = cute_tiled_floor_div(dst->clip.x - posX, cellWidth);
+    *firstRow = cute_tiled_floor_div(dst->clip.y - posY, cellHeight);
+    *lastColumn = cute_tiled_floor_div(dst->clip.x + dst->clip.width - 1 - posX, cellWidth);
+    *lastRow = cute_tiled_floor_div(dst->clip.y + dst->clip.height - 1 - posY, cellHeight);
+    return true;
+}
+
+/**
+ * Draws the chunks of a prerendered layer that are within the destination, rendering any that need it.
+ *
+ * @return True on success, false if the layer needs to be drawn tile by tile instead.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_draw_tiled_layer_cache(pntr_image* dst, cute_tiled_map_t* map, pntr_tiled_layer_cache* cache, int posX, int posY, pntr_color tint) {
+    int left = posX + cache->originX;
+    int top = posY + cache->originY;
+    int firstX, firstY, lastX, lastY;
+    if (!_pntr_tiled_visible_cells(dst, left, top, cache->chunkSize, cache->chunkSize, &firstX, &firstY, &lastX, &lastY)) {
+        return true;
+    }
+    for (int y = firstY > 0 ? firstY : 0; y <= lastY && y < cache->rows; y++) {
+        for (int x = firstX > 0 ? firstX : 0; x <= lastX && x < cache->columns; x++) {
+            pntr_tiled_layer_chunk* chunk = cache->chunks + y * cache->columns + x;
+            if (!chunk->rendered || _pntr_tiled_layer_chunk_animated(cache, map, chunk)) {
+                if (!_pntr_tiled_render_layer_chunk(cache, map, x, y)) {
+                    return false;
+                }
+            }
+
+            if (chunk->image != NULL) {
+                pntr_draw_image_tint(dst, chunk->image, left + x * cache->chunkSize, top + y * cache->chunkSize, tint);
+            }
+        }
+    }
+
+    return true;
+}
+
+PNTR_TILED_API bool pntr_tiled_prerender_layer(cute_tiled_map_t* map, cute_tiled_layer_t* layer, int chunkSize) {
+    if (map == NULL || layer == NULL || map->tiledversion.ptr == NULL || layer->type.ptr == NULL || PNTR_STRCMP(layer->type.ptr, "tilelayer") != 0) {
+        return false;
+    }
+
+    // Drop the layer's old chunks.
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    pntr_tiled_layer_cache** link = &data->layerCaches;
+    while (*link != NULL && (*link)->layer != layer) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) {
+        pntr_tiled_layer_cache* previous = *link;
+        *link = previous->next;
+        _pntr_tiled_unload_layer_cache(previous);
+    }
+    layer->image.ptr = NULL;
+
+    if (chunkSize <= 0) {
+        return true;
+    }
+    if (map->tilewidth <= 0 || map->tileheight <= 0) {
+        return false;
+    }
+
+    // Find the tiles that the layer covers, which for infinite maps start wherever the first chunk does.
+    int firstColumn = 0;
+    int firstRow = 0;
+    int lastColumn = layer->width;
+    int lastRow = layer->height;
+    if (layer->chunks != NULL) {
+        firstColumn = firstRow = 0x7FFFFFFF;
+        lastColumn = lastRow = -0x7FFFFFFF;
+        for (cute_tiled_chunk_t* chunk = layer->chunks; chunk != NULL; chunk = chunk->next) {
+            firstColumn = chunk->x < firstColumn ? chunk->x : firstColumn;
+            firstRow = chunk->y < firstRow ? chunk->y : firstRow;
+            lastColumn = chunk->x + chunk->width > lastColumn ? chunk->x + chunk->width : lastColumn;
+            lastRow = chunk->y + chunk->height > lastRow ? chunk->y + chunk->height : lastRow;
+        }
+    }
+
+    // Tiles can be larger than the grid, such as those of collection of images tilesets.
+    int tileWidth = map->tilewidth;
+    int tileHeight = map->tileheight;
+    for (cute_tiled_tileset_t* tileset = map->tilesets; tileset != NULL; tileset = tileset->next) {
+        tileWidth = tileset->tilewidth > tileWidth ? tileset->tilewidth : tileWidth;
+        tileHeight = tileset->tileheight > tileHeight ? tileset->tileheight : tileHeight;
+        for (cute_tiled_tile_descriptor_t* descriptor = tileset->tiles; descriptor != NULL; descriptor = descriptor->next) {
+            tileWidth = descriptor->imagewidth > tileWidth ? descriptor->imagewidth : tileWidth;
+            tileHeight = descriptor->imageheight > tileHeight ? descriptor->imageheight : tileHeight;
+        }
+    }
+
+    int width = (lastColumn - firstColumn) * map->tilewidth + tileWidth - map->tilewidth;
+    int height = (lastRow - firstRow) * map->tileheight + tileHeight - map->tileheight;
+    int columns = width > 0 ? (width + chunkSize - 1) / chunkSize : 0;
+    int rows = height > 0 ? (height + chunkSize - 1) / chunkSize : 0;
+
+    // The chunks are allocated along with the cache.
+    size_t chunksOffset = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_layer_cache));
+    size_t size = chunksOffset + sizeof(pntr_tiled_layer_chunk) * (size_t)columns * (size_t)rows;
+    pntr_tiled_layer_cache* cache = (pntr_tiled_layer_cache*)pntr_load_memory(size);
+    if (cache == NULL) {
+        return false;
+    }
+    PNTR_MEMSET(cache, 0, size);
+    cache->layer = layer;
+    cache->chunkSize = chunkSize;
+    cache->tileWidth = map->tilewidth;
+    cache->tileHeight = map->tileheight;
+    cache->originX = firstColumn * map->tilewidth;
+    cache->originY = firstRow * map->tileheight;
+    cache->columns = columns;
+    cache->rows = rows;
+    cache->overflowX = tileWidth - map->tilewidth;
+    cache->overflowY = tileHeight - map->tileheight;
+    cache->chunks = (pntr_tiled_layer_chunk*)((unsigned char*)cache + chunksOffset);
+
+    cache->next = data->layerCaches;
+    data->layerCaches = cache;
+    layer->image.ptr = (const char*)cache;
+    return true;
+}
+
+PNTR_TILED_API void pntr_draw_tiled_tile(pntr_image* dst, cute_tiled_map_t* map, int gid, int posX, int posY, pntr_color tint) {
+    // Get the clean Tile ID
+    int tileID = cute_tiled_unset_flags(gid);
+
+    // Get the tile image.
+    pntr_image* tile = pntr_tiled_tile_image(map, tileID);
+    if (tile == NULL) {
+        return;
+    }
+
+    // See if we are to flip the tile in anyway.
+    if (tileID != gid) {
+        // TODO: pntr_draw_tiled_tile: Add flipped tile with tint with pntr_draw_image_flipped_tint
+        pntr_draw_image_flipped(dst, tile,
+            posX, posY,
+            !!(gid & CUTE_TILED_FLIPPED_HORIZONTALLY_FLAG),
+            !!(gid & CUTE_TILED_FLIPPED_VERTICALLY_FLAG),
+            !!(gid & CUTE_TILED_FLIPPED_DIAGONALLY_FLAG)
+        );
+    }
+    else {
+        pntr_draw_image_tint(dst, tile, posX, posY, tint);
+    }
+}
+
+/**
+ * Draws the chunks of an infinite map's tile layer, looking up only the chunks that are within view.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_draw_tiled_layer_chunks(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
+    if (map->tilewidth <= 0 || map->tileheight <= 0) {
+        return;
+    }
+
+    int chunkWidth = layer->chunks->width;
+    int chunkHeight = layer->chunks->height;
+
+    // Find the range of tiles that are within the destination.
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!_pntr_tiled_visible_cells(dst, posX, posY, map->tilewidth, map->tileheight, &firstColumn, &firstRow, &lastColumn, &lastRow)) {
+        return;
+    }
+
+    for (int chunkY = cute_tiled_floor_div(firstRow, chunkHeight) * chunkHeight; chunkY <= lastRow; chunkY += chunkHeight) {
+        for (int chunkX = cute_tiled_floor_div(firstColumn, chunkWidth) * chunkWidth; chunkX <= lastColumn; chunkX += chunkWidth) {
+            cute_tiled_chunk_t* chunk = cute_tiled_get_chunk(layer, chunkX, chunkY);
+            if (chunk == NULL) {
+                continue;
             }
 
-            // Switch the tile to the animation frame.
-            gid = tile->tileset->firstgid + tile->descriptor->animation[desiredFrame].tileid;
-            tile = (pntr_tiled_tile*)map->tiledversion.ptr;
-            tile = tile + gid - 1;
-        }
-    }
+            // Only the chunk's tiles that are within the destination.
+            int top = firstRow > chunk->y ? firstRow - chunk->y : 0;
+            int left = firstColumn > chunk->x ? firstColumn - chunk->x : 0;
+            int bottom = lastRow - chunk->y + 1 < chunk->height ? lastRow - chunk->y + 1 : chunk->height;
+            int right = lastColumn - chunk->x + 1 < chunk->width ? lastColumn - chunk->x + 1 : chunk->width;
+            for (int y = top; y < bottom; y++) {
+                for (int x = left; x < right; x++) {
+                    pntr_draw_tiled_tile(dst, map,
+                        chunk->data[y * chunk->width + x],
+                        posX + (chunk->x + x) * map->tilewidth,
+                        posY + (chunk->y + y) * map->tileheight,
+                        tint
+                    );
+                }
+            }
+        }
+    }
+}
+
+PNTR_TILED_API void pntr_draw_tiled_layer_tilelayer(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
+    // Prerendered layers keep their chunks as their image.
+    if (layer->image.ptr != NULL && _pntr_draw_tiled_layer_cache(dst, map, (pntr_tiled_layer_cache*)layer->image.ptr, posX, posY, tint)) {
+        return;
+    }
+
+    if (layer->chunks != NULL) {
+        _pntr_draw_tiled_layer_chunks(dst, map, layer, posX, posY, tint);
+        return;
+    }
+
+    // Only visit the tiles within the destination.
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (layer->data == NULL || !_pntr_tiled_visible_cells(dst, posX, posY, map->tilewidth, map->tileheight, &firstColumn, &firstRow, &lastColumn, &lastRow)) {
+        return;
+    }
+    firstColumn = firstColumn > 0 ? firstColumn : 0;
+    firstRow = firstRow > 0 ? firstRow : 0;
+    lastColumn = lastColumn < layer->width - 1 ? lastColumn : layer->width - 1;
+    lastRow = lastRow < layer->height - 1 ? lastRow : layer->height - 1;
+
+    for (int y = firstRow; y <= lastRow; y++) {
+        for (int x = firstColumn; x <= lastColumn; x++) {
+            // Draw the tile from the gid.
+            pntr_draw_tiled_tile(dst, map,
+                layer->data[y * layer->width + x],
+                posX + x * map->tilewidth,
+                posY + y * map->tileheight,
+                tint
+            );
+        }
+    }
+}
+
+PNTR_TILED_API void pntr_draw_tiled_layer_imagelayer(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
+    PNTR_UNUSED(map);
+    pntr_image* image = (pntr_image*)layer->image.ptr;
+
+    if (layer->tintcolor != 0) {
+        tint = pntr_color_alpha_blend(tint,
+            pntr_tiled_color(layer->tintcolor)
+        );
+        tint.rgba.a *= layer->opacity;
+    }
+
+    // TODO: Image layer: Support repeatx and repeaty
+
+    // Skip images that are outside of the destination.
+    if (image == NULL || posX >= dst->clip.x + dst->clip.width || posY >= dst->clip.y + dst->clip.height ||
+            posX + image->width <= dst->clip.x || posY + image->height <= dst->clip.y) {
+        return;
+    }
+
+    pntr_draw_image_tint(dst, image, posX, posY, tint);
+}
+
+#ifndef CEILF
+#define CEILF(x) ((int)((x) + 0.999999f))
+#endif
 
-    return &tile->image;
+// Helper: get bounding box for polygon
+static void get_polygon_bounds(const float* vertices, int vert_count, float* out_min_x, float* out_min_y, float* out_max_x, float* out_max_y) {
+    float min_x = vertices[0], max_x = vertices[0];
+    float min_y = vertices[1], max_y = vertices[1];
+    for (int i = 1; i < vert_count; ++i) {
+        float x = vertices[i * 2];
+        float y = vertices[i * 2 + 1];
+        if (x < min_x) min_x = x;
+        if (x > max_x) max_x = x;
+        if (y < min_y) min_y = y;
+        if (y > max_y) max_y = y;
+    }
+    *out_min_x = min_x;
+    *out_min_y = min_y;
+    *out_max_x = max_x;
+    *out_max_y = max_y;
 }
 
-PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled(const char* fileName) {
-    unsigned int bytesRead;
-    unsigned char* data = pntr_load_file(fileName, &bytesRead);
-    if (data == NULL) {
+/**
+ * Rasterizes a rectangle, ellipse or polygon object into a new image, rotated if it needs to be. Polygons are drawn
+ * from the top left of their vertices.
+ *
+ * @return The image of the object, or NULL on failure.
+ *
+ * @internal
+ * @private
+ */
+static pntr_image* _pntr_tiled_render_shape(cute_tiled_object_t* obj, pntr_color tint, float min_x, float min_y, float max_x, float max_y) {
+    int shape_w = (int)CEILF(max_x - min_x);
+    int shape_h = (int)CEILF(max_y - min_y);
+
+    // Create temp image
+    pntr_image* temp = pntr_new_image(shape_w, shape_h);
+    if (temp == NULL) {
         return NULL;
     }
 
-    // Copy the fileName, along with its null terminator to find the basePath.
-    char baseDir[PNTR_PATH_MAX];
-    size_t fileNameLength = PNTR_STRLEN(fileName);
-    pntr_memory_copy((void*)baseDir, (void*)fileName, fileNameLength);
-    baseDir[fileNameLength] = '\0';
-    _pntr_tiled_path_basedir(baseDir);
+    if (obj->vert_count > 0) {
+        // Allocate and shift points to local (0,0) space
+        pntr_vector* points = (pntr_vector*)pntr_load_memory(sizeof(pntr_vector) * (size_t)obj->vert_count);
+        if (points == NULL) {
+            pntr_unload_image(temp);
+            return NULL;
+        }
+        for (int i = 0; i < obj->vert_count; ++i) {
+            points[i].x = obj->vertices[i * 2] - min_x;
+            points[i].y = obj->vertices[i * 2 + 1] - min_y;
+        }
+        pntr_draw_polygon_fill(temp, points, obj->vert_count, tint);
+        pntr_unload_memory(points);
+    }
+    else if (obj->ellipse) {
+        // Draw ellipse centered in temp image
+        pntr_draw_ellipse_fill(temp, shape_w/2, shape_h/2, shape_w/2, shape_h/2, tint);
+    } else {
+        // Draw rectangle at (0,0)
+        pntr_draw_rectangle_fill(temp, 0, 0, shape_w, shape_h, tint);
+    }
 
-    // Load the tiled map.
-    cute_tiled_map_t* output = pntr_load_tiled_from_memory(data, bytesRead, baseDir);
-    pntr_unload_memory(data);
+    // Rotate if needed
+    if (obj->rotation != 0.0f) {
+        pntr_image* rotated = pntr_image_rotate(temp, obj->rotation, PNTR_FILTER_BILINEAR);
+        pntr_unload_image(temp);
+        return rotated;
+    }
 
-    return output;
+    return temp;
 }
 
+// How much memory the images of a map's rasterized shape objects can take up, in bytes, before the least recently
+// drawn are dropped.
+#ifndef PNTR_TILED_SHAPE_CACHE_SIZE
+    #define PNTR_TILED_SHAPE_CACHE_SIZE (4 * 1024 * 1024)
+#endif
+
 /**
- * Replaces the "image" with pntr_image.
+ * Drops the shape from the cache, and frees its image.
  *
- * @param image The string image to replace.
- * @param baseDir The base directory where the map file was loaded.
+ * @internal
+ * @private
  */
-static void _pntr_load_tiled_string_texture(cute_tiled_string_t* image, const char* baseDir) {
-    if (image == NULL || image->ptr == NULL) {
-        return;
+static void _pntr_tiled_remove_shape(pntr_tiled_shape_cache* shapes, pntr_tiled_shape* shape) {
+    pntr_tiled_shape** link = shapes->buckets + (shape->hash & (uint64_t)(shapes->bucketCount - 1));
+    while (*link != shape) {
+        link = &(*link)->next;
     }
+    *link = shape->next;
 
-    // TODO: Allow loading images from a base64 embedded image: https://github.com/RobLoach/TiledExportExtensions
-    // Concatenate the baseDir with the image path.
-    char fullPath[PNTR_PATH_MAX];
-    fullPath[0] = '\0';
-    PNTR_STRCAT(fullPath, baseDir);
-    PNTR_STRCAT(fullPath, image->ptr);
-
-    // Replace the image string with a pointer to the new image.
-    image->ptr = (const char*)pntr_load_image(fullPath);
-    if (image->ptr == NULL) {
-        printf("pntr_tiled: Failed to load image: %s", fullPath);
+    if (shape->newer != NULL) {
+        shape->newer->older = shape->older;
     }
-}
-
-static void _pntr_load_tiled_layer_images(cute_tiled_layer_t* layer, const char* baseDir) {
-    if (layer == NULL) {
-        return;
+    else {
+        shapes->newest = shape->older;
     }
-
-    if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
-        _pntr_load_tiled_string_texture(&layer->image, baseDir);
+    if (shape->older != NULL) {
+        shape->older->newer = shape->newer;
     }
-    else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
-        cute_tiled_layer_t* childLayers = layer->layers;
-        while (childLayers) {
-            _pntr_load_tiled_layer_images(childLayers, baseDir);
-            childLayers = childLayers->next;
-        }
+    else {
+        shapes->oldest = shape->newer;
     }
+
+    shapes->size -= shape->size;
+    shapes->count--;
+    pntr_unload_image(shape->image);
+    pntr_unload_memory(shape);
 }
 
-// this grabs external tilesets and injects them as if they are internal
-static void _pntr_tiled_load_external_tilesets(cute_tiled_tileset_t* tileset, const char* baseDir) {
-    if (tileset->source.ptr != NULL) {
-        char fullPath[PNTR_PATH_MAX];
-        fullPath[0] = '\0';
-        PNTR_STRCAT(fullPath, baseDir);
-        PNTR_STRCAT(fullPath, tileset->source.ptr);
+/**
+ * Finds the rasterized image of a rectangle, ellipse or polygon object in the map's cache, rasterizing it when no
+ * object of the same shape, size, rotation and tint was drawn recently. Updates the cache, so only one draw of the map
+ * can be in progress at a time.
+ *
+ * @param cached Set to whether the image is kept in the cache, rather than left for the caller to unload.
+ * @return The image of the object, or NULL on failure.
+ *
+ * @internal
+ * @private
+ */
+static pntr_image* _pntr_tiled_shape_image(pntr_tiled_shape_cache* shapes, cute_tiled_object_t* obj, pntr_color tint, float min_x, float min_y, float max_x, float max_y, bool* cached) {
+    int ellipse = obj->vert_count > 0 ? 0 : obj->ellipse;
+    float width = obj->vert_count > 0 ? 0.0f : obj->width;
+    float height = obj->vert_count > 0 ? 0.0f : obj->height;
+    size_t verticesSize = sizeof(float) * 2 * (size_t)obj->vert_count;
+    uint64_t hash = _pntr_tiled_hash(14695981039346656037ULL, (const unsigned char*)&ellipse, sizeof(ellipse));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)&width, sizeof(width));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)&height, sizeof(height));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)&obj->rotation, sizeof(obj->rotation));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)&tint.value, sizeof(tint.value));
+    hash = _pntr_tiled_hash(hash, (const unsigned char*)obj->vertices, verticesSize);
+
+    // Objects that have changed since they were last drawn no longer match, and their old image ages out.
+    if (shapes->bucketCount > 0) {
+        pntr_tiled_shape* shape = shapes->buckets[hash & (uint64_t)(shapes->bucketCount - 1)];
+        while (shape != NULL && (shape->hash != hash || shape->ellipse != ellipse || shape->width != width ||
+                shape->height != height || shape->rotation != obj->rotation || shape->tint != tint.value ||
+                shape->vertCount != obj->vert_count || (verticesSize > 0 && PNTR_MEMCMP(shape->vertices, obj->vertices, verticesSize) != 0))) {
+            shape = shape->next;
+        }
 
-        int originalFirstgid = tileset->firstgid;
-        cute_tiled_tileset_t* originalNext = tileset->next;
-        
-        unsigned int bytesRead;
-        unsigned char* data = pntr_load_file(fullPath, &bytesRead);
-        if (data != NULL) {
-            cute_tiled_tileset_t* tt = cute_tiled_load_external_tileset_from_memory(data, bytesRead, NULL);
-            if (tt != NULL) {
-                // TODO: is this a memleak? I think it is. How do I do it better?
-                pntr_memory_copy((void*)tileset, (void*)tt, sizeof(cute_tiled_tileset_t));
-                tileset->firstgid = originalFirstgid;
-                tileset->next = originalNext;
+        if (shape != NULL) {
+            // Move it up to the most recently drawn.
+            if (shape->newer != NULL) {
+                shape->newer->older = shape->older;
+                if (shape->older != NULL) {
+                    shape->older->newer = shape->newer;
+                }
+                else {
+                    shapes->oldest = shape->newer;
+                }
+                shape->older = shapes->newest;
+                shape->newer = NULL;
+                shapes->newest->newer = shape;
+                shapes->newest = shape;
             }
-            pntr_unload_file(data);
+
+            *cached = true;
+            return shape->image;
         }
     }
-}
 
-PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_memory(const unsigned char *fileData, unsigned int dataSize, const char* baseDir) {
-    cute_tiled_map_t* map = cute_tiled_load_map_from_memory(fileData, (int)dataSize, 0);
-    if (map == NULL) {
+    *cached = false;
+    pntr_image* image = _pntr_tiled_render_shape(obj, tint, min_x, min_y, max_x, max_y);
+    if (image == NULL) {
         return NULL;
     }
 
-    // Load all the tileset externaal tilesets & any tileset images.
-    cute_tiled_tileset_t* tileset = map->tilesets;
-    while (tileset) {
-        _pntr_tiled_load_external_tilesets(tileset, baseDir);
-        _pntr_load_tiled_string_texture(&tileset->image, baseDir);
-        if (tileset->transparentcolor != 0) {
-            pntr_image_color_replace((pntr_image*)tileset->image.ptr, pntr_tiled_color(tileset->transparentcolor), PNTR_BLANK);
+    // Images larger than the whole cache are drawn once and let go.
+    size_t size = (size_t)image->pitch * (size_t)image->height;
+    if (size > PNTR_TILED_SHAPE_CACHE_SIZE) {
+        return image;
+    }
+
+    // Keep about as many buckets as shapes.
+    if (shapes->count >= shapes->bucketCount) {
+        int bucketCount = shapes->bucketCount > 0 ? shapes->bucketCount * 2 : 64;
+        pntr_tiled_shape** buckets = (pntr_tiled_shape**)pntr_load_memory(sizeof(pntr_tiled_shape*) * (size_t)bucketCount);
+        if (buckets == NULL) {
+            return image;
         }
-        tileset = tileset->next;
+        PNTR_MEMSET(buckets, 0, sizeof(pntr_tiled_shape*) * (size_t)bucketCount);
+        for (pntr_tiled_shape* shape = shapes->newest; shape != NULL; shape = shape->older) {
+            pntr_tiled_shape** bucket = buckets + (shape->hash & (uint64_t)(bucketCount - 1));
+            shape->next = *bucket;
+            *bucket = shape;
+        }
+        pntr_unload_memory(shapes->buckets);
+        shapes->buckets = buckets;
+        shapes->bucketCount = bucketCount;
     }
 
-    // Load all image layers.
-    cute_tiled_layer_t* layer = map->layers;
-    while (layer) {
-        _pntr_load_tiled_layer_images(layer, baseDir);
-        layer = layer->next;
+    // The vertices are copied along with the shape.
+    size_t verticesOffset = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_shape));
+    pntr_tiled_shape* shape = (pntr_tiled_shape*)pntr_load_memory(verticesOffset + verticesSize);
+    if (shape == NULL) {
+        return image;
+    }
+    shape->hash = hash;
+    shape->ellipse = ellipse;
+    shape->width = width;
+    shape->height = height;
+    shape->rotation = obj->rotation;
+    shape->tint = tint.value;
+    shape->vertCount = obj->vert_count;
+    shape->vertices = (float*)((unsigned char*)shape + verticesOffset);
+    if (verticesSize > 0) {
+        pntr_memory_copy(shape->vertices, obj->vertices, verticesSize);
+    }
+    shape->image = image;
+    shape->size = size;
+
+    pntr_tiled_shape** bucket = shapes->buckets + (hash & (uint64_t)(shapes->bucketCount - 1));
+    shape->next = *bucket;
+    *bucket = shape;
+    shape->newer = NULL;
+    shape->older = shapes->newest;
+    if (shapes->newest != NULL) {
+        shapes->newest->newer = shape;
+    }
+    else {
+        shapes->oldest = shape;
     }
+    shapes->newest = shape;
+    shapes->count++;
+    shapes->size += size;
 
-    // Load the individual tiles as subimages.
-    _pntr_load_map_data(map);
+    // Let go of the least recently drawn shapes to make room.
+    while (shapes->size > PNTR_TILED_SHAPE_CACHE_SIZE) {
+        _pntr_tiled_remove_shape(shapes, shapes->oldest);
+    }
 
-    return map;
+    *cached = true;
+    return image;
 }
 
+void static pntr_tiled_draw_object(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_object_t* obj, int posX, int posY, pntr_color tint) {
+    if (obj->gid != 0) {
+        pntr_draw_tiled_tile(dst, map, obj->gid, (int)(obj->x + posX), (int)(obj->y + posY - map->tileheight), tint);
+        return;
+    }
 
-static void _pntr_unload_tiled_layer_images(cute_tiled_layer_t* layer) {
-    if (layer == NULL) {
+    // Rectangles and ellipses, or polygons, drawn from their bounding box.
+    float min_x = 0.0f, min_y = 0.0f, max_x = obj->width, max_y = obj->height;
+    if (obj->vert_count > 0) {
+        if (obj->vert_type != 1 || obj->vertices == NULL) {
+            return;
+        }
+        get_polygon_bounds(obj->vertices, obj->vert_count, &min_x, &min_y, &max_x, &max_y);
+    }
+
+    // Shapes are rasterized once, and drawn from the map's cache from then on.
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    bool cached = false;
+    pntr_image* image = data != NULL ?
+        _pntr_tiled_shape_image(&data->shapes, obj, tint, min_x, min_y, max_x, max_y, &cached) :
+        _pntr_tiled_render_shape(obj, tint, min_x, min_y, max_x, max_y);
+    if (image == NULL) {
         return;
     }
 
-    if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
-        pntr_unload_image((pntr_image*)layer->image.ptr);
-        layer->image.ptr = NULL;
+    // Draw the image from the top left of the shape at (obj->x, obj->y)
+    pntr_draw_image(dst, image, (int)(obj->x + posX + min_x), (int)(obj->y + posY + min_y));
+    if (!cached) {
+        pntr_unload_image(image);
     }
-    else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
-        cute_tiled_layer_t* childLayers = layer->layers;
-        while (childLayers) {
-            _pntr_unload_tiled_layer_images(childLayers);
-            childLayers = childLayers->next;
+}
+
+/**
+ * The area the object covers, from its position, size or vertices, and the tile it is drawn with. Tile objects are
+ * drawn from a tile above their position, and Tiled sizes them up from it, so both are covered. Rotated objects are
+ * given the room they could take up turned about their center, as they are drawn, or about their position, as in
+ * Tiled.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_object_bounds _pntr_tiled_get_object_bounds(cute_tiled_map_t* map, cute_tiled_object_t* obj) {
+    pntr_tiled_object_bounds bounds;
+    if (obj->gid != 0) {
+        int size = map->tilewidth > map->tileheight ? map->tilewidth : map->tileheight;
+        pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+        pntr_tiled_tile* tile = data != NULL ? _pntr_tiled_find_tile(data, cute_tiled_unset_flags(obj->gid)) : NULL;
+        if (tile != NULL && tile->image.data != NULL) {
+            size = tile->image.width > tile->image.height ? tile->image.width : tile->image.height;
+        }
+        else if (tile != NULL && tile->descriptor != NULL && tile->descriptor->image.ptr != NULL) {
+            size = tile->descriptor->imagewidth > tile->descriptor->imageheight ? tile->descriptor->imagewidth : tile->descriptor->imageheight;
         }
+        else if (tile != NULL && tile->tileset != NULL) {
+            size = tile->tileset->tilewidth > tile->tileset->tileheight ? tile->tileset->tilewidth : tile->tileset->tileheight;
+        }
+
+        float top = obj->y - (float)map->tileheight;
+        bounds.left = obj->x;
+        bounds.top = top < obj->y - obj->height ? top : obj->y - obj->height;
+        bounds.right = obj->x + ((float)size > obj->width ? (float)size : obj->width);
+        bounds.bottom = top + (float)size > obj->y ? top + (float)size : obj->y;
+    }
+    else if (obj->vert_count > 0 && obj->vertices != NULL) {
+        float minX, minY, maxX, maxY;
+        get_polygon_bounds(obj->vertices, obj->vert_count, &minX, &minY, &maxX, &maxY);
+        bounds.left = obj->x + minX;
+        bounds.top = obj->y + minY;
+        bounds.right = obj->x + maxX;
+        bounds.bottom = obj->y + maxY;
+    }
+    else {
+        bounds.left = obj->x;
+        bounds.top = obj->y;
+        bounds.right = obj->x + obj->width;
+        bounds.bottom = obj->y + obj->height;
+    }
+
+    if (obj->rotation != 0.0f) {
+        // The corners are no further from the position than the furthest reach across plus the furthest reach down.
+        float left = obj->x - bounds.left > bounds.right - obj->x ? obj->x - bounds.left : bounds.right - obj->x;
+        float top = obj->y - bounds.top > bounds.bottom - obj->y ? obj->y - bounds.top : bounds.bottom - obj->y;
+        float reach = (left > 0.0f ? left : -left) + (top > 0.0f ? top : -top);
+        float size = bounds.right - bounds.left + bounds.bottom - bounds.top;
+        float right = bounds.left + size > obj->x + reach ? bounds.left + size : obj->x + reach;
+        float bottom = bounds.top + size > obj->y + reach ? bounds.top + size : obj->y + reach;
+        bounds.left = bounds.left < obj->x - reach ? bounds.left : obj->x - reach;
+        bounds.top = bounds.top < obj->y - reach ? bounds.top : obj->y - reach;
+        bounds.right = right;
+        bounds.bottom = bottom;
     }
+
+    return bounds;
 }
 
-PNTR_TILED_API void pntr_unload_tiled(cute_tiled_map_t* map) {
-    if (map == NULL) {
-        return;
+/**
+ * Whether any of the object could be drawn within the destination's clipping rectangle.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_object_in_view(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_object_t* obj, int posX, int posY) {
+    pntr_tiled_object_bounds bounds = _pntr_tiled_get_object_bounds(map, obj);
+
+    // Allow a pixel either side for rounding.
+    return bounds.left + (float)posX - 1.0f < (float)(dst->clip.x + dst->clip.width) &&
+        bounds.top + (float)posY - 1.0f < (float)(dst->clip.y + dst->clip.height) &&
+        bounds.right + (float)posX + 1.0f > (float)dst->clip.x &&
+        bounds.bottom + (float)posY + 1.0f > (float)dst->clip.y;
+}
+
+/**
+ * Whether the bounds overlap the area, or when the radius is zero or more, the circle that the area is the bounds of.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_bounds_overlap(pntr_tiled_object_bounds bounds, pntr_tiled_object_bounds area, float radius) {
+    if (bounds.left > area.right || bounds.right < area.left || bounds.top > area.bottom || bounds.bottom < area.top) {
+        return false;
+    }
+    if (radius < 0.0f) {
+        return true;
     }
 
-    // Unload the internal tiles.
-    pntr_unload_memory((void*)map->tiledversion.ptr);
+    // How far the center of the circle is from the nearest point of the bounds.
+    float centerX = area.left + radius;
+    float centerY = area.top + radius;
+    float x = centerX < bounds.left ? bounds.left - centerX : (centerX > bounds.right ? centerX - bounds.right : 0.0f);
+    float y = centerY < bounds.top ? bounds.top - centerY : (centerY > bounds.bottom ? centerY - bounds.bottom : 0.0f);
+    return x * x + y * y <= radius * radius;
+}
 
-    // Unload all images.
-    cute_tiled_tileset_t* tileset = map->tilesets;
-    while (tileset) {
-        pntr_unload_image((pntr_image*)tileset->image.ptr);
-        tileset->image.ptr = NULL;
-        tileset = tileset->next;
+// How many cells an object can cover before it is kept with the objects that are checked by every query instead.
+#ifndef PNTR_TILED_OBJECT_MAX_CELLS
+    #define PNTR_TILED_OBJECT_MAX_CELLS 16
+#endif
+
+/**
+ * Finds the cell of the index that the position along one axis is in, keeping positions outside of the grid in the
+ * cells along its edge.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_object_cell(float position, float origin, float cellSize, int count) {
+    float cell = (position - origin) / cellSize;
+    if (!(cell > 0.0f)) {
+        return 0;
     }
+    if (cell >= (float)count) {
+        return count - 1;
+    }
+    return (int)cell;
+}
 
-    // Unload all the internal raylib data.
-    cute_tiled_layer_t* layer = map->layers;
-    while (layer) {
-        _pntr_unload_tiled_layer_images(layer);
-        layer = layer->next;
+/**
+ * Finds the cells of the index that the entry's bounds cover.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_object_entry_cells(pntr_tiled_object_index* index, pntr_tiled_object_entry* entry) {
+    entry->firstColumn = _pntr_tiled_object_cell(entry->bounds.left, index->originX, index->cellSize, index->columns);
+    entry->firstRow = _pntr_tiled_object_cell(entry->bounds.top, index->originY, index->cellSize, index->rows);
+    entry->lastColumn = _pntr_tiled_object_cell(entry->bounds.right, index->originX, index->cellSize, index->columns);
+    entry->lastRow = _pntr_tiled_object_cell(entry->bounds.bottom, index->originY, index->cellSize, index->rows);
+    if ((entry->lastColumn - entry->firstColumn + 1) * (entry->lastRow - entry->firstRow + 1) > PNTR_TILED_OBJECT_MAX_CELLS) {
+        entry->firstColumn = entry->firstRow = -1;
+        entry->lastColumn = entry->lastRow = -1;
     }
+}
 
-    cute_tiled_free_map(map);
+/**
+ * Adds the entry to the cell, growing the cell's entries when they are full.
+ *
+ * @return True on success, false if the entries could not grow.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_object_cell_add(pntr_tiled_object_cell* cell, int entry) {
+    if (cell->count == cell->capacity) {
+        int capacity = cell->capacity > 0 ? cell->capacity * 2 : 4;
+        int* entries = (int*)pntr_load_memory(sizeof(int) * (size_t)capacity);
+        if (entries == NULL) {
+            return false;
+        }
+        if (cell->count > 0) {
+            pntr_memory_copy(entries, cell->entries, sizeof(int) * (size_t)cell->count);
+        }
+        if (cell->allocated) {
+            pntr_unload_memory(cell->entries);
+        }
+        cell->entries = entries;
+        cell->capacity = capacity;
+        cell->allocated = true;
+    }
+
+    cell->entries[cell->count++] = entry;
+    return true;
 }
 
-PNTR_TILED_API void pntr_draw_tiled_tile(pntr_image* dst, cute_tiled_map_t* map, int gid, int posX, int posY, pntr_color tint) {
-    // Get the clean Tile ID
-    int tileID = cute_tiled_unset_flags(gid);
+/**
+ * Adds the entry to, or removes it from, each cell that it covers.
+ *
+ * @return True on success, false if a cell could not grow.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_tiled_place_object_entry(pntr_tiled_object_index* index, int entry, bool add) {
+    pntr_tiled_object_entry* placed = index->entries + entry;
+    bool oversized = placed->firstColumn < 0;
+    for (int row = oversized ? 0 : placed->firstRow; row <= (oversized ? 0 : placed->lastRow); row++) {
+        for (int column = oversized ? 0 : placed->firstColumn; column <= (oversized ? 0 : placed->lastColumn); column++) {
+            pntr_tiled_object_cell* cell = index->cells + (oversized ? index->columns * index->rows : row * index->columns + column);
+            if (add) {
+                if (!_pntr_tiled_object_cell_add(cell, entry)) {
+                    return false;
+                }
+                continue;
+            }
+
+            for (int i = 0; i < cell->count; i++) {
+                if (cell->entries[i] == entry) {
+                    cell->entries[i] = cell->entries[--cell->count];
+                    break;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Orders object entries by the address of their object.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_object_entries(const void* a, const void* b) {
+    uintptr_t objectA = (uintptr_t)(*(pntr_tiled_object_entry* const*)a)->object;
+    uintptr_t objectB = (uintptr_t)(*(pntr_tiled_object_entry* const*)b)->object;
+    return (objectA > objectB) - (objectA < objectB);
+}
+
+/**
+ * Orders object entries by the name of their object, and then the order of the objects.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_object_names(const void* a, const void* b) {
+    pntr_tiled_object_entry* entryA = *(pntr_tiled_object_entry* const*)a;
+    pntr_tiled_object_entry* entryB = *(pntr_tiled_object_entry* const*)b;
+    int order = PNTR_STRCMP(entryA->object->name.ptr, entryB->object->name.ptr);
+    return order != 0 ? order : (entryA > entryB) - (entryA < entryB);
+}
+
+/**
+ * Finds the index of an object layer, if it has one.
+ *
+ * @internal
+ * @private
+ */
+static pntr_tiled_object_index* _pntr_tiled_object_index(cute_tiled_layer_t* layer) {
+    if (layer == NULL || layer->type.ptr == NULL || PNTR_STRCMP(layer->type.ptr, "objectgroup") != 0) {
+        return NULL;
+    }
+
+    return (pntr_tiled_object_index*)layer->image.ptr;
+}
+
+PNTR_TILED_API bool pntr_tiled_index_objects(cute_tiled_map_t* map, cute_tiled_layer_t* layer) {
+    if (map == NULL || layer == NULL || map->tiledversion.ptr == NULL || layer->type.ptr == NULL || PNTR_STRCMP(layer->type.ptr, "objectgroup") != 0) {
+        return false;
+    }
+
+    // Drop the layer's old index.
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    pntr_tiled_object_index** link = &data->objectIndexes;
+    while (*link != NULL && (*link)->layer != layer) {
+        link = &(*link)->next;
+    }
+    if (*link != NULL) {
+        pntr_tiled_object_index* previous = *link;
+        *link = previous->next;
+        _pntr_tiled_unload_object_index(previous);
+    }
+    layer->image.ptr = NULL;
+
+    int count = 0;
+    for (cute_tiled_object_t* object = layer->objects; object != NULL; object = object->next) {
+        count++;
+    }
 
-    // Get the tile image.
-    pntr_image* tile = pntr_tiled_tile_image(map, tileID);
-    if (tile == NULL) {
-        return;
+    // The entries, and their orders by object and by name, are allocated along with the index.
+    size_t entriesOffset = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_object_index));
+    size_t ordersOffset = entriesOffset + _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_object_entry) * (size_t)count);
+    size_t size = ordersOffset + sizeof(pntr_tiled_object_entry*) * (size_t)count * 2;
+    pntr_tiled_object_index* index = (pntr_tiled_object_index*)pntr_load_memory(size);
+    if (index == NULL) {
+        return false;
     }
+    PNTR_MEMSET(index, 0, size);
+    index->layer = layer;
+    index->entries = (pntr_tiled_object_entry*)((unsigned char*)index + entriesOffset);
+    index->count = count;
+    index->byObject = (pntr_tiled_object_entry**)((unsigned char*)index + ordersOffset);
+    index->byName = index->byObject + count;
+
+    pntr_tiled_object_bounds extent = { 0.0f, 0.0f, 0.0f, 0.0f };
+    int i = 0;
+    for (cute_tiled_object_t* object = layer->objects; object != NULL; object = object->next, i++) {
+        pntr_tiled_object_entry* entry = index->entries + i;
+        entry->object = object;
+        entry->bounds = _pntr_tiled_get_object_bounds(map, object);
+        index->byObject[i] = entry;
+        if (object->name.ptr != NULL) {
+            index->byName[index->nameCount++] = entry;
+        }
 
-    // See if we are to flip the tile in anyway.
-    if (tileID != gid) {
-        // TODO: pntr_draw_tiled_tile: Add flipped tile with tint with pntr_draw_image_flipped_tint
-        pntr_draw_image_flipped(dst, tile,
-            posX, posY,
-            !!(gid & CUTE_TILED_FLIPPED_HORIZONTALLY_FLAG),
-            !!(gid & CUTE_TILED_FLIPPED_VERTICALLY_FLAG),
-            !!(gid & CUTE_TILED_FLIPPED_DIAGONALLY_FLAG)
-        );
+        extent.left = i == 0 || entry->bounds.left < extent.left ? entry->bounds.left : extent.left;
+        extent.top = i == 0 || entry->bounds.top < extent.top ? entry->bounds.top : extent.top;
+        extent.right = i == 0 || entry->bounds.right > extent.right ? entry->bounds.right : extent.right;
+        extent.bottom = i == 0 || entry->bounds.bottom > extent.bottom ? entry->bounds.bottom : extent.bottom;
     }
-    else {
-        pntr_draw_image_tint(dst, tile, posX, posY, tint);
+    qsort(index->byObject, (size_t)count, sizeof(pntr_tiled_object_entry*), _pntr_tiled_compare_object_entries);
+    qsort(index->byName, (size_t)index->nameCount, sizeof(pntr_tiled_object_entry*), _pntr_tiled_compare_object_names);
+
+    // Cells start out a few tiles across, and grow until there are only a few of them for each object.
+    index->originX = extent.left;
+    index->originY = extent.top;
+    index->cellSize = (float)((map->tilewidth > map->tileheight ? map->tilewidth : map->tileheight) * 4);
+    if (index->cellSize < 1.0f) {
+        index->cellSize = 64.0f;
     }
-}
+    for (;;) {
+        float columns = (extent.right - extent.left) / index->cellSize + 1.0f;
+        float rows = (extent.bottom - extent.top) / index->cellSize + 1.0f;
+        if (columns * rows <= (float)count * 4.0f + 64.0f) {
+            index->columns = (int)columns;
+            index->rows = (int)rows;
+            break;
+        }
 
-PNTR_TILED_API void pntr_draw_tiled_layer_tilelayer(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
-    int left, top;
-    for (int y = 0; y < layer->height; y++) {
-        // Only act on tiles within y bounds.
-        top = posY + y * map->tileheight;
-        if (top > dst->height) {
+        // Objects at infinite or invalid positions share a single cell with all the others.
+        if (!(columns * rows > 0.0f) || index->cellSize > 1e30f) {
+            index->columns = index->rows = 1;
             break;
         }
-        if (top + map->tileheight < 0) {
+        index->cellSize *= 2.0f;
+    }
+
+    // Each cell's entries start out within a single allocation, after the cells and the objects that cover too many.
+    int cellCount = index->columns * index->rows + 1;
+    int placements = 0;
+    for (i = 0; i < count; i++) {
+        pntr_tiled_object_entry* entry = index->entries + i;
+        _pntr_tiled_object_entry_cells(index, entry);
+        placements += entry->firstColumn < 0 ? 1 : (entry->lastColumn - entry->firstColumn + 1) * (entry->lastRow - entry->firstRow + 1);
+    }
+    size_t placementsOffset = _PNTR_TILED_ARENA_ALIGN(sizeof(pntr_tiled_object_cell) * (size_t)cellCount);
+    index->cells = (pntr_tiled_object_cell*)pntr_load_memory(placementsOffset + sizeof(int) * (size_t)placements);
+    if (index->cells == NULL) {
+        pntr_unload_memory(index);
+        return false;
+    }
+    PNTR_MEMSET(index->cells, 0, placementsOffset);
+
+    for (i = 0; i < count; i++) {
+        pntr_tiled_object_entry* entry = index->entries + i;
+        if (entry->firstColumn < 0) {
+            index->cells[cellCount - 1].capacity++;
             continue;
         }
-
-        for (int x = 0; x < layer->width; x++) {
-            // Only act on tiles within x bounds.
-            left = posX + x * map->tilewidth;
-            if (left > dst->width) {
-                break;
-            }
-            if (left + map->tilewidth < 0) {
-                continue;
+        for (int row = entry->firstRow; row <= entry->lastRow; row++) {
+            for (int column = entry->firstColumn; column <= entry->lastColumn; column++) {
+                index->cells[row * index->columns + column].capacity++;
             }
-
-            // Draw the tile from the gid.
-            pntr_draw_tiled_tile(dst, map,
-                layer->data[y * layer->width + x],
-                left, top,
-                tint
-            );
         }
     }
-}
-
-PNTR_TILED_API void pntr_draw_tiled_layer_imagelayer(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
-    PNTR_UNUSED(map);
-    pntr_image* image = (pntr_image*)layer->image.ptr;
-
-    if (layer->tintcolor != 0) {
-        tint = pntr_color_alpha_blend(tint,
-            pntr_tiled_color(layer->tintcolor)
-        );
-        tint.rgba.a *= layer->opacity;
+    int* placed = (int*)((unsigned char*)index->cells + placementsOffset);
+    for (i = 0; i < cellCount; i++) {
+        index->cells[i].entries = placed;
+        placed += index->cells[i].capacity;
+    }
+    for (i = 0; i < count; i++) {
+        _pntr_tiled_place_object_entry(index, i, true);
     }
 
-    // TODO: Image layer: Support repeatx and repeaty
-
-    pntr_draw_image_tint(dst, image, posX, posY, tint);
+    index->next = data->objectIndexes;
+    data->objectIndexes = index;
+    layer->image.ptr = (const char*)index;
+    return true;
 }
 
-#ifndef CEILF
-#define CEILF(x) ((int)((x) + 0.999999f))
-#endif
-
-// Helper: get bounding box for polygon
-static void get_polygon_bounds(const float* vertices, int vert_count, float* out_min_x, float* out_min_y, float* out_max_x, float* out_max_y) {
-    float min_x = vertices[0], max_x = vertices[0];
-    float min_y = vertices[1], max_y = vertices[1];
-    for (int i = 1; i < vert_count; ++i) {
-        float x = vertices[i * 2];
-        float y = vertices[i * 2 + 1];
-        if (x < min_x) min_x = x;
-        if (x > max_x) max_x = x;
-        if (y < min_y) min_y = y;
-        if (y > max_y) max_y = y;
+/**
+ * Indexes every object layer among the layers, and within their groups.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_tiled_index_object_layers(cute_tiled_map_t* map, cute_tiled_layer_t* layers) {
+    for (; layers != NULL; layers = layers->next) {
+        if (layers->type.ptr != NULL && PNTR_STRCMP(layers->type.ptr, "group") == 0) {
+            _pntr_tiled_index_object_layers(map, layers->layers);
+        }
+        else {
+            pntr_tiled_index_objects(map, layers);
+        }
     }
-    *out_min_x = min_x;
-    *out_min_y = min_y;
-    *out_max_x = max_x;
-    *out_max_y = max_y;
 }
 
-void static pntr_tiled_draw_object(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_object_t* obj, int posX, int posY, pntr_color tint) {
-    if (obj->gid != 0) {
-        pntr_draw_tiled_tile(dst, map, obj->gid, (int)(obj->x + posX), (int)(obj->y + posY - map->tileheight), tint);
-        return;
+PNTR_TILED_API bool pntr_tiled_update_object(cute_tiled_map_t* map, cute_tiled_layer_t* layer, cute_tiled_object_t* object) {
+    pntr_tiled_object_index* index = _pntr_tiled_object_index(layer);
+    if (map == NULL || index == NULL || object == NULL) {
+        return false;
     }
 
-    // Rectangle or Ellipse
-    if (obj->vert_count == 0) {
-        int shape_w = (int)CEILF(obj->width);
-        int shape_h = (int)CEILF(obj->height);
+    // Find the object's entry from its address.
+    int low = 0;
+    int high = index->count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if ((uintptr_t)index->byObject[middle]->object < (uintptr_t)object) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    if (low == index->count || index->byObject[low]->object != object) {
+        return false;
+    }
 
-        // Create temp image
-        pntr_image* temp = pntr_new_image(shape_w, shape_h);
+    // Only move the entry between cells when it covers different ones.
+    pntr_tiled_object_entry* entry = index->byObject[low];
+    pntr_tiled_object_entry moved = *entry;
+    moved.bounds = _pntr_tiled_get_object_bounds(map, object);
+    _pntr_tiled_object_entry_cells(index, &moved);
+    if (moved.firstColumn == entry->firstColumn && moved.firstRow == entry->firstRow && moved.lastColumn == entry->lastColumn && moved.lastRow == entry->lastRow) {
+        entry->bounds = moved.bounds;
+        return true;
+    }
 
-        if (obj->ellipse) {
-            // Draw ellipse centered in temp image
-            pntr_draw_ellipse_fill(temp, shape_w/2, shape_h/2, shape_w/2, shape_h/2, tint);
-        } else {
-            // Draw rectangle at (0,0)
-            pntr_draw_rectangle_fill(temp, 0, 0, shape_w, shape_h, tint);
-        }
+    _pntr_tiled_place_object_entry(index, (int)(entry - index->entries), false);
+    *entry = moved;
+    return _pntr_tiled_place_object_entry(index, (int)(entry - index->entries), true);
+}
 
-        // Rotate if needed
-        pntr_image* rotated = temp;
-        if (obj->rotation != 0.0f) {
-            rotated = pntr_image_rotate(temp, obj->rotation, PNTR_FILTER_BILINEAR);
-            pntr_unload_image(temp);
+/**
+ * Starts a new query of the index, so that each entry is only come across once. Entries hold the mark of the last
+ * query that came across them, so only one query of the index can be in progress at a time.
+ *
+ * @internal
+ * @private
+ */
+static unsigned int _pntr_tiled_object_index_mark(pntr_tiled_object_index* index) {
+    if (++index->mark == 0) {
+        for (int i = 0; i < index->count; i++) {
+            index->entries[i].mark = 0;
         }
+        index->mark = 1;
+    }
+
+    return index->mark;
+}
 
-        // Draw rotated image centered at (obj->x, obj->y)
-        int draw_x = (int)(obj->x + posX);
-        int draw_y = (int)(obj->y + posY);
-        pntr_draw_image(dst, rotated, draw_x, draw_y);
+/**
+ * Finds the objects of the layer that overlap the area, or the circle within it when the radius is zero or more.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_query_objects(cute_tiled_map_t* map, cute_tiled_layer_t* layer, pntr_tiled_object_bounds area, float radius, cute_tiled_object_t** objects, int maxObjects) {
+    if (map == NULL || layer == NULL) {
+        return 0;
+    }
 
-        if (rotated != temp) {
-            pntr_unload_image(rotated);
+    int found = 0;
+    pntr_tiled_object_index* index = _pntr_tiled_object_index(layer);
+    if (index == NULL) {
+        for (cute_tiled_object_t* object = layer->objects; object != NULL; object = object->next) {
+            if (_pntr_tiled_bounds_overlap(_pntr_tiled_get_object_bounds(map, object), area, radius)) {
+                if (objects != NULL && found < maxObjects) {
+                    objects[found] = object;
+                }
+                found++;
+            }
         }
-        return;
+        return found;
     }
 
-    // Polygon
-    if (obj->vert_type == 1 && obj->vert_count > 0) {
-        // Compute bounding box of polygon
-        float min_x, min_y, max_x, max_y;
-        get_polygon_bounds(obj->vertices, obj->vert_count, &min_x, &min_y, &max_x, &max_y);
-        int shape_w = (int)CEILF(max_x - min_x);
-        int shape_h = (int)CEILF(max_y - min_y);
+    // Visit the cells that the area covers, along with the objects that cover too many cells.
+    unsigned int mark = _pntr_tiled_object_index_mark(index);
+    int firstColumn = _pntr_tiled_object_cell(area.left, index->originX, index->cellSize, index->columns);
+    int firstRow = _pntr_tiled_object_cell(area.top, index->originY, index->cellSize, index->rows);
+    int lastColumn = _pntr_tiled_object_cell(area.right, index->originX, index->cellSize, index->columns);
+    int lastRow = _pntr_tiled_object_cell(area.bottom, index->originY, index->cellSize, index->rows);
+    for (int cell = -1; cell < (lastRow - firstRow + 1) * (lastColumn - firstColumn + 1); cell++) {
+        pntr_tiled_object_cell* visited = index->cells + (cell < 0 ? index->columns * index->rows :
+            (firstRow + cell / (lastColumn - firstColumn + 1)) * index->columns + firstColumn + cell % (lastColumn - firstColumn + 1));
+        for (int i = 0; i < visited->count; i++) {
+            pntr_tiled_object_entry* entry = index->entries + visited->entries[i];
+            if (entry->mark == mark) {
+                continue;
+            }
+            entry->mark = mark;
 
-        // Allocate and shift points to local (0,0) space
-        pntr_vector* points = malloc(sizeof(pntr_vector) * obj->vert_count);
-        for (int i = 0; i < obj->vert_count; ++i) {
-            points[i].x = obj->vertices[i * 2] - min_x;
-            points[i].y = obj->vertices[i * 2 + 1] - min_y;
+            if (_pntr_tiled_bounds_overlap(entry->bounds, area, radius)) {
+                if (objects != NULL && found < maxObjects) {
+                    objects[found] = entry->object;
+                }
+                found++;
+            }
         }
+    }
 
-        // Create temp image
-        pntr_image* temp = pntr_new_image(shape_w, shape_h);
-        pntr_draw_polygon_fill(temp, points, obj->vert_count, tint);
-        pntr_unload_memory(points);
+    return found;
+}
 
-        // Rotate if needed
-        pntr_image* rotated = temp;
-        if (obj->rotation != 0.0f) {
-            rotated = pntr_image_rotate(temp, obj->rotation, PNTR_FILTER_BILINEAR);
-            pntr_unload_image(temp);
-        }
+PNTR_TILED_API int pntr_tiled_query_objects_rect(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, float width, float height, cute_tiled_object_t** objects, int maxObjects) {
+    pntr_tiled_object_bounds area = { x, y, x + width, y + height };
+    return _pntr_tiled_query_objects(map, layer, area, -1.0f, objects, maxObjects);
+}
 
-        // Draw rotated image centered at (obj->x, obj->y)
-        int draw_x = (int)(obj->x + posX + min_x);
-        int draw_y = (int)(obj->y + posY + min_y);
-        pntr_draw_image(dst, rotated, draw_x, draw_y);
+PNTR_TILED_API int pntr_tiled_query_objects_point(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, cute_tiled_object_t** objects, int maxObjects) {
+    pntr_tiled_object_bounds area = { x, y, x, y };
+    return _pntr_tiled_query_objects(map, layer, area, -1.0f, objects, maxObjects);
+}
 
-        if (rotated != temp) {
-            pntr_unload_image(rotated);
-        }
-        return;
+PNTR_TILED_API int pntr_tiled_query_objects_circle(cute_tiled_map_t* map, cute_tiled_layer_t* layer, float x, float y, float radius, cute_tiled_object_t** objects, int maxObjects) {
+    if (radius < 0.0f) {
+        return 0;
     }
+
+    pntr_tiled_object_bounds area = { x - radius, y - radius, x + radius, y + radius };
+    return _pntr_tiled_query_objects(map, layer, area, radius, objects, maxObjects);
 }
 
 // Compare by Y (topdown)
@@ -769,29 +6503,122 @@ static int compare_y(const void* a, const void* b) {
     return (oa->y > ob->y) - (oa->y < ob->y);
 }
 
+/**
+ * Orders the entries of an index the same as the layer's objects.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_object_order(const void* a, const void* b) {
+    pntr_tiled_object_entry* entryA = *(pntr_tiled_object_entry* const*)a;
+    pntr_tiled_object_entry* entryB = *(pntr_tiled_object_entry* const*)b;
+    return (entryA > entryB) - (entryA < entryB);
+}
+
+/**
+ * Orders the entries of an index by the Y of their object, and then the same as the layer's objects.
+ *
+ * @internal
+ * @private
+ */
+static int _pntr_tiled_compare_object_y(const void* a, const void* b) {
+    pntr_tiled_object_entry* entryA = *(pntr_tiled_object_entry* const*)a;
+    pntr_tiled_object_entry* entryB = *(pntr_tiled_object_entry* const*)b;
+    int order = (entryA->object->y > entryB->object->y) - (entryA->object->y < entryB->object->y);
+    return order != 0 ? order : _pntr_tiled_compare_object_order(a, b);
+}
+
+/**
+ * Draws the visible objects of an indexed layer that are within the destination, visiting only the cells in view.
+ *
+ * @return True on success, false if the layer needs to be drawn without its index.
+ *
+ * @internal
+ * @private
+ */
+static bool _pntr_draw_tiled_object_index(pntr_image* dst, cute_tiled_map_t* map, pntr_tiled_object_index* index, int posX, int posY, pntr_color tint, bool ysort) {
+    if (index->count == 0) {
+        return true;
+    }
+    if (index->foundCapacity < index->count) {
+        pntr_tiled_object_entry** found = (pntr_tiled_object_entry**)pntr_load_memory(sizeof(pntr_tiled_object_entry*) * (size_t)index->count);
+        if (found == NULL) {
+            return false;
+        }
+        pntr_unload_memory(index->found);
+        index->found = found;
+        index->foundCapacity = index->count;
+    }
+
+    // Allow a pixel either side for rounding.
+    pntr_tiled_object_bounds area;
+    area.left = (float)(dst->clip.x - posX - 1);
+    area.top = (float)(dst->clip.y - posY - 1);
+    area.right = (float)(dst->clip.x + dst->clip.width - posX + 1);
+    area.bottom = (float)(dst->clip.y + dst->clip.height - posY + 1);
+
+    unsigned int mark = _pntr_tiled_object_index_mark(index);
+    int firstColumn = _pntr_tiled_object_cell(area.left, index->originX, index->cellSize, index->columns);
+    int firstRow = _pntr_tiled_object_cell(area.top, index->originY, index->cellSize, index->rows);
+    int lastColumn = _pntr_tiled_object_cell(area.right, index->originX, index->cellSize, index->columns);
+    int lastRow = _pntr_tiled_object_cell(area.bottom, index->originY, index->cellSize, index->rows);
+    int count = 0;
+    for (int cell = -1; cell < (lastRow - firstRow + 1) * (lastColumn - firstColumn + 1); cell++) {
+        pntr_tiled_object_cell* visited = index->cells + (cell < 0 ? index->columns * index->rows :
+            (firstRow + cell / (lastColumn - firstColumn + 1)) * index->columns + firstColumn + cell % (lastColumn - firstColumn + 1));
+        for (int i = 0; i < visited->count; i++) {
+            pntr_tiled_object_entry* entry = index->entries + visited->entries[i];
+            if (entry->mark != mark) {
+                entry->mark = mark;
+                if (entry->object->visible && _pntr_tiled_object_in_view(dst, map, entry->object, posX, posY)) {
+                    index->found[count++] = entry;
+                }
+            }
+        }
+    }
+
+    // Draw them in the same order as they would be without the index.
+    qsort(index->found, (size_t)count, sizeof(pntr_tiled_object_entry*), ysort ? _pntr_tiled_compare_object_y : _pntr_tiled_compare_object_order);
+    for (int i = 0; i < count; i++) {
+        pntr_tiled_draw_object(dst, map, index->found[i]->object, posX, posY, tint);
+    }
+
+    return true;
+}
+
 PNTR_TILED_API void pntr_draw_tiled_layer_objectlayer(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY, pntr_color tint) {
     // Determine draw order
     const char* draworder = layer->draworder.ptr ? layer->draworder.ptr : "topdown";
     int use_ysort = (layer->class_.ptr != NULL && PNTR_STRCMP(layer->class_.ptr, "ysort") == 0);
 
-    // Count visible objects
-    int count = 0;
-    for (cute_tiled_object_t* o = layer->objects; o; o = o->next){
-        if (o->visible) {
-            count++;
-        }
-    }
-    if (count == 0) {
+    // Indexed layers keep their grid as their image.
+    pntr_tiled_object_index* index = _pntr_tiled_object_index(layer);
+    if (index != NULL && _pntr_draw_tiled_object_index(dst, map, index, posX, posY, tint, use_ysort)) {
         return;
     }
 
     if (use_ysort) {
-        // Collect and sort by Y
+        // Count visible objects
+        int count = 0;
+        for (cute_tiled_object_t* o = layer->objects; o; o = o->next){
+            if (o->visible) {
+                count++;
+            }
+        }
+        if (count == 0) {
+            return;
+        }
+
+        // Collect those within the destination and sort them by Y
         cute_tiled_object_t** arr = pntr_load_memory(count * sizeof(*arr));
+        if (arr == NULL) {
+            return;
+        }
         int i = 0;
         for (cute_tiled_object_t* o = layer->objects; o; o = o->next){
-            if (o->visible) arr[i++] = o;
+            if (o->visible && _pntr_tiled_object_in_view(dst, map, o, posX, posY)) arr[i++] = o;
         }
+        count = i;
         qsort(arr, count, sizeof(*arr), compare_y);
         for (i = 0; i < count; i++) {
             pntr_tiled_draw_object(dst, map, arr[i], posX, posY, tint);
@@ -799,7 +6626,7 @@ PNTR_TILED_API void pntr_draw_tiled_layer_objectlayer(pntr_image* dst, cute_tile
         pntr_unload_memory(arr);
     } else { // "index"
         for (cute_tiled_object_t* o = layer->objects; o; o = o->next){
-            if (o->visible){
+            if (o->visible && _pntr_tiled_object_in_view(dst, map, o, posX, posY)){
                 pntr_tiled_draw_object(dst, map, o, posX, posY, tint);
             }
         }
@@ -878,6 +6705,93 @@ PNTR_TILED_API void pntr_draw_tiled(pntr_image* dst, cute_tiled_map_t* map, int
     pntr_draw_tiled_layer(dst, map, map->layers, posX, posY, tint);
 }
 
+/**
+ * Draws the given layers for pntr_draw_tiled_ex(), moving each one by its group offsets and its parallax factors.
+ *
+ * @internal
+ * @private
+ */
+static void _pntr_draw_tiled_layer_ex(pntr_image* dst, cute_tiled_map_t* map, cute_tiled_layer_t* layer, pntr_rectangle view, float offsetX, float offsetY, float parallaxX, float parallaxY, bool parallax, pntr_color tint) {
+    // Where the center of the view is, which a parallax factor of 0 keeps in place.
+    float centerX = (float)view.x + (float)view.width * 0.5f;
+    float centerY = (float)view.y + (float)view.height * 0.5f;
+
+    for (; layer != NULL; layer = layer->next) {
+        if (layer->type.ptr == NULL || layer->opacity <= 0 || !layer->visible) {
+            continue;
+        }
+
+        // Apply opacity to the layer
+        pntr_color tintWithOpacity = tint;
+        if (layer->opacity != 1) {
+            pntr_color_set_a(&tintWithOpacity, (unsigned char)((float)pntr_color_a(tintWithOpacity) * layer->opacity));
+        }
+
+        float layerOffsetX = offsetX + (float)layer->offsetx;
+        float layerOffsetY = offsetY + (float)layer->offsety;
+        float layerParallaxX = parallax ? parallaxX * layer->parallaxx : 1.0f;
+        float layerParallaxY = parallax ? parallaxY * layer->parallaxy : 1.0f;
+        if (layer->type.ptr[0] == 'g') { // "group"
+            _pntr_draw_tiled_layer_ex(dst, map, layer->layers, view, layerOffsetX, layerOffsetY, layerParallaxX, layerParallaxY, parallax, tintWithOpacity);
+            continue;
+        }
+
+        // Round down to keep layers from jittering as the view crosses 0.
+        float x = layerOffsetX + (float)view.width * 0.5f - centerX * layerParallaxX;
+        float y = layerOffsetY + (float)view.height * 0.5f - centerY * layerParallaxY;
+        int posX = (int)x;
+        int posY = (int)y;
+        posX -= (float)posX > x;
+        posY -= (float)posY > y;
+
+        switch (layer->type.ptr[0]) {
+            case 't': // "tilelayer"
+                pntr_draw_tiled_layer_tilelayer(dst, map, layer, posX, posY, tintWithOpacity);
+            break;
+            case 'o': // "objectgroup"
+                pntr_draw_tiled_layer_objectlayer(dst, map, layer, posX, posY, tintWithOpacity);
+            break;
+            case 'i': // "imagelayer"
+                pntr_draw_tiled_layer_imagelayer(dst, map, layer, posX, posY, tintWithOpacity);
+            break;
+        }
+    }
+}
+
+PNTR_TILED_API void pntr_draw_tiled_ex(pntr_image* dst, cute_tiled_map_t* map, pntr_rectangle view, const pntr_tiled_draw_options* options) {
+    if (dst == NULL || map == NULL) {
+        return;
+    }
+
+    pntr_color tint = PNTR_WHITE;
+    if (options != NULL && options->tint.value != 0) {
+        tint = options->tint;
+    }
+    if (tint.rgba.a == 0) {
+        return;
+    }
+
+    if (view.width <= 0) {
+        view.width = dst->width;
+    }
+    if (view.height <= 0) {
+        view.height = dst->height;
+    }
+
+    // Keep the layers within the view, as well as whatever the destination is already clipped to.
+    pntr_rectangle clip = dst->clip;
+    int right = clip.x + clip.width < view.width ? clip.x + clip.width : view.width;
+    int bottom = clip.y + clip.height < view.height ? clip.y + clip.height : view.height;
+    dst->clip.width = right > clip.x ? right - clip.x : 0;
+    dst->clip.height = bottom > clip.y ? bottom - clip.y : 0;
+
+    if (dst->clip.width > 0 && dst->clip.height > 0) {
+        _pntr_draw_tiled_layer_ex(dst, map, map->layers, view, 0.0f, 0.0f, 1.0f, 1.0f, options == NULL || !options->noParallax, tint);
+    }
+
+    dst->clip = clip;
+}
+
 PNTR_TILED_API void pntr_update_tiled(cute_tiled_map_t* map, float deltaTime) {
     // Update the animation counter
     map->nextlayerid += (int)(deltaTime * 1000);
@@ -936,32 +6850,69 @@ PNTR_TILED_API int pntr_tiled_layer_count(cute_tiled_map_t* map) {
     return count;
 }
 
-PNTR_TILED_API int pntr_layer_tile(cute_tiled_layer_t* layer, int column, int row) {
-    if (layer == NULL || layer->data == NULL) {
-        return 0;
+/**
+ * Retrieves a pointer to the gid of the tile at the given column and row, or NULL if there is no tile there.
+ *
+ * @internal
+ * @private
+ */
+static int* _pntr_layer_tile_gid(cute_tiled_layer_t* layer, int column, int row) {
+    if (layer == NULL) {
+        return NULL;
+    }
+
+    // Infinite maps store their tiles in chunks.
+    if (layer->chunks != NULL) {
+        cute_tiled_chunk_t* chunk = cute_tiled_get_chunk(layer, column, row);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        return chunk->data + (row - chunk->y) * chunk->width + (column - chunk->x);
+    }
+
+    // Columns past the edge would otherwise wrap around into the next row.
+    if (layer->data == NULL || column < 0 || column >= layer->width || row < 0) {
+        return NULL;
     }
 
     int index = row * layer->width + column;
     if (index < 0 || index >= layer->data_count) {
+        return NULL;
+    }
+
+    return layer->data + index;
+}
+
+PNTR_TILED_API int pntr_layer_tile(cute_tiled_layer_t* layer, int column, int row) {
+    int* gid = _pntr_layer_tile_gid(layer, column, row);
+    if (gid == NULL) {
         return 0;
     }
 
     // TODO: Allow getting flip status?
-    return cute_tiled_unset_flags(layer->data[index]);
+    return cute_tiled_unset_flags(*gid);
 }
 
 PNTR_TILED_API void pntr_set_layer_tile(cute_tiled_layer_t* layer, int column, int row, int gid) {
-    if (layer == NULL || layer->data == NULL || gid < 0) {
+    if (gid < 0) {
         return;
     }
 
-    int index = row * layer->width + column;
-    if (index >= layer->data_count || index < 0) {
+    int* tile = _pntr_layer_tile_gid(layer, column, row);
+    if (tile == NULL) {
         return;
     }
 
     // TODO: Add flip status to set_tiled_tile_at()
-    layer->data[index] = gid;
+    if (*tile == gid) {
+        return;
+    }
+    *tile = gid;
+
+    // Prerendered layers only render the chunks that the tile covers again.
+    if (layer->image.ptr != NULL && PNTR_STRCMP(layer->type.ptr, "tilelayer") == 0) {
+        _pntr_tiled_mark_layer_cache((pntr_tiled_layer_cache*)layer->image.ptr, column, row);
+    }
 }
 
 PNTR_TILED_API pntr_vector pntr_layer_tile_from_position(cute_tiled_map_t* map, cute_tiled_layer_t* layer, int posX, int posY) {
@@ -996,6 +6947,24 @@ PNTR_TILED_API cute_tiled_object_t* pntr_tiled_get_object(cute_tiled_layer_t* ob
   if (objects_layer == NULL || objects_layer->objects == NULL) {
     return NULL;
   }
+
+  // Indexed layers keep their objects sorted by name.
+  pntr_tiled_object_index* index = _pntr_tiled_object_index(objects_layer);
+  if (index != NULL && name != NULL) {
+    int low = 0;
+    int high = index->nameCount;
+    while (low < high) {
+      int middle = low + (high - low) / 2;
+      if (PNTR_STRCMP(index->byName[middle]->object->name.ptr, name) < 0) {
+        low = middle + 1;
+      }
+      else {
+        high = middle;
+      }
+    }
+    return low < index->nameCount && PNTR_STRCMP(index->byName[low]->object->name.ptr, name) == 0 ? index->byName[low]->object : NULL;
+  }
+
   cute_tiled_object_t* current = objects_layer->objects;
   while (current != NULL) {
     if (current->name.ptr != NULL && strcmp(current->name.ptr, name) == 0) {
@@ -1006,6 +6975,49 @@ PNTR_TILED_API cute_tiled_object_t* pntr_tiled_get_object(cute_tiled_layer_t* ob
   return NULL;
 }
 
+PNTR_TILED_API bool pntr_tiled_get_memory_stats(cute_tiled_map_t* map, cute_tiled_memory_stats_t* stats) {
+    if (map == NULL || stats == NULL) {
+        return false;
+    }
+
+    pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+    if (data != NULL && data->baked != NULL) {
+        return false;
+    }
+
+    cute_tiled_get_memory_stats(map, stats);
+
+    // Injected external tilesets keep their own pages.
+    cute_tiled_tileset_t* tileset = map->tilesets;
+    while (tileset) {
+        if (tileset->_internal != NULL) {
+            cute_tiled_memory_stats_t tilesetStats;
+            cute_tiled_get_memory_stats(&((cute_tiled_map_internal_t*)tileset->_internal)->map, &tilesetStats);
+            stats->page_count += tilesetStats.page_count;
+            stats->page_bytes += tilesetStats.page_bytes;
+            stats->large_block_count += tilesetStats.large_block_count;
+            stats->large_block_bytes += tilesetStats.large_block_bytes;
+            stats->bytes_wasted += tilesetStats.bytes_wasted;
+        }
+        tileset = tileset->next;
+    }
+
+    // Reloads keep the pages of their parse.
+    cute_tiled_map_t* generation = data != NULL ? data->generations : NULL;
+    while (generation) {
+        cute_tiled_memory_stats_t generationStats;
+        cute_tiled_get_memory_stats(generation, &generationStats);
+        stats->page_count += generationStats.page_count;
+        stats->page_bytes += generationStats.page_bytes;
+        stats->large_block_count += generationStats.large_block_count;
+        stats->large_block_bytes += generationStats.large_block_bytes;
+        stats->bytes_wasted += generationStats.bytes_wasted;
+        generation = (cute_tiled_map_t*)generation->tiledversion.ptr;
+    }
+
+    return true;
+}
+
 /**
  * Integrations
  */
@@ -44,6 +44,16 @@
  */
 PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys, const char* fileName);
 
+/**
+ * Reads files from assetsys, to use as the io of pntr_load_tiled_ex().
+ *
+ * assetsys is not thread safe, so maps loaded through it should not set a threadCount.
+ *
+ * @param sys The assetsys to read from, which must outlive the maps loaded through it.
+ * @return The io, which needs no unloading.
+ */
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_assetsys(assetsys_t* sys);
+
 #endif  // PNTR_TILED_ASSETSYS_H__
 
 #ifdef PNTR_TILED_IMPLEMENTATION
@@ -51,88 +61,62 @@ PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys,
 #define PNTR_TILED_ASSETSYS_IMPLEMENTATION_ONCE
 
 /**
- * Load the given cute_tiled_string_t image as a pntr_image.
+ * Opens the given file from assetsys, as a copy of its assetsys_file_t.
  *
  * @internal
  * @private
  */
-void _pntr_load_tiled_assetsys_string_texture(assetsys_t* sys, cute_tiled_string_t* image, const char* baseDir) {
-    if (sys == NULL || image == NULL || image->ptr == NULL) {
-        return;
+static void* _pntr_tiled_io_assetsys_open(const char* fileName, void* userData) {
+    assetsys_file_t file;
+    if (assetsys_file((assetsys_t*)userData, fileName, &file) != ASSETSYS_SUCCESS) {
+        return NULL;
     }
 
-    char fullPath[PNTR_PATH_MAX];
-    fullPath[0] = '\0';
-    PNTR_STRCAT(fullPath, baseDir);
-    PNTR_STRCAT(fullPath, image->ptr);
-
-    image->ptr = (const char*)pntr_load_image_from_assetsys(sys, fullPath);
-}
-
-/**
- * Load the given layer images from assetsys.
- *
- * @internal
- * @private
- */
-void _pntr_load_tiled_layer_images_from_assetsys(assetsys_t* sys, cute_tiled_layer_t* layer, const char* baseDir) {
-    if (layer == NULL || sys == NULL) {
-        return;
+    assetsys_file_t* handle = (assetsys_file_t*)pntr_load_memory(sizeof(assetsys_file_t));
+    if (handle != NULL) {
+        *handle = file;
     }
 
-    if (PNTR_STRCMP(layer->type.ptr, "imagelayer") == 0) {
-        _pntr_load_tiled_assetsys_string_texture(sys, &layer->image, baseDir);
-    }
-    else if (PNTR_STRCMP(layer->type.ptr, "group") == 0) {
-        cute_tiled_layer_t* childLayers = layer->layers;
-        while (childLayers) {
-            _pntr_load_tiled_layer_images_from_assetsys(sys, childLayers, baseDir);
-            childLayers = childLayers->next;
-        }
-    }
+    return handle;
 }
 
-PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys, const char* fileName) {
-    unsigned int size;
-    unsigned char* data = pntr_load_file_from_assetsys(sys, fileName, &size);
-    if (data == NULL) {
-        return NULL;
-    }
+static unsigned int _pntr_tiled_io_assetsys_size(void* file, void* userData) {
+    int size = assetsys_file_size((assetsys_t*)userData, *(assetsys_file_t*)file);
+    return size > 0 ? (unsigned int)size : 0;
+}
 
-    cute_tiled_map_t* map = cute_tiled_load_map_from_memory(data, (int)size, 0);
-    pntr_unload_memory(data);
-    if (map == NULL) {
-        return NULL;
-    }
+static bool _pntr_tiled_io_assetsys_read(void* file, unsigned char* buffer, unsigned int size, void* userData) {
+    int loaded = 0;
+    return assetsys_file_load((assetsys_t*)userData, *(assetsys_file_t*)file, &loaded, (void*)buffer, (int)size) == ASSETSYS_SUCCESS && loaded == (int)size;
+}
 
-    // Copy the fileName, along with its null terminator to find the basePath.
-    char baseDir[PNTR_PATH_MAX];
-    size_t fileNameLength = PNTR_STRLEN(fileName);
-    pntr_memory_copy((void*)baseDir, (void*)fileName, fileNameLength);
-    baseDir[fileNameLength] = '\0';
-    _pntr_tiled_path_basedir(baseDir);
+static void _pntr_tiled_io_assetsys_close(void* file, void* userData) {
+    PNTR_UNUSED(userData);
+    pntr_unload_memory(file);
+}
 
-    // Tilesets
-    cute_tiled_tileset_t* tileset = map->tilesets;
-    while (tileset) {
-        _pntr_load_tiled_assetsys_string_texture(sys, &tileset->image, baseDir);
-        if (tileset->transparentcolor != 0) {
-            pntr_image_color_replace((pntr_image*)tileset->image.ptr, pntr_tiled_color(tileset->transparentcolor), PNTR_BLANK);
-        }
-        tileset = tileset->next;
-    }
+PNTR_TILED_API pntr_tiled_io pntr_tiled_io_assetsys(assetsys_t* sys) {
+    pntr_tiled_io io;
+    PNTR_MEMSET(&io, 0, sizeof(io));
+    io.open = _pntr_tiled_io_assetsys_open;
+    io.size = _pntr_tiled_io_assetsys_size;
+    io.read = _pntr_tiled_io_assetsys_read;
+    io.close = _pntr_tiled_io_assetsys_close;
+    io.userData = (void*)sys;
+    return io;
+}
 
-    // Load all image layers.
-    cute_tiled_layer_t* layer = map->layers;
-    while (layer) {
-        _pntr_load_tiled_layer_images_from_assetsys(sys, layer, baseDir);
-        layer = layer->next;
+PNTR_TILED_API cute_tiled_map_t* pntr_load_tiled_from_assetsys(assetsys_t* sys, const char* fileName) {
+    if (sys == NULL) {
+        return NULL;
     }
 
-    // Build the tile global IDs as subimages.
-    _pntr_load_map_data(map);
-
-    return map;
+    // Loads the same as any other map, including its external tilesets.
+    pntr_tiled_io io = pntr_tiled_io_assetsys(sys);
+    pntr_tiled_load_options options;
+    PNTR_MEMSET(&options, 0, sizeof(options));
+    options.io = &io;
+    return pntr_load_tiled_ex(fileName, &options);
 }
 
 #endif
@@ -7,12 +7,169 @@
 // #define PNTR_ASSETSYS_IMPLEMENTATION
 // #include "pntr_assetsys.h"
 
+// Counts cute_tiled's warnings, rather than printing them
+static int test_warnings = 0;
+#define CUTE_TILED_WARNING(msg) test_warnings++
+
+#define PNTR_TILED_THREADS
+#define PNTR_TILED_SHAPE_CACHE_SIZE (64 * 1024) // Small enough for the tests to fill
 #define PNTR_TILED_IMPLEMENTATION
 #include "pntr_tiled.h"
 
 // Assertion library
 #include "pntr_assert.h"
 
+static int test_allocations = 0;
+static int test_frees = 0;
+
+static void* test_alloc(size_t size, void* userData) {
+    (void)userData;
+    test_allocations++;
+    return pntr_load_memory(size);
+}
+
+static void test_free(void* ptr, void* userData) {
+    (void)userData;
+    test_frees++;
+    pntr_unload_memory(ptr);
+}
+
+static int test_filtered = 0;
+
+static bool test_layer_filter(const char* name, const char* type, void* userData) {
+    test_filtered++;
+    return PNTR_STRCMP(name, (const char*)userData) == 0 || PNTR_STRCMP(type, "imagelayer") == 0;
+}
+
+static int test_io_opens = 0;
+static int test_io_reads = 0;
+
+static void* test_io_open(const char* fileName, void* userData) {
+    const pntr_tiled_io* io = (const pntr_tiled_io*)userData;
+    test_io_opens++;
+    return io->open(fileName, io->userData);
+}
+
+static unsigned int test_io_size(void* file, void* userData) {
+    const pntr_tiled_io* io = (const pntr_tiled_io*)userData;
+    return io->size(file, io->userData);
+}
+
+static unsigned char* test_io_map(void* file, bool writable, void* userData) {
+    const pntr_tiled_io* io = (const pntr_tiled_io*)userData;
+    return io->map(file, writable, io->userData);
+}
+
+static bool test_io_read(void* file, unsigned char* buffer, unsigned int size, void* userData) {
+    const pntr_tiled_io* io = (const pntr_tiled_io*)userData;
+    test_io_reads++;
+    return io->read(file, buffer, size, io->userData);
+}
+
+static void test_io_close(void* file, void* userData) {
+    const pntr_tiled_io* io = (const pntr_tiled_io*)userData;
+    io->close(file, io->userData);
+}
+
+static void test_pack_file(pntr_tiled_pack_file* file, const char* fileName) {
+    unsigned int size = 0;
+    unsigned char* data = pntr_load_file(fileName, &size);
+    assert(data != NULL);
+
+    // Null terminated, so the byte after the file is readable.
+    unsigned char* terminated = (unsigned char*)pntr_load_memory(size + 1);
+    memcpy(terminated, data, size);
+    terminated[size] = '\0';
+    pntr_unload_file(data);
+
+    file->fileName = fileName;
+    file->data = terminated;
+    file->size = size;
+}
+
+#ifdef PNTR_TILED_THREADS
+typedef struct test_stress {
+    int index;
+    pntr_tiled_cache* cache;
+    cute_tiled_layer_t* expected;
+    int failures;
+} test_stress;
+
+static void* test_stress_thread(void* userData) {
+    test_stress* stress = (test_stress*)userData;
+
+    for (int i = 0; i < 8; i++) {
+        pntr_tiled_error error;
+        pntr_tiled_load_options options = {0};
+        options.error = &error;
+        options.inPlace = (i & 1) != 0;
+        options.cache = (i & 2) != 0 ? stress->cache : NULL;
+
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        cute_tiled_layer_t* layer = pntr_tiled_layer(map, "Plants");
+        if (map == NULL || error.reason != NULL || layer == NULL || layer->data_count != stress->expected->data_count ||
+            memcmp(layer->data, stress->expected->data, sizeof(int) * (size_t)layer->data_count) != 0) {
+            stress->failures++;
+        }
+        pntr_unload_tiled(map);
+
+        if (pntr_load_tiled_ex("resources/non-existant.tmj", &options) != NULL || error.reason == NULL ||
+            strstr(error.reason, "non-existant.tmj") == NULL) {
+            stress->failures++;
+        }
+    }
+
+    // Each thread fails on a different line, and sees only its own error.
+    char json[64];
+    int length = 0;
+    for (int i = 0; i < stress->index; i++) {
+        json[length++] = '\n';
+    }
+    length += snprintf(json + length, sizeof(json) - (size_t)length, "{\"width\"? 1}");
+
+    cute_tiled_error_t error;
+    cute_tiled_load_options_t options = {0};
+    options.error = &error;
+    if (cute_tiled_load_map_from_memory_ex(json, length, &options, NULL) != NULL || error.reason == NULL ||
+        error.line != stress->index + 1 || strstr(error.reason, "?") == NULL) {
+        stress->failures++;
+    }
+
+    return NULL;
+}
+#endif
+
+static bool test_draws_equal_size(cute_tiled_map_t* map, cute_tiled_map_t* reference, int posX, int posY, int width, int height) {
+    pntr_image* actual = pntr_gen_image_color(width, height, PNTR_BLACK);
+    pntr_image* expected = pntr_gen_image_color(width, height, PNTR_BLACK);
+    assert(actual != NULL && expected != NULL);
+    pntr_draw_tiled(actual, map, posX, posY, PNTR_WHITE);
+    pntr_draw_tiled(expected, reference, posX, posY, PNTR_WHITE);
+
+    bool equal = true;
+    for (int y = 0; y < actual->height && equal; y++) {
+        for (int x = 0; x < actual->width && equal; x++) {
+            equal = pntr_image_get_color(actual, x, y).value == pntr_image_get_color(expected, x, y).value;
+        }
+    }
+
+    pntr_unload_image(actual);
+    pntr_unload_image(expected);
+    return equal;
+}
+
+static bool test_draws_equal(cute_tiled_map_t* map, cute_tiled_map_t* reference, int posX, int posY) {
+    return test_draws_equal_size(map, reference, posX, posY, 300, 200);
+}
+
+static int test_query_ids(cute_tiled_object_t** objects, int count) {
+    int ids = 0;
+    for (int i = 0; i < count; i++) {
+        ids += objects[i]->id * objects[i]->id;
+    }
+    return ids;
+}
+
 int main() {
     // pntr_load_tiled()
     {
@@ -51,6 +208,10 @@ int main() {
             assert(gid == 39);
             gid = pntr_layer_tile(layer, 2, 6);
             assert(gid == 38);
+
+            // Columns past the edge do not wrap around into the next row.
+            assert(pntr_layer_tile(layer, 16 + 8, 1) == 0);
+            assert(pntr_layer_tile(layer, -8, 3) == 0);
         }
 
         // pntr_set_layer_tile()
@@ -81,6 +242,35 @@ int main() {
             assert(pntr_tiled_layer_count(map) == 4);
         }
 
+        // pntr_tiled_tile_image()
+        {
+            // Tiles are views into their tileset image, 32x32 with 1 pixel of margin and spacing.
+            pntr_image* tileset = (pntr_image*)map->tilesets->image.ptr;
+            pntr_image* tile = pntr_tiled_tile_image(map, 10);
+            assert(tile != NULL);
+            assert(tile->subimage);
+            assert(tile->width == 32 && tile->height == 32);
+            assert(tile->pitch == tileset->pitch);
+            assert(tile->data == (pntr_color*)((unsigned char*)tileset->data + 34 * tileset->pitch) + 34);
+
+            // Only the animated tile has a descriptor, which carries the full animation length.
+            pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+            for (int gid = 1; gid <= data->tileCount; gid++) {
+                assert((data->tiles[gid - 1].descriptor != NULL) == (gid == 38));
+            }
+            assert(data->tiles[37].animationDuration == 1000);
+        }
+
+        // pntr_tiled_get_memory_stats()
+        {
+            cute_tiled_memory_stats_t stats;
+            assert(pntr_tiled_get_memory_stats(map, &stats));
+            assert(stats.page_count >= 1);
+            assert(stats.page_bytes >= CUTE_TILED_PAGE_SIZE);
+            assert(stats.bytes_wasted >= 0 && stats.bytes_wasted < stats.page_bytes);
+            assert(!pntr_tiled_get_memory_stats(NULL, &stats));
+        }
+
         // pntr_tiled_layer_from_index()
         {
             cute_tiled_layer_t* layer = pntr_tiled_layer_from_index(map, 2);
@@ -96,6 +286,1468 @@ int main() {
         pntr_unload_tiled(map);
     }
 
+    // Tilesets with gaps between their gids, out of order, and with huge firstgids.
+    {
+        #define TEST_GIDS_TILESET(firstgid, tiles) "{\"columns\":8,\"firstgid\":" #firstgid ",\"image\":\"tmw_desert_spacing.png\"," \
+            "\"imageheight\":199,\"imagewidth\":265,\"margin\":1,\"name\":\"Desert\",\"spacing\":1,\"tilecount\":48," \
+            "\"tileheight\":32,\"tilewidth\":32" tiles "}"
+        const char* json = "{\"height\":1,\"width\":3,\"tilewidth\":32,\"tileheight\":32,\"orientation\":\"orthogonal\","
+            "\"renderorder\":\"right-down\",\"type\":\"map\",\"infinite\":false,\"layers\":[{\"data\":[10,109,200000009],"
+            "\"height\":1,\"width\":3,\"id\":1,\"name\":\"Tiles\",\"opacity\":1,\"type\":\"tilelayer\",\"visible\":true,\"x\":0,\"y\":0}],"
+            "\"tilesets\":["
+            TEST_GIDS_TILESET(200000000, ",\"tiles\":[{\"id\":37,\"animation\":[{\"tileid\":37,\"duration\":500},{\"tileid\":39,\"duration\":500}]}]") ","
+            TEST_GIDS_TILESET(1, "") ","
+            TEST_GIDS_TILESET(100, "")
+            "]}";
+        #undef TEST_GIDS_TILESET
+
+        cute_tiled_map_t* map = pntr_load_tiled_from_memory((const unsigned char*)json, (unsigned int)strlen(json), "resources/");
+        assert(map != NULL);
+
+        // Only the tiles themselves take up room in the table.
+        pntr_tiled_map_data* data = (pntr_tiled_map_data*)map->tiledversion.ptr;
+        assert(data->tileCount == 48 * 3);
+        assert(data->rangeCount == 3);
+        assert(data->directCount == 48);
+
+        assert(pntr_tiled_tile_image(map, 0) == NULL);
+        assert(pntr_tiled_tile_image(map, -1) == NULL);
+        assert(pntr_tiled_tile_image(map, 1) != NULL);
+        assert(pntr_tiled_tile_image(map, 48) != NULL);
+        assert(pntr_tiled_tile_image(map, 49) == NULL);
+        assert(pntr_tiled_tile_image(map, 99) == NULL);
+        assert(pntr_tiled_tile_image(map, 100) != NULL);
+        assert(pntr_tiled_tile_image(map, 147) != NULL);
+        assert(pntr_tiled_tile_image(map, 148) == NULL);
+        assert(pntr_tiled_tile_image(map, 199999999) == NULL);
+        assert(pntr_tiled_tile_image(map, 200000047) != NULL);
+        assert(pntr_tiled_tile_image(map, 200000048) == NULL);
+
+        // Each gid finds the same tile within its own tileset.
+        cute_tiled_tileset_t* tileset = map->tilesets;
+        while (tileset) {
+            pntr_image* image = (pntr_image*)tileset->image.ptr;
+            pntr_image* tile = pntr_tiled_tile_image(map, tileset->firstgid + 9);
+            assert(tile->data == (pntr_color*)((unsigned char*)image->data + 34 * image->pitch) + 34);
+
+            // Animations stay within their tileset.
+            if (tileset->firstgid == 200000000) {
+                tile = pntr_tiled_tile_image(map, tileset->firstgid + 37);
+                assert(tile == pntr_tiled_tile_image(map, tileset->firstgid + 37) && tile->data != NULL);
+                assert(tile->data >= image->data && (unsigned char*)tile->data < (unsigned char*)image->data + image->height * image->pitch);
+            }
+            tileset = tileset->next;
+        }
+
+        // All three tiles draw the same.
+        pntr_image* image = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(image != NULL && image->width == 96);
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 32; x++) {
+                assert(pntr_image_get_color(image, x, y).value == pntr_image_get_color(image, x + 32, y).value);
+                assert(pntr_image_get_color(image, x, y).value == pntr_image_get_color(image, x + 64, y).value);
+            }
+        }
+        pntr_unload_image(image);
+        pntr_unload_tiled(map);
+    }
+
+    // pntr_load_tiled_mapped()
+    {
+        cute_tiled_map_t* map = pntr_load_tiled_mapped("resources/pntr_tiled_test.tmj");
+        assert(map != NULL);
+        assert(pntr_tiled_layer_count(map) == 4);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        assert(pntr_load_tiled_mapped("resources/non-existant.tmj") == NULL);
+    }
+
+    // pntr_load_tiled_ex()
+    {
+        pntr_tiled_load_options options = {0};
+        options.threadCount = 4;
+        cute_tiled_map_t* serial = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(serial != NULL);
+        assert(map != NULL);
+        assert(pntr_tiled_layer(map, "Image Layer")->image.ptr != NULL);
+
+        // Loading across threads is identical to loading serially.
+        pntr_image* expected = pntr_gen_image_tiled(serial, PNTR_WHITE);
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(expected != NULL);
+        assert(actual != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+
+        pntr_unload_tiled(serial);
+        pntr_unload_tiled(map);
+
+        assert(pntr_load_tiled_ex("resources/non-existant.tmj", &options) == NULL);
+    }
+
+    // pntr_tiled_io_pack()
+    {
+        pntr_tiled_pack_file files[3];
+        test_pack_file(files + 0, "resources/pntr_tiled_test.tmj");
+        test_pack_file(files + 1, "resources/tmw_desert_spacing.png");
+        test_pack_file(files + 2, "resources/logo.png");
+        pntr_tiled_pack pack = { files, 3 };
+
+        // Count the calls through to the pack.
+        pntr_tiled_io packIO = pntr_tiled_io_pack(&pack);
+        pntr_tiled_io io = { test_io_open, test_io_size, test_io_map, test_io_read, test_io_close, &packIO };
+        pntr_tiled_load_options options = {0};
+        options.io = &io;
+
+        // The map and both images are read straight from the pack.
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_io_opens == 3);
+        assert(test_io_reads == 0);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Parsing in place writes to the map, so it is read into memory instead.
+        options.inPlace = true;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_io_opens == 6);
+        assert(test_io_reads == 1);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        pntr_unload_tiled(map);
+
+        // Lazy images load through the io too.
+        options.inPlace = false;
+        options.lazyImages = true;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_io_opens == 8);
+        assert(pntr_tiled_tile_image(map, 39)->data != NULL);
+        assert(test_io_opens == 9);
+        pntr_unload_tiled(map);
+
+        // A lazy tileset image that is not found is only looked for once, and its tiles have no image.
+        pntr_tiled_pack_file withoutTileset[] = { files[0], files[2] };
+        pntr_tiled_pack partial = { withoutTileset, 2 };
+        packIO.userData = &partial;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_io_opens == 11);
+        assert(pntr_tiled_tile_image(map, 39) == NULL);
+        assert(pntr_tiled_tile_image(map, 39) == NULL);
+        assert(pntr_tiled_tile_image(map, 1) == NULL);
+        assert(!pntr_tiled_preload_tilesets(map));
+        assert(test_io_opens == 12);
+        pntr_unload_tiled(map);
+        packIO.userData = &pack;
+
+        // Files outside of the pack are not found.
+        assert(pntr_load_tiled_ex("resources/pntr_tiled_test_base64.tmj", &options) == NULL);
+
+        for (int i = 0; i < 3; i++) {
+            pntr_unload_memory((void*)files[i].data);
+        }
+    }
+
+    // pntr_load_tiled_async()
+    {
+        pntr_tiled_load_options options = {0};
+        options.threadCount = 2;
+        pntr_tiled_loading* loading = pntr_load_tiled_async("resources/pntr_tiled_test.tmj", &options);
+        assert(loading != NULL);
+
+        // Progress only moves forward, through each stage.
+        float progress = 0.0f;
+        float lastProgress = 0.0f;
+        pntr_tiled_load_stage stage;
+        while ((stage = pntr_tiled_load_poll(loading, &progress)) < PNTR_TILED_LOAD_DONE) {
+            assert(progress >= lastProgress && progress < 1.0f);
+            lastProgress = progress;
+        }
+        assert(stage == PNTR_TILED_LOAD_DONE);
+        assert(progress == 1.0f);
+
+        cute_tiled_map_t* map = pntr_tiled_load_wait(loading);
+        assert(map != NULL);
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Waiting without polling.
+        map = pntr_tiled_load_wait(pntr_load_tiled_async("resources/pntr_tiled_test.tmj", NULL));
+        assert(map != NULL);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        pntr_unload_tiled(map);
+
+        // Cancelling frees whatever was loaded so far, at any stage.
+        options.inPlace = true;
+        options.cache = pntr_load_tiled_cache();
+        for (int polls = 0; polls < 8; polls++) {
+            loading = pntr_load_tiled_async("resources/pntr_tiled_test.tmj", &options);
+            assert(loading != NULL);
+            for (int i = 0; i < polls; i++) {
+                pntr_tiled_load_poll(loading, NULL);
+            }
+            pntr_tiled_load_cancel(loading);
+
+            // Everything taken from the cache went back to it.
+            assert(options.cache->entries == NULL);
+        }
+        pntr_unload_tiled_cache(options.cache);
+
+        // Failing to load
+        loading = pntr_load_tiled_async("resources/non-existant.tmj", NULL);
+        assert(loading != NULL);
+        while (pntr_tiled_load_poll(loading, NULL) < PNTR_TILED_LOAD_DONE) {}
+        assert(pntr_tiled_load_poll(loading, NULL) == PNTR_TILED_LOAD_FAILED);
+        assert(pntr_tiled_load_wait(loading) == NULL);
+        assert(pntr_load_tiled_async(NULL, NULL) == NULL);
+    }
+
+    // pntr_tiled_error
+    {
+        pntr_tiled_error error;
+        pntr_tiled_load_options options = {0};
+        options.error = &error;
+
+        assert(pntr_load_tiled_ex("resources/non-existant.tmj", &options) == NULL);
+        assert(error.reason != NULL);
+        assert(strstr(error.reason, "resources/non-existant.tmj") != NULL);
+        assert(error.line == 0);
+
+        // Parse errors point to the line of the JSON.
+        const char* broken = "{\n\"width\": 2,\n\"height\" 2\n}";
+        assert(pntr_save_file("resources/pntr_tiled_test_broken.tmj", broken, (unsigned int)strlen(broken)));
+        assert(pntr_load_tiled_ex("resources/pntr_tiled_test_broken.tmj", &options) == NULL);
+        assert(error.reason != NULL);
+        assert(strstr(error.reason, "pntr_tiled_test_broken.tmj:3:") != NULL);
+        assert(error.line == 3);
+        remove("resources/pntr_tiled_test_broken.tmj");
+
+        // Failures are only printed when there is nowhere to report them.
+        int warnings = test_warnings;
+        cute_tiled_error_t parseError;
+        cute_tiled_load_options_t parseOptions;
+        PNTR_MEMSET(&parseOptions, 0, sizeof(parseOptions));
+        parseOptions.error = &parseError;
+        assert(cute_tiled_load_map_from_memory_ex((void*)broken, (int)strlen(broken), &parseOptions, NULL) == NULL);
+        assert(parseError.line == 3);
+        assert(test_warnings == warnings);
+        assert(cute_tiled_load_map_from_memory(broken, (int)strlen(broken), NULL) == NULL);
+        assert(test_warnings == warnings + 1);
+
+        // Lines inside CSV tile data count too, both for errors within it and after it.
+        const char* csv[] = {
+            "{\"layers\":[{\"data\":[1,\n2,\n3,\nx],\n\"width\":2}]}",
+            "{\"layers\":[{\"data\":[1,\n2,\n3,\n4],\n\"width\" 2}]}",
+            "{\"layers\":[{\"data\":[1,\n2,\n3,\n4,\n"
+        };
+        const int csvLines[] = { 4, 5, 5 };
+        for (int i = 0; i < 3; i++) {
+            assert(pntr_save_file("resources/pntr_tiled_test_broken.tmj", csv[i], (unsigned int)strlen(csv[i])));
+            assert(pntr_load_tiled_ex("resources/pntr_tiled_test_broken.tmj", &options) == NULL);
+            assert(error.line == csvLines[i]);
+        }
+        remove("resources/pntr_tiled_test_broken.tmj");
+
+        // Malformed external tilesets are reported with their line, whether parsed in place or not.
+        const char* external =
+            "{\"width\": 1, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32,\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"source\": \"pntr_tiled_test_broken.tsj\"}],\n"
+            "\"layers\": [{\"id\": 1, \"name\": \"Ground\", \"type\": \"tilelayer\", \"width\": 1, \"height\": 1, \"data\": [1]}]}";
+        const char* brokenTileset = "{\"name\": \"Desert\", \"properties\": [{\"name\": \"a\", \"type\": \"int\", \"value\": 1}],\n\"columns\": oops}";
+        assert(pntr_save_file("resources/pntr_tiled_test_broken.tmj", external, (unsigned int)strlen(external)));
+        assert(pntr_save_file("resources/pntr_tiled_test_broken.tsj", brokenTileset, (unsigned int)strlen(brokenTileset)));
+        for (int inPlace = 0; inPlace < 2; inPlace++) {
+            warnings = test_warnings;
+            options.inPlace = inPlace;
+            cute_tiled_map_t* loaded = pntr_load_tiled_ex("resources/pntr_tiled_test_broken.tmj", &options);
+            assert(error.reason != NULL);
+            assert(strstr(error.reason, "pntr_tiled_test_broken.tsj:2:") != NULL);
+            assert(error.line == 2);
+            assert(test_warnings == warnings);
+            pntr_unload_tiled(loaded);
+        }
+        options.inPlace = false;
+        remove("resources/pntr_tiled_test_broken.tmj");
+        remove("resources/pntr_tiled_test_broken.tsj");
+
+        // A successful load clears it.
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(error.reason == NULL);
+        pntr_unload_tiled(map);
+    }
+
+#ifdef PNTR_TILED_THREADS
+    // Loading independent maps from many threads at once.
+    {
+        cute_tiled_map_t* expected = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        assert(expected != NULL);
+
+        pntr_tiled_cache* cache = pntr_load_tiled_cache();
+        assert(cache != NULL);
+
+        pthread_t threads[8];
+        test_stress stress[8];
+        for (int i = 0; i < 8; i++) {
+            stress[i].index = i;
+            stress[i].cache = cache;
+            stress[i].expected = pntr_tiled_layer(expected, "Plants");
+            stress[i].failures = 0;
+            int created = pthread_create(&threads[i], NULL, test_stress_thread, &stress[i]);
+            assert(created == 0);
+        }
+        for (int i = 0; i < 8; i++) {
+            pthread_join(threads[i], NULL);
+            assert(stress[i].failures == 0);
+        }
+
+        pntr_unload_tiled_cache(cache);
+        pntr_unload_tiled(expected);
+    }
+#endif
+
+    // pntr_load_tiled_cache()
+    {
+        pntr_tiled_cache* cache = pntr_load_tiled_cache();
+        assert(cache != NULL);
+
+        pntr_tiled_load_options options = {0};
+        options.cache = cache;
+        cute_tiled_map_t* first = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        options.threadCount = 4;
+        cute_tiled_map_t* second = pntr_load_tiled_ex("resources/pntr_tiled_test_base64.tmj", &options);
+        assert(first != NULL);
+        assert(second != NULL);
+
+        // Both maps share the same tileset image.
+        assert(first->tilesets->image.ptr != NULL);
+        assert(first->tilesets->image.ptr == second->tilesets->image.ptr);
+
+        // The shared image outlives the first map.
+        pntr_unload_tiled(first);
+        pntr_image* actual = pntr_gen_image_tiled(second, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+
+        pntr_unload_tiled(second);
+        pntr_unload_tiled_cache(cache);
+    }
+
+    // pntr_load_tiled_ex() with an allocator and arena
+    {
+        pntr_tiled_allocator allocator = { test_alloc, test_free, NULL };
+        pntr_tiled_load_options options = {0};
+        options.allocator = &allocator;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_allocations > 0);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        pntr_unload_tiled(map);
+        assert(test_allocations == test_frees);
+
+        // The whole map fits in the arena's first block.
+        test_allocations = test_frees = 0;
+        options.arena = true;
+        options.threadCount = 4;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_allocations == 1);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+
+        pntr_unload_tiled(map);
+        assert(test_frees == 1);
+
+        assert(pntr_load_tiled_ex("resources/non-existant.tmj", &options) == NULL);
+        assert(test_allocations == test_frees);
+    }
+
+    // pntr_load_tiled_ex() parsing in place
+    {
+        pntr_tiled_load_options options = {0};
+        options.inPlace = true;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(PNTR_STRCMP(pntr_tiled_layer_from_index(map, 3)->name.ptr, "Image Layer") == 0);
+        assert(PNTR_STRCMP(map->orientation.ptr, "orthogonal") == 0);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Strings longer than CUTE_TILED_INTERNAL_BUFFER_MAX, with escapes.
+        assert(pntr_load_tiled("resources/pntr_tiled_test_strings.tmj") == NULL);
+        options.mapped = true;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test_strings.tmj", &options);
+        assert(map != NULL);
+        assert(map->property_count == 2);
+        const char* script = map->properties[0].data.string.ptr;
+        assert(PNTR_STRCMP(map->properties[0].name.ptr, "script") == 0);
+        assert(PNTR_STRLEN(script) == 15 * 150);
+        assert(strncmp(script, "print(\"hello\")\nprint(\"hello\")\n", 30) == 0);
+        assert(PNTR_STRCMP(map->properties[1].data.string.ptr, "Desert") == 0);
+        pntr_unload_tiled(map);
+
+        // Mapped files parsed in place are copied, so the strings survive the file being truncated.
+        unsigned int size = 0;
+        unsigned char* original = pntr_load_file("resources/pntr_tiled_test_strings.tmj", &size);
+        assert(original != NULL);
+        assert(pntr_save_file("resources/pntr_tiled_test_truncated.tmj", original, size));
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test_truncated.tmj", &options);
+        assert(map != NULL);
+        assert(pntr_save_file("resources/pntr_tiled_test_truncated.tmj", "{}", 2));
+        assert(PNTR_STRCMP(map->properties[1].data.string.ptr, "Desert") == 0);
+        assert(strncmp(map->properties[0].data.string.ptr, "print(\"hello\")", 14) == 0);
+        pntr_unload_tiled(map);
+        pntr_unload_file(original);
+        remove("resources/pntr_tiled_test_truncated.tmj");
+    }
+
+    // pntr_load_tiled_ex() with lazyImages, pntr_tiled_preload_tilesets()
+    {
+        pntr_tiled_load_options options = {0};
+        options.lazyImages = true;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(map->tilesets->image.ptr == NULL);
+        assert(pntr_tiled_layer(map, "Image Layer")->image.ptr != NULL);
+
+        // The first tile looked up loads its tileset.
+        pntr_image* tile = pntr_tiled_tile_image(map, 39);
+        assert(tile != NULL && tile->data != NULL);
+        assert(tile->width == map->tilesets->tilewidth);
+        assert(map->tilesets->image.ptr != NULL);
+        assert(pntr_tiled_preload_tilesets(map));
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Preloading with a cache, then unloading before drawing.
+        options.cache = pntr_load_tiled_cache();
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        cute_tiled_map_t* unused = pntr_load_tiled_ex("resources/pntr_tiled_test_base64.tmj", &options);
+        assert(unused != NULL);
+        assert(pntr_tiled_preload_tilesets(map));
+        assert(unused->tilesets->image.ptr == NULL);
+        pntr_unload_tiled(unused);
+
+        actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(actual);
+        pntr_unload_image(expected);
+        pntr_unload_tiled(map);
+        pntr_unload_tiled_cache(options.cache);
+        assert(!pntr_tiled_preload_tilesets(NULL));
+    }
+
+    // pntr_load_tiled_ex() with atlas
+    {
+        pntr_tiled_load_options options = {0};
+        options.atlas = true;
+        options.lazyImages = true;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(map->tilesets->image.ptr == NULL);
+
+        // The used tiles fit in less than the tileset image, with rows padded to the alignment.
+        pntr_image* atlas = ((pntr_tiled_map_data*)map->tiledversion.ptr)->atlas;
+        assert(atlas != NULL);
+        assert(atlas->pitch % PNTR_TILED_ATLAS_ROW_ALIGNMENT == 0);
+        assert(atlas->width * atlas->height < 265 * 199);
+
+        pntr_image* tile = pntr_tiled_tile_image(map, 39);
+        assert(tile != NULL && tile->width == 32 && tile->height == 32 && tile->pitch == atlas->pitch);
+        assert(tile->data >= atlas->data && (unsigned char*)tile->data < (unsigned char*)atlas->data + atlas->height * atlas->pitch);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(actual);
+        pntr_unload_image(expected);
+        pntr_unload_tiled(map);
+
+        // Collection of images tiles are packed from their own images, and unused tiles are left out.
+        const char* json = "{\"width\": 2, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"image\": \"tmw_desert_spacing.png\", \"columns\": 8, \"tilecount\": 48,\n"
+            "    \"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1},\n"
+            "  {\"firstgid\": 49, \"columns\": 0, \"tilecount\": 2, \"tilewidth\": 265, \"tileheight\": 199, \"tiles\": [\n"
+            "    {\"id\": 0, \"image\": \"logo.png\", \"imagewidth\": 128, \"imageheight\": 128},\n"
+            "    {\"id\": 1, \"image\": \"tmw_desert_spacing.png\", \"imagewidth\": 265, \"imageheight\": 199}]}],\n"
+            "\"layers\": [\n"
+            "    {\"id\": 1, \"name\": \"Ground\", \"type\": \"tilelayer\", \"width\": 2, \"height\": 1, \"data\": [1, %d]},\n"
+            "    {\"id\": 2, \"name\": \"Objects\", \"type\": \"objectgroup\", \"objects\": [\n"
+            "        {\"id\": 1, \"name\": \"logo\", \"gid\": 49, \"x\": 0, \"y\": 128, \"width\": 128, \"height\": 128}]}]\n"
+            "}";
+        char text[2048];
+        snprintf(text, sizeof(text), json, 0);
+        assert(pntr_save_file("resources/pntr_tiled_test_atlas.tmj", text, (unsigned int)strlen(text)));
+        options.cache = pntr_load_tiled_cache();
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test_atlas.tmj", &options);
+        assert(map != NULL);
+
+        pntr_image* logo = pntr_load_image("resources/logo.png");
+        pntr_image* sheet = pntr_load_image("resources/tmw_desert_spacing.png");
+        assert(logo != NULL && sheet != NULL);
+        tile = pntr_tiled_tile_image(map, 49);
+        assert(tile != NULL && tile->width == 128 && tile->height == 128);
+        for (int y = 0; y < 128; y++) {
+            for (int x = 0; x < 128; x++) {
+                assert(pntr_image_get_color(tile, x, y).value == pntr_image_get_color(logo, x, y).value);
+            }
+        }
+        tile = pntr_tiled_tile_image(map, 1);
+        assert(tile != NULL && tile->width == 32);
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 32; x++) {
+                assert(pntr_image_get_color(tile, x, y).value == pntr_image_get_color(sheet, x + 1, y + 1).value);
+            }
+        }
+        assert(pntr_tiled_tile_image(map, 2)->data == NULL);
+        assert(pntr_tiled_tile_image(map, 50)->data == NULL);
+
+        // Reloading packs the tiles that are used now.
+        snprintf(text, sizeof(text), json, 50);
+        assert(pntr_save_file("resources/pntr_tiled_test_atlas.tmj", text, (unsigned int)strlen(text)));
+        assert(pntr_tiled_reload(map, "resources/pntr_tiled_test_atlas.tmj", NULL));
+        tile = pntr_tiled_tile_image(map, 50);
+        assert(tile != NULL && tile->width == 265 && tile->height == 199);
+        assert(pntr_image_get_color(tile, 100, 100).value == pntr_image_get_color(sheet, 100, 100).value);
+        assert(pntr_tiled_tile_image(map, 1)->data != NULL);
+        assert(map->tilesets->image.ptr == NULL);
+
+        pntr_unload_image(logo);
+        pntr_unload_image(sheet);
+        pntr_unload_tiled(map);
+        pntr_unload_tiled_cache(options.cache);
+        remove("resources/pntr_tiled_test_atlas.tmj");
+    }
+
+    // pntr_tiled_prerender_layer()
+    {
+        cute_tiled_map_t* map = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        cute_tiled_map_t* reference = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        assert(map != NULL && reference != NULL);
+        assert(!pntr_tiled_prerender_layer(map, pntr_tiled_layer(map, "Image Layer"), 100));
+        assert(!pntr_tiled_prerender_layer(map, NULL, 100));
+        assert(pntr_tiled_prerender_layer(map, pntr_tiled_layer(map, "Desert"), 100));
+        assert(pntr_tiled_prerender_layer(map, pntr_tiled_layer(map, "Structure"), 100));
+        cute_tiled_layer_t* plants = pntr_tiled_layer(map, "Plants");
+        assert(pntr_tiled_prerender_layer(map, plants, 100));
+        assert(test_draws_equal(map, reference, 0, 0));
+        assert(test_draws_equal(map, reference, -37, -51));
+        assert(test_draws_equal(map, reference, 45, 13));
+
+        // The chunks are only rendered once they come into view.
+        pntr_tiled_layer_cache* cache = (pntr_tiled_layer_cache*)plants->image.ptr;
+        assert(cache != NULL && cache->columns == 6 && cache->rows == 4);
+        assert(!cache->chunks[3 * cache->columns + 5].rendered);
+
+        // Chunks past the right and bottom edges of the map leave the rest of their columns and rows empty.
+        assert(test_draws_equal_size(map, reference, 0, 0, 700, 420));
+        assert(cache->chunks[3 * cache->columns + 5].rendered);
+
+        // Setting a tile marks only the chunk it is in.
+        assert(pntr_tiled_prerender_layer(map, plants, 100));
+        cache = (pntr_tiled_layer_cache*)plants->image.ptr;
+        assert(test_draws_equal(map, reference, 0, 0));
+        pntr_set_layer_tile(plants, 4, 2, 30);
+        pntr_set_layer_tile(pntr_tiled_layer(reference, "Plants"), 4, 2, 30);
+        int dirty = 0;
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 3; x++) {
+                dirty += cache->chunks[y * cache->columns + x].rendered ? 0 : 1;
+            }
+        }
+        assert(dirty == 1 && !cache->chunks[1].rendered);
+        assert(test_draws_equal(map, reference, 0, 0));
+
+        // Chunks with animated tiles render again as their frames change.
+        int frameCount = 0;
+        for (int i = 0; i < cache->columns * cache->rows; i++) {
+            frameCount += cache->chunks[i].frameCount;
+        }
+        assert(frameCount > 0);
+        pntr_update_tiled(map, 0.6f);
+        pntr_update_tiled(reference, 0.6f);
+        assert(test_draws_equal(map, reference, 0, 0));
+        pntr_update_tiled(map, 0.6f);
+        pntr_update_tiled(reference, 0.6f);
+        assert(test_draws_equal(map, reference, 0, 0));
+
+        assert(pntr_tiled_prerender_layer(map, plants, 0));
+        assert(plants->image.ptr == NULL);
+        assert(test_draws_equal(map, reference, 0, 0));
+        pntr_unload_tiled(map);
+        pntr_unload_tiled(reference);
+
+        // Infinite maps start their chunks from their first tile.
+        map = pntr_load_tiled("resources/pntr_tiled_test_infinite.tmj");
+        reference = pntr_load_tiled("resources/pntr_tiled_test_infinite.tmj");
+        assert(map != NULL && reference != NULL);
+        for (int i = 0; i < pntr_tiled_layer_count(map); i++) {
+            cute_tiled_layer_t* layer = pntr_tiled_layer_from_index(map, i);
+            if (PNTR_STRCMP(layer->type.ptr, "tilelayer") == 0) {
+                assert(pntr_tiled_prerender_layer(map, layer, 256));
+            }
+        }
+        assert(test_draws_equal(map, reference, 0, 0));
+        assert(test_draws_equal(map, reference, 600, 300));
+        assert(test_draws_equal(map, reference, -1000, -70));
+        pntr_unload_tiled(map);
+        pntr_unload_tiled(reference);
+    }
+
+    // pntr_load_tiled_ex() with indexObjects
+    {
+        // A grid of small objects, along with one of each other kind.
+        char* json = (char*)pntr_load_memory(65536);
+        assert(json != NULL);
+        int length = snprintf(json, 65536, "{\"width\": 40, \"height\": 30, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"image\": \"tmw_desert_spacing.png\", \"columns\": 8, \"tilecount\": 48,\n"
+            "    \"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1}],\n"
+            "\"layers\": [{\"id\": 1, \"name\": \"Objects\", \"type\": \"objectgroup\", \"visible\": true, \"opacity\": 1, \"objects\": [\n"
+            "    {\"id\": 1, \"name\": \"tile\", \"gid\": 30, \"x\": 100, \"y\": 132, \"width\": 32, \"height\": 32, \"visible\": true},\n"
+            "    {\"id\": 2, \"name\": \"big\", \"x\": 40, \"y\": 600, \"width\": 1200, \"height\": 40, \"visible\": true},\n"
+            "    {\"id\": 3, \"name\": \"turned\", \"x\": 300, \"y\": 60, \"width\": 20, \"height\": 10, \"rotation\": 45, \"visible\": true},\n"
+            "    {\"id\": 4, \"name\": \"shape\", \"x\": 200, \"y\": 200, \"polygon\": [{\"x\": 0, \"y\": 0}, {\"x\": 30, \"y\": 5}, {\"x\": 10, \"y\": 25}], \"visible\": true}");
+        for (int i = 0; i < 400; i++) {
+            length += snprintf(json + length, 65536 - length, ",\n    {\"id\": %d, \"name\": \"%s\", \"x\": %d, \"y\": %d, \"width\": 10, \"height\": 10, \"ellipse\": %s, \"visible\": true}",
+                10 + i, i % 2 == 0 ? "even" : "odd", (i % 20) * 60, (i / 20) * 45, i % 3 == 0 ? "true" : "false");
+        }
+        length += snprintf(json + length, 65536 - length, "]}]}");
+        assert(pntr_save_file("resources/pntr_tiled_test_objects.tmj", json, (unsigned int)length));
+        pntr_unload_memory(json);
+
+        pntr_tiled_load_options options = {0};
+        options.indexObjects = true;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test_objects.tmj", &options);
+        cute_tiled_map_t* reference = pntr_load_tiled("resources/pntr_tiled_test_objects.tmj");
+        assert(map != NULL && reference != NULL);
+        cute_tiled_layer_t* layer = pntr_tiled_layer(map, "Objects");
+        cute_tiled_layer_t* referenceLayer = pntr_tiled_layer(reference, "Objects");
+        assert(layer->image.ptr != NULL);
+        assert(referenceLayer->image.ptr == NULL);
+
+        // Names are found by a binary search, matching the first object with the name.
+        assert(pntr_tiled_get_object(layer, "turned")->id == 3);
+        assert(pntr_tiled_get_object(layer, "even")->id == pntr_tiled_get_object(referenceLayer, "even")->id);
+        assert(pntr_tiled_get_object(layer, "odd")->id == pntr_tiled_get_object(referenceLayer, "odd")->id);
+        assert(pntr_tiled_get_object(layer, "missing") == NULL);
+
+        // Queries find the same objects with the index as they do without it.
+        cute_tiled_object_t* found[512];
+        cute_tiled_object_t* expected[512];
+        float areas[][4] = {{0, 0, 100, 100}, {95, 95, 10, 10}, {-500, -500, 5000, 5000}, {280, 40, 10, 10}, {700, 590, 5, 5}, {2000, 2000, 10, 10}};
+        for (int i = 0; i < (int)(sizeof(areas) / sizeof(areas[0])); i++) {
+            int count = pntr_tiled_query_objects_rect(map, layer, areas[i][0], areas[i][1], areas[i][2], areas[i][3], found, 512);
+            assert(count == pntr_tiled_query_objects_rect(reference, referenceLayer, areas[i][0], areas[i][1], areas[i][2], areas[i][3], expected, 512));
+            assert(test_query_ids(found, count) == test_query_ids(expected, count));
+            count = pntr_tiled_query_objects_circle(map, layer, areas[i][0], areas[i][1], areas[i][2], found, 512);
+            assert(count == pntr_tiled_query_objects_circle(reference, referenceLayer, areas[i][0], areas[i][1], areas[i][2], expected, 512));
+            assert(test_query_ids(found, count) == test_query_ids(expected, count));
+            count = pntr_tiled_query_objects_point(map, layer, areas[i][0], areas[i][1], found, 512);
+            assert(count == pntr_tiled_query_objects_point(reference, referenceLayer, areas[i][0], areas[i][1], expected, 512));
+            assert(test_query_ids(found, count) == test_query_ids(expected, count));
+        }
+        assert(pntr_tiled_query_objects_rect(map, layer, -500, -500, 5000, 5000, NULL, 0) == 404);
+        assert(pntr_tiled_query_objects_point(map, layer, 65, 50, found, 512) == 1 && found[0]->id == 31);
+        assert(pntr_tiled_query_objects_point(map, layer, 700, 620, found, 512) == 1 && found[0]->id == 2);
+        assert(pntr_tiled_query_objects_point(map, layer, 110, 110, found, 512) == 1 && found[0]->id == 1);
+        assert(pntr_tiled_query_objects_circle(map, layer, 30, 30, 10, found, 512) == 0);
+        assert(pntr_tiled_query_objects_circle(map, layer, 30, 30, 26, found, 512) == 1 && found[0]->id == 30);
+
+        // Only the objects in view are drawn, in the same order as without the index.
+        assert(test_draws_equal(map, reference, 0, 0));
+        assert(test_draws_equal(map, reference, -250, -130));
+        assert(test_draws_equal(map, reference, -900, -500));
+
+        // Moved objects are found where they are now once updated.
+        cute_tiled_object_t* mover = pntr_tiled_get_object(layer, "shape");
+        mover->x = 1000;
+        mover->y = 1200;
+        pntr_tiled_get_object(referenceLayer, "shape")->x = 1000;
+        pntr_tiled_get_object(referenceLayer, "shape")->y = 1200;
+        assert(pntr_tiled_update_object(map, layer, mover));
+        assert(!pntr_tiled_update_object(map, referenceLayer, mover));
+        assert(pntr_tiled_query_objects_point(map, layer, 1010, 1205, found, 512) == 1 && found[0] == mover);
+        assert(pntr_tiled_query_objects_point(map, layer, 210, 205, found, 512) == 0);
+        assert(test_draws_equal(map, reference, -900, -1100));
+        mover->x += 5;
+        assert(pntr_tiled_update_object(map, layer, mover));
+        assert(pntr_tiled_query_objects_point(map, layer, 1033, 1206, found, 512) == 1);
+
+        // Reloading indexes the objects again.
+        assert(pntr_tiled_reload(map, "resources/pntr_tiled_test_objects.tmj", NULL));
+        assert(layer->image.ptr != NULL);
+        assert(pntr_tiled_get_object(layer, "shape") == mover && mover->x == 200);
+        assert(pntr_tiled_query_objects_point(map, layer, 210, 205, found, 512) == 1 && found[0] == mover);
+        assert(pntr_tiled_query_objects_rect(map, layer, -500, -500, 5000, 5000, NULL, 0) == 404);
+
+        // Layers can be indexed on their own.
+        assert(pntr_tiled_index_objects(reference, referenceLayer));
+        assert(!pntr_tiled_index_objects(reference, NULL));
+        assert(referenceLayer->image.ptr != NULL);
+        assert(pntr_tiled_get_object(referenceLayer, "big")->id == 2);
+
+        // Shape objects are rasterized once for each shape, size, rotation and tint, and drawn from the cache after.
+        pntr_tiled_map_data* data = (pntr_tiled_map_data*)reference->tiledversion.ptr;
+        pntr_image* first = pntr_gen_image_color(1300, 1000, PNTR_BLACK);
+        pntr_image* second = pntr_gen_image_color(1300, 1000, PNTR_BLACK);
+        assert(first != NULL && second != NULL);
+        pntr_draw_tiled(first, reference, 0, 0, PNTR_WHITE);
+        assert(data->shapes.count == 4); // The big rectangle is larger than the whole cache.
+        pntr_draw_tiled(second, reference, 0, 0, PNTR_WHITE);
+        assert(data->shapes.count == 4);
+        PNTR_ASSERT_IMAGE_EQUALS(first, second);
+        pntr_unload_image(first);
+        pntr_unload_image(second);
+
+        pntr_tiled_get_object(referenceLayer, "turned")->rotation = 30;
+        first = pntr_gen_image_color(400, 100, PNTR_BLACK);
+        assert(first != NULL);
+        pntr_draw_tiled(first, reference, 0, 0, PNTR_WHITE);
+        assert(data->shapes.count == 5);
+
+        // The least recently drawn shapes are let go to stay within the cache size.
+        for (int i = 0; i < 200; i++) {
+            pntr_draw_tiled(first, reference, 0, 0, pntr_new_color(255, (unsigned char)i, 255, 255));
+        }
+        assert(data->shapes.size <= PNTR_TILED_SHAPE_CACHE_SIZE);
+        assert(data->shapes.count < 200 * 3);
+        assert(data->shapes.newest->tint == pntr_new_color(255, 199, 255, 255).value);
+        pntr_unload_image(first);
+
+        pntr_unload_tiled(map);
+        pntr_unload_tiled(reference);
+        remove("resources/pntr_tiled_test_objects.tmj");
+    }
+
+    // pntr_draw_tiled_ex()
+    {
+        cute_tiled_map_t* map = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        assert(map != NULL);
+
+        // The view is drawn at the top left of the destination, and nothing is drawn outside of it.
+        pntr_rectangle view = {100, 50, 200, 120};
+        pntr_image* actual = pntr_gen_image_color(300, 200, PNTR_BLACK);
+        pntr_image* expected = pntr_gen_image_color(200, 120, PNTR_BLACK);
+        assert(actual != NULL && expected != NULL);
+        pntr_draw_tiled_ex(actual, map, view, NULL);
+        pntr_draw_tiled(expected, map, -100, -50, PNTR_WHITE);
+        assert(actual->clip.width == 300 && actual->clip.height == 200);
+        for (int y = 0; y < actual->height; y++) {
+            for (int x = 0; x < actual->width; x++) {
+                pntr_color color = x < expected->width && y < expected->height ? pntr_image_get_color(expected, x, y) : PNTR_BLACK;
+                assert(pntr_image_get_color(actual, x, y).value == color.value);
+            }
+        }
+
+        // Clipped destinations only get the tiles within their clipping rectangle.
+        pntr_clear_background(expected, PNTR_BLACK);
+        expected->clip = (pntr_rectangle){30, 20, 50, 40};
+        pntr_draw_tiled(expected, map, -100, -50, PNTR_WHITE);
+        for (int y = 0; y < expected->height; y++) {
+            for (int x = 0; x < expected->width; x++) {
+                bool inside = x >= 30 && x < 80 && y >= 20 && y < 60;
+                assert((pntr_image_get_color(expected, x, y).value == PNTR_BLACK.value) || inside);
+                assert(!inside || pntr_image_get_color(expected, x, y).value == pntr_image_get_color(actual, x, y).value);
+            }
+        }
+        expected->clip = (pntr_rectangle){0, 0, expected->width, expected->height};
+
+        // Parallax factors move the layer by a part of the view, around the view's center.
+        pntr_tiled_layer(map, "Desert")->visible = 0;
+        pntr_tiled_layer(map, "Structure")->visible = 0;
+        pntr_tiled_layer(map, "Image Layer")->visible = 0;
+        cute_tiled_layer_t* plants = pntr_tiled_layer(map, "Plants");
+        plants->parallaxx = 0.5f;
+        plants->parallaxy = 0.0f;
+        pntr_clear_background(actual, PNTR_BLACK);
+        pntr_clear_background(expected, PNTR_BLACK);
+        pntr_draw_tiled_ex(actual, map, view, NULL);
+        pntr_draw_tiled_layer_tilelayer(expected, map, plants, 0, 60, PNTR_WHITE);
+        for (int y = 0; y < expected->height; y++) {
+            for (int x = 0; x < expected->width; x++) {
+                assert(pntr_image_get_color(actual, x, y).value == pntr_image_get_color(expected, x, y).value);
+            }
+        }
+
+        // Unless they are turned off.
+        pntr_tiled_draw_options options = {0};
+        options.noParallax = true;
+        pntr_clear_background(actual, PNTR_BLACK);
+        pntr_clear_background(expected, PNTR_BLACK);
+        pntr_draw_tiled_ex(actual, map, view, &options);
+        pntr_draw_tiled_layer_tilelayer(expected, map, plants, -100, -50, PNTR_WHITE);
+        for (int y = 0; y < expected->height; y++) {
+            for (int x = 0; x < expected->width; x++) {
+                assert(pntr_image_get_color(actual, x, y).value == pntr_image_get_color(expected, x, y).value);
+            }
+        }
+
+        pntr_unload_image(actual);
+        pntr_unload_image(expected);
+        pntr_unload_tiled(map);
+    }
+
+    // pntr_load_tiled_ex() with a layerFilter, noImages and noTileTable
+    {
+        pntr_tiled_load_options options = {0};
+        options.layerFilter = test_layer_filter;
+        options.layerFilterUserData = (void*)"Plants";
+        options.inPlace = true;
+        cute_tiled_map_t* map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(test_filtered == 4);
+        assert(pntr_tiled_layer_count(map) == 2);
+        assert(pntr_tiled_layer(map, "Desert") == NULL);
+        assert(pntr_tiled_layer(map, "Image Layer")->image.ptr != NULL);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        assert(pntr_tiled_tile_image(map, 39) != NULL);
+        pntr_unload_tiled(map);
+
+        // Headless
+        options.noImages = true;
+        options.noTileTable = true;
+        options.threadCount = 4;
+        map = pntr_load_tiled_ex("resources/pntr_tiled_test.tmj", &options);
+        assert(map != NULL);
+        assert(map->tilesets->image.ptr == NULL);
+        assert(map->tilesets->tilecount > 0);
+        assert(pntr_tiled_layer(map, "Image Layer")->image.ptr == NULL);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        assert(pntr_tiled_tile_image(map, 39) == NULL);
+        pntr_image* image = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(image != NULL);
+        pntr_unload_image(image);
+        pntr_unload_tiled(map);
+
+        // Rejecting a group skips its children, and accepting one filters them.
+        const char* fileName = "resources/pntr_tiled_test_groups.tmj";
+        const char* json =
+            "{\"layers\": [\n"
+            "    {\"layers\": [{\"data\": [1], \"name\": \"Plants\", \"type\": \"tilelayer\"}], \"name\": \"Decoration\", \"type\": \"group\"},\n"
+            "    {\"layers\": [{\"data\": [2], \"name\": \"Plants\", \"type\": \"tilelayer\"}, {\"data\": [3], \"name\": \"Trees\", \"type\": \"tilelayer\"}],\n"
+            "     \"name\": \"Gameplay\", \"type\": \"group\"},\n"
+            "    {\"name\": \"Plants\", \"objects\": [{\"name\": \"}\\\"{\", \"x\": 1.5}], \"type\": \"objectgroup\"}\n"
+            "], \"width\": 3}";
+        assert(pntr_save_file(fileName, json, (unsigned int)strlen(json)));
+        options.layerFilterUserData = (void*)"Gameplay";
+        test_filtered = 0;
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(test_filtered == 5);
+        assert(map->width == 3);
+        assert(map->layers != NULL && map->layers->next == NULL);
+        assert(PNTR_STRCMP(map->layers->name.ptr, "Gameplay") == 0);
+        assert(map->layers->layers == NULL);
+        pntr_unload_tiled(map);
+
+        options.layerFilterUserData = (void*)"Plants";
+        test_filtered = 0;
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(test_filtered == 3);
+        assert(map->layers != NULL && map->layers->next == NULL);
+        assert(PNTR_STRCMP(map->layers->type.ptr, "objectgroup") == 0);
+        assert(map->layers->objects != NULL && map->layers->objects->x == 1.5f);
+        assert(PNTR_STRCMP(map->layers->objects->name.ptr, "}\"{") == 0);
+        pntr_unload_tiled(map);
+
+        // The filter sees names as they are loaded, with escapes decoded and past the length of a parsed string.
+        char longName[1500];
+        memset(longName, 'a', sizeof(longName) - 1);
+        longName[sizeof(longName) - 1] = '\0';
+        char escaped[2048];
+        snprintf(escaped, sizeof(escaped),
+            "{\"layers\": [\n"
+            "    {\"transparentcolor\": \"#ff00ff\", \"name\": \"Pl\\u0061nts \\u00e9\\ud83c\\udf35\", \"type\": \"tilelayer\"},\n"
+            "    {\"type\": \"tilelayer\", \"name\": \"%s\"}\n"
+            "], \"width\": 3}", longName);
+        assert(pntr_save_file(fileName, escaped, (unsigned int)strlen(escaped)));
+        const char* cactus = "Plants \xc3\xa9\xf0\x9f\x8c\xb5";
+        options.layerFilterUserData = (void*)cactus;
+        test_filtered = 0;
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(test_filtered == 2);
+        assert(map->layers != NULL && map->layers->next == NULL);
+        assert(PNTR_STRCMP(map->layers->name.ptr, cactus) == 0);
+        pntr_unload_tiled(map);
+
+        // Copied strings are decoded the same way. The long name is too long to copy, but its layer is skipped.
+        options.inPlace = false;
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(PNTR_STRCMP(map->layers->name.ptr, cactus) == 0);
+        pntr_unload_tiled(map);
+        options.inPlace = true;
+
+        options.layerFilterUserData = (void*)longName;
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(map->layers != NULL && map->layers->next == NULL);
+        assert(PNTR_STRCMP(map->layers->name.ptr, longName) == 0);
+        pntr_unload_tiled(map);
+        remove(fileName);
+    }
+
+    // pntr_save_tiled_baked(), pntr_load_tiled_baked()
+    {
+        assert(pntr_save_tiled_baked("resources/pntr_tiled_test.tmj", "pntr_tiled_test.baked"));
+
+        cute_tiled_map_t* map = pntr_load_tiled_baked("pntr_tiled_test.baked", "resources/pntr_tiled_test.tmj");
+        assert(map != NULL);
+        assert(pntr_tiled_layer_count(map) == 4);
+        assert(PNTR_STRCMP(pntr_tiled_layer_from_index(map, 3)->name.ptr, "Image Layer") == 0);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), 8, 2) == 39);
+        assert(map->tilesets->tiles != NULL && map->tilesets->tiles->frame_count == 2);
+
+        pntr_image* actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        pntr_image* expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Infinite maps, with their chunks
+        assert(pntr_save_tiled_baked("resources/pntr_tiled_test_infinite.tmj", "pntr_tiled_test.baked"));
+        map = pntr_load_tiled_baked("pntr_tiled_test.baked", NULL);
+        assert(map != NULL);
+        assert(map->infinite);
+        cute_tiled_layer_t* ground = pntr_tiled_layer(map, "Ground");
+        assert(pntr_layer_tile(ground, -16, 0) == 30);
+        assert(pntr_layer_tile(ground, 1027, -2046) == 6);
+        assert(pntr_layer_tile(pntr_tiled_layer(map, "Plants"), -13, 4) == 38);
+        pntr_unload_tiled(map);
+
+        // Stale bakes are rebuilt from their source.
+        map = pntr_load_tiled_baked("pntr_tiled_test.baked", "resources/pntr_tiled_test.tmj");
+        assert(map != NULL);
+        assert(!map->infinite);
+        assert(pntr_tiled_layer_count(map) == 4);
+        pntr_unload_tiled(map);
+
+        map = pntr_load_tiled_baked("pntr_tiled_test.baked", NULL);
+        assert(map != NULL);
+        assert(!map->infinite);
+        pntr_unload_tiled(map);
+
+        assert(pntr_load_tiled_baked("resources/pntr_tiled_test.tmj", NULL) == NULL);
+        assert(pntr_load_tiled_baked("non-existant.baked", NULL) == NULL);
+
+        // Bakes, their source and their images load through an io, such as a pack.
+        pntr_tiled_pack_file files[4];
+        test_pack_file(files + 0, "pntr_tiled_test.baked");
+        test_pack_file(files + 1, "resources/pntr_tiled_test.tmj");
+        test_pack_file(files + 2, "resources/tmw_desert_spacing.png");
+        test_pack_file(files + 3, "resources/logo.png");
+        pntr_tiled_pack pack = { files, 4 };
+        pntr_tiled_io packIO = pntr_tiled_io_pack(&pack);
+        pntr_tiled_io io = { test_io_open, test_io_size, test_io_map, test_io_read, test_io_close, &packIO };
+        int opens = test_io_opens;
+        map = pntr_load_tiled_baked_ex("pntr_tiled_test.baked", "resources/pntr_tiled_test.tmj", &io);
+        assert(map != NULL);
+        assert(test_io_opens == opens + 4);
+        actual = pntr_gen_image_tiled(map, PNTR_WHITE);
+        assert(actual != NULL);
+        expected = pntr_load_image("resources/expected.png");
+        assert(expected != NULL);
+        PNTR_ASSERT_IMAGE_EQUALS(actual, expected);
+        pntr_unload_image(expected);
+        pntr_unload_image(actual);
+        pntr_unload_tiled(map);
+
+        // Stale bakes in the pack are rebuilt from it.
+        assert(pntr_save_tiled_baked("resources/pntr_tiled_test_infinite.tmj", "pntr_tiled_test_infinite.baked"));
+        pntr_unload_memory((void*)files[0].data);
+        test_pack_file(files + 0, "pntr_tiled_test_infinite.baked");
+        remove("pntr_tiled_test_infinite.baked");
+        files[0].fileName = "pntr_tiled_test.baked";
+        map = pntr_load_tiled_baked_ex("pntr_tiled_test.baked", "resources/pntr_tiled_test.tmj", &io);
+        assert(map != NULL);
+        assert(!map->infinite);
+        pntr_unload_tiled(map);
+        assert(pntr_load_tiled_baked_ex("resources/non-existant.baked", NULL, &io) == NULL);
+        for (int i = 0; i < 4; i++) {
+            pntr_unload_memory((void*)files[i].data);
+        }
+
+        // Bakes that leave their header unrelocated are rejected.
+        unsigned int bakedSize;
+        unsigned char* baked = pntr_load_file("pntr_tiled_test.baked", &bakedSize);
+        assert(baked != NULL);
+        ((pntr_tiled_baked_header*)baked)->relocationCount = 0;
+        assert(pntr_save_file("pntr_tiled_test_corrupt.baked", baked, bakedSize));
+        pntr_unload_file(baked);
+        assert(pntr_load_tiled_baked("pntr_tiled_test_corrupt.baked", NULL) == NULL);
+        remove("pntr_tiled_test_corrupt.baked");
+
+        // Paths too long to hold are rejected.
+        char longPath[PNTR_PATH_MAX + 16];
+        PNTR_MEMSET(longPath, 'a', sizeof(longPath) - 1);
+        longPath[sizeof(longPath) - 1] = '\0';
+        assert(!pntr_save_tiled_baked(longPath, "pntr_tiled_test.baked"));
+        assert(pntr_load_tiled_baked("pntr_tiled_test.baked", longPath) == NULL);
+    }
+
+    // pntr_tiled_reload()
+    {
+        const char* before =
+            "{\"width\": 2, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"image\": \"tmw_desert_spacing.png\", \"columns\": 8, \"tilecount\": 48,\n"
+            "    \"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1, \"transparentcolor\": \"#ff00ff\"}],\n"
+            "\"layers\": [\n"
+            "    {\"id\": 1, \"name\": \"Ground\", \"type\": \"tilelayer\", \"width\": 2, \"height\": 1, \"data\": [1, 2]},\n"
+            "    {\"id\": 2, \"name\": \"Objects\", \"type\": \"objectgroup\", \"objects\": [\n"
+            "        {\"id\": 1, \"name\": \"player\", \"x\": 4, \"y\": 8},\n"
+            "        {\"id\": 2, \"name\": \"enemy\", \"x\": 16, \"y\": 8}]},\n"
+            "    {\"id\": 3, \"name\": \"Logo\", \"type\": \"imagelayer\", \"image\": \"logo.png\"}]\n"
+            "}";
+        const char* after =
+            "{\"width\": 2, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"properties\": [{\"name\": \"reloaded\", \"type\": \"bool\", \"value\": true}],\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"image\": \"tmw_desert_spacing.png\", \"columns\": 8, \"tilecount\": 48,\n"
+            "    \"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1, \"transparentcolor\": \"#ff00ff\"}],\n"
+            "\"layers\": [\n"
+            "    {\"id\": 2, \"name\": \"Objects\", \"type\": \"objectgroup\", \"objects\": [\n"
+            "        {\"id\": 3, \"name\": \"chest\", \"x\": 20, \"y\": 4},\n"
+            "        {\"id\": 1, \"name\": \"player\", \"x\": 12, \"y\": 8}]},\n"
+            "    {\"id\": 1, \"name\": \"Ground\", \"type\": \"tilelayer\", \"width\": 2, \"height\": 1, \"data\": [3, 4]},\n"
+            "    {\"id\": 3, \"name\": \"Logo\", \"type\": \"imagelayer\", \"image\": \"logo.png\"}]\n"
+            "}";
+        const char* retiled =
+            "{\"width\": 2, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"image\": \"tmw_desert_spacing.png\", \"columns\": 4, \"tilecount\": 8,\n"
+            "    \"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1, \"transparentcolor\": \"#ff00ff\"}],\n"
+            "\"layers\": [\n"
+            "    {\"id\": 2, \"name\": \"Objects\", \"type\": \"objectgroup\", \"objects\": [\n"
+            "        {\"id\": 1, \"name\": \"player\", \"x\": 12, \"y\": 8}]}]\n"
+            "}";
+        const char* fileName = "resources/pntr_tiled_test_reload.tmj";
+
+        assert(pntr_save_file(fileName, before, (unsigned int)strlen(before)));
+        cute_tiled_map_t* map = pntr_load_tiled(fileName);
+        assert(map != NULL);
+        cute_tiled_layer_t* ground = pntr_tiled_layer(map, "Ground");
+        cute_tiled_layer_t* objects = pntr_tiled_layer(map, "Objects");
+        cute_tiled_object_t* player = pntr_tiled_get_object(objects, "player");
+        pntr_image* tilesetImage = (pntr_image*)map->tilesets->image.ptr;
+        pntr_image* logo = (pntr_image*)pntr_tiled_layer(map, "Logo")->image.ptr;
+        pntr_image* tile = pntr_tiled_tile_image(map, 3);
+        assert(player != NULL);
+        assert(tilesetImage != NULL);
+        assert(logo != NULL);
+        assert(pntr_layer_tile(ground, 0, 0) == 1);
+        assert(pntr_tiled_prerender_layer(map, ground, 64));
+
+        // Layers and objects keep their address, and images and the tile table are reused
+        assert(pntr_save_file(fileName, after, (unsigned int)strlen(after)));
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(map->layers == objects);
+        assert(objects->next == ground);
+        assert(pntr_tiled_get_object(objects, "player") == player);
+        assert(player->x == 12);
+        assert(pntr_tiled_get_object(objects, "enemy") == NULL);
+        assert(pntr_tiled_get_object(objects, "chest") != NULL);
+        assert(objects->objects->next->next == NULL);
+        assert(pntr_layer_tile(ground, 0, 0) == 3);
+        assert(pntr_layer_tile(ground, 1, 0) == 4);
+        assert(map->property_count == 1);
+        assert(PNTR_STRCMP(map->properties[0].name.ptr, "reloaded") == 0);
+        assert((pntr_image*)map->tilesets->image.ptr == tilesetImage);
+        assert((pntr_image*)pntr_tiled_layer(map, "Logo")->image.ptr == logo);
+        assert(pntr_tiled_tile_image(map, 3) == tile);
+        assert(pntr_tiled_tile_image(map, 3)->data != NULL);
+
+        // Prerendered layers render again from their reloaded tiles.
+        assert(ground->image.ptr != NULL);
+        pntr_image* prerendered = pntr_gen_image_color(64, 32, PNTR_BLANK);
+        pntr_image* drawn = pntr_gen_image_color(32, 32, PNTR_BLANK);
+        assert(prerendered != NULL && drawn != NULL);
+        pntr_draw_tiled_layer_tilelayer(prerendered, map, ground, 0, 0, PNTR_WHITE);
+        pntr_draw_image(drawn, tile, 0, 0);
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 32; x++) {
+                assert(pntr_image_get_color(prerendered, x, y).value == pntr_image_get_color(drawn, x, y).value);
+            }
+        }
+        pntr_unload_image(prerendered);
+        pntr_unload_image(drawn);
+
+        // Only the parses that layers or objects still live in are kept, such as the one that added the chest
+        cute_tiled_object_t* chest = pntr_tiled_get_object(objects, "chest");
+        cute_tiled_memory_stats_t stats;
+        cute_tiled_memory_stats_t reloadedStats;
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(pntr_tiled_get_memory_stats(map, &stats));
+        for (int i = 0; i < 4; i++) {
+            assert(pntr_tiled_reload(map, fileName, NULL));
+        }
+        assert(pntr_tiled_get_memory_stats(map, &reloadedStats));
+        assert(reloadedStats.page_count == stats.page_count);
+        assert(reloadedStats.page_bytes == stats.page_bytes);
+        assert(pntr_tiled_get_object(objects, "chest") == chest);
+        assert(PNTR_STRCMP(chest->name.ptr, "chest") == 0);
+
+        // New tile geometry rebuilds the tile table, still from the same image
+        assert(pntr_save_file(fileName, retiled, (unsigned int)strlen(retiled)));
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(map->layers == objects);
+        assert(objects->next == NULL);
+        assert(pntr_tiled_get_object(objects, "player") == player);
+        assert(map->property_count == 0);
+        assert(map->tilesets->columns == 4);
+        assert((pntr_image*)map->tilesets->image.ptr == tilesetImage);
+        assert(pntr_tiled_tile_image(map, 8) != NULL);
+        assert(pntr_tiled_tile_image(map, 9) == NULL);
+
+        assert(pntr_tiled_get_memory_stats(map, &stats));
+        assert(stats.page_count > 0);
+
+        // Failures leave the map as it was
+        pntr_tiled_error error;
+        assert(!pntr_tiled_reload(map, "non-existant.tmj", &error));
+        assert(error.reason != NULL && strstr(error.reason, "non-existant.tmj") != NULL);
+        assert(!pntr_tiled_reload(NULL, fileName, NULL));
+        assert(map->layers == objects);
+        pntr_unload_tiled(map);
+
+        // Maps in an arena reload into it
+        pntr_tiled_load_options options;
+        PNTR_MEMSET(&options, 0, sizeof(options));
+        options.arena = true;
+        options.lazyImages = true;
+        assert(pntr_save_file(fileName, before, (unsigned int)strlen(before)));
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        player = pntr_tiled_get_object(pntr_tiled_layer(map, "Objects"), "player");
+        assert(pntr_save_file(fileName, after, (unsigned int)strlen(after)));
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(pntr_tiled_get_object(pntr_tiled_layer(map, "Objects"), "player") == player);
+        assert(pntr_tiled_tile_image(map, 3)->data != NULL);
+        assert(pntr_save_file(fileName, retiled, (unsigned int)strlen(retiled)));
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(pntr_tiled_tile_image(map, 8)->data != NULL);
+        pntr_unload_tiled(map);
+
+        // Reloads keep to the load options, and only reuse images and cached tilesets whose file has not changed
+        const char* external =
+            "{\"width\": 2, \"height\": 1, \"tilewidth\": 32, \"tileheight\": 32, \"orientation\": \"orthogonal\",\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"source\": \"pntr_tiled_test_reload.tsj\"}],\n"
+            "\"layers\": [\n"
+            "    {\"id\": 1, \"name\": \"Ground\", \"type\": \"tilelayer\", \"width\": 2, \"height\": 1, \"data\": [1, 2]},\n"
+            "    {\"id\": 2, \"name\": \"Objects\", \"type\": \"objectgroup\", \"objects\": [\n"
+            "        {\"id\": 1, \"name\": \"player\", \"x\": 4, \"y\": 8}]},\n"
+            "    {\"id\": 3, \"name\": \"Logo\", \"type\": \"imagelayer\", \"image\": \"pntr_tiled_test_reload.png\"}]\n"
+            "}";
+        const char* tileset =
+            "{\"name\": \"Desert\", \"image\": \"tmw_desert_spacing.png\", \"columns\": 8, \"tilecount\": 48,\n"
+            "\"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1}";
+        const char* retileset =
+            "{\"name\": \"Desert\", \"image\": \"tmw_desert_spacing.png\", \"columns\": 4, \"tilecount\": 8,\n"
+            "\"tilewidth\": 32, \"tileheight\": 32, \"margin\": 1, \"spacing\": 1}";
+        const char* tilesetName = "resources/pntr_tiled_test_reload.tsj";
+        const char* imageName = "resources/pntr_tiled_test_reload.png";
+        unsigned int logoSize;
+        unsigned int desertSize;
+        unsigned char* logoFile = pntr_load_file("resources/logo.png", &logoSize);
+        unsigned char* desertFile = pntr_load_file("resources/tmw_desert_spacing.png", &desertSize);
+        assert(logoFile != NULL && desertFile != NULL);
+        assert(pntr_save_file(fileName, external, (unsigned int)strlen(external)));
+        assert(pntr_save_file(tilesetName, tileset, (unsigned int)strlen(tileset)));
+        assert(pntr_save_file(imageName, logoFile, logoSize));
+
+        PNTR_MEMSET(&options, 0, sizeof(options));
+        options.cache = pntr_load_tiled_cache();
+        options.inPlace = true;
+        options.layerFilter = test_layer_filter;
+        options.layerFilterUserData = (void*)"Objects";
+        assert(options.cache != NULL);
+        map = pntr_load_tiled_ex(fileName, &options);
+        assert(map != NULL);
+        assert(pntr_tiled_layer(map, "Ground") == NULL);
+        player = pntr_tiled_get_object(pntr_tiled_layer(map, "Objects"), "player");
+        logo = (pntr_image*)pntr_tiled_layer(map, "Logo")->image.ptr;
+        assert(player != NULL);
+        assert(logo != NULL && logo->width == 128);
+
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(pntr_tiled_layer(map, "Ground") == NULL);
+        assert((pntr_image*)pntr_tiled_layer(map, "Logo")->image.ptr == logo);
+        assert(map->tilesets->columns == 8);
+
+        assert(pntr_save_file(tilesetName, retileset, (unsigned int)strlen(retileset)));
+        assert(pntr_save_file(imageName, desertFile, desertSize));
+        assert(pntr_tiled_reload(map, fileName, NULL));
+        assert(pntr_tiled_layer(map, "Ground") == NULL);
+        assert(pntr_tiled_get_object(pntr_tiled_layer(map, "Objects"), "player") == player);
+        assert(PNTR_STRCMP(player->name.ptr, "player") == 0);
+        assert(((pntr_image*)pntr_tiled_layer(map, "Logo")->image.ptr)->width == 265);
+        assert(map->tilesets->columns == 4);
+        assert(pntr_tiled_tile_image(map, 8) != NULL);
+        assert(pntr_tiled_tile_image(map, 9) == NULL);
+
+        // Images and external tilesets that fail to load are reported, and left out of the reloaded map.
+        remove(imageName);
+        assert(pntr_tiled_reload(map, fileName, &error));
+        assert(error.reason != NULL && strstr(error.reason, "pntr_tiled_test_reload.png") != NULL);
+        assert(pntr_tiled_layer(map, "Logo")->image.ptr == NULL);
+        assert(pntr_tiled_get_object(pntr_tiled_layer(map, "Objects"), "player") == player);
+        const char* brokenTileset = "{\"name\": \"Desert\",\n\"columns\": oops}";
+        assert(pntr_save_file(tilesetName, brokenTileset, (unsigned int)strlen(brokenTileset)));
+        int warnings = test_warnings;
+        assert(pntr_tiled_reload(map, fileName, &error));
+        assert(error.reason != NULL && strstr(error.reason, "pntr_tiled_test_reload.tsj:2:") != NULL);
+        assert(error.line == 2);
+        assert(test_warnings == warnings);
+        assert(pntr_tiled_tile_image(map, 1) == NULL);
+        pntr_unload_tiled(map);
+        assert(options.cache->entries == NULL);
+        pntr_unload_tiled_cache(options.cache);
+
+        pntr_unload_file(logoFile);
+        pntr_unload_file(desertFile);
+        remove(imageName);
+        remove(tilesetName);
+        remove(fileName);
+    }
+
+    // pntr_load_tiled() with base64, zlib and gzip encoded tile layers
+    {
+        cute_tiled_map_t* csv = pntr_load_tiled("resources/pntr_tiled_test.tmj");
+        cute_tiled_map_t* map = pntr_load_tiled("resources/pntr_tiled_test_base64.tmj");
+        assert(csv != NULL);
+        assert(map != NULL);
+
+        const char* layers[] = { "Desert", "Structure", "Plants" };
+        const char* compression[] = { "zlib", "gzip", NULL };
+        for (int i = 0; i < 3; i++) {
+            cute_tiled_layer_t* expected = pntr_tiled_layer(csv, layers[i]);
+            cute_tiled_layer_t* actual = pntr_tiled_layer(map, layers[i]);
+            assert(actual != NULL);
+            assert(PNTR_STRCMP(actual->encoding.ptr, "base64") == 0);
+            assert(compression[i] == NULL ? actual->compression.ptr == NULL : PNTR_STRCMP(actual->compression.ptr, compression[i]) == 0);
+            assert(actual->data_count == expected->data_count);
+            assert(memcmp(actual->data, expected->data, sizeof(int) * (size_t)actual->data_count) == 0);
+        }
+
+        pntr_unload_tiled(csv);
+        pntr_unload_tiled(map);
+    }
+
+    // pntr_load_tiled() with zlib and gzip layers compressed at the default level
+    {
+        // 32x32 varied tiles, large enough that both streams use dynamic Huffman blocks.
+        const char* fileName = "resources/pntr_tiled_test_deflate.tmj";
+        cute_tiled_map_t* map = pntr_load_tiled(fileName);
+        assert(map != NULL);
+
+        const char* layers[] = { "Zlib", "Gzip" };
+        for (int i = 0; i < 2; i++) {
+            cute_tiled_layer_t* layer = pntr_tiled_layer(map, layers[i]);
+            assert(layer != NULL);
+            assert(layer->data_count == 32 * 32);
+            for (int y = 0; y < 32; y++) {
+                for (int x = 0; x < 32; x++) {
+                    assert(layer->data[y * 32 + x] == (x * x + 3 * x * y + y) % 47 + 1);
+                }
+            }
+        }
+        pntr_unload_tiled(map);
+
+        // A damaged Adler-32 or CRC-32 trailer fails the load.
+        unsigned int size = 0;
+        unsigned char* data = pntr_load_file(fileName, &size);
+        assert(data != NULL);
+        char* zlibData = strstr((char*)data, "\"data\":\"") + 8;
+        char* gzipData = strstr(zlibData, "\"data\":\"") + 8;
+
+        // The last character holds the low bits of the Adler-32. The gzip CRC-32 starts 8 bytes
+        // from the end, in the character 13 before the closing quote (ahead of the "==" padding).
+        char* damaged[] = { strchr(zlibData, '"') - 1, strchr(gzipData, '"') - 13 };
+        for (int i = 0; i < 2; i++) {
+            char original = *damaged[i];
+            *damaged[i] = original == 'A' ? 'B' : 'A';
+            assert(pntr_load_tiled_from_memory(data, size, "resources/") == NULL);
+            *damaged[i] = original;
+        }
+
+        map = pntr_load_tiled_from_memory(data, size, "resources/");
+        assert(map != NULL);
+        pntr_unload_tiled(map);
+        pntr_unload_file(data);
+    }
+
+    // pntr_load_tiled() with an infinite map
+    {
+        cute_tiled_map_t* map = pntr_load_tiled("resources/pntr_tiled_test_infinite.tmj");
+        assert(map != NULL);
+        assert(map->infinite);
+
+        cute_tiled_layer_t* ground = pntr_tiled_layer(map, "Ground");
+        assert(ground != NULL);
+        assert(ground->chunks != NULL);
+        assert(ground->data == NULL);
+        assert(ground->startx == -16);
+        assert(pntr_layer_tile(ground, -16, 0) == 30);
+        assert(pntr_layer_tile(ground, -1, 15) == 30);
+        assert(pntr_layer_tile(ground, 5, 5) == 30);
+        assert(pntr_layer_tile(ground, 16, 0) == 0);
+        assert(pntr_layer_tile(ground, -17, 0) == 0);
+        assert(pntr_layer_tile(ground, 1027, -2046) == 6);
+        assert(pntr_layer_tile(ground, 500, 500) == 0);
+
+        // Base64 and zlib encoded chunks
+        cute_tiled_layer_t* plants = pntr_tiled_layer(map, "Plants");
+        assert(plants != NULL);
+        assert(pntr_layer_tile(plants, -13, 4) == 38);
+        assert(pntr_layer_tile(plants, 2, 5) == 39);
+        assert(pntr_layer_tile(plants, 3, 5) == 0);
+
+        // pntr_set_layer_tile()
+        pntr_set_layer_tile(ground, -5, 3, 12);
+        assert(pntr_layer_tile(ground, -5, 3) == 12);
+        pntr_set_layer_tile(ground, 100, 100, 12);
+        assert(pntr_layer_tile(ground, 100, 100) == 0);
+
+        // pntr_draw_tiled()
+        pntr_image* image = pntr_gen_image_color(map->tilewidth * map->width, map->tileheight * map->height, PNTR_BLANK);
+        assert(image != NULL);
+        pntr_draw_tiled(image, map, 16 * map->tilewidth, 0, PNTR_WHITE);
+        assert(pntr_image_get_color(image, 0, 0).rgba.a == 255);
+        assert(pntr_image_get_color(image, image->width - 1, image->height - 1).rgba.a == 255);
+        pntr_unload_image(image);
+
+        pntr_unload_tiled(map);
+    }
+
+    // cute_tiled skipping editor-only values, with brackets and escaped quotes inside strings
+    {
+        const char* json =
+            "{\"editorsettings\": {\"export\": {\"target\": \"out}}}{.tmj\", \"format\": \"\\\\\\\"}\"},\n"
+            "    \"chunksize\": {\"width\": 16, \"height\": 16}},\n"
+            "\"height\": 2,\n"
+            "\"tilesets\": [{\"firstgid\": 1, \"name\": \"set\", \"tilecount\": 4, \"columns\": 2,\n"
+            "    \"wangsets\": [{\"name\": \"]] \\\"[[\\\" ]\", \"colors\": [[], [{}], [\"[\"]], \"wangtiles\": [{\"tileid\": 0, \"wangid\": [0, 1, 0, 1, 0, 1, 0, 1]}]}],\n"
+            "    \"terrains\": [{\"name\": \"{[\", \"tile\": 0}]}],\n"
+            "\"width\": 3\n"
+            "}";
+        cute_tiled_map_t* map = cute_tiled_load_map_from_memory(json, (int)strlen(json), NULL);
+        assert(map != NULL);
+        assert(map->width == 3);
+        assert(map->height == 2);
+        assert(map->tilesets != NULL);
+        assert(map->tilesets->tilecount == 4);
+        assert(map->tilesets->columns == 2);
+        cute_tiled_free_map(map);
+
+        // Unterminated values fail rather than reading past the input
+        const char* unterminated = "{\"editorsettings\": {\"export\": \"}\"";
+        assert(cute_tiled_load_map_from_memory(unterminated, (int)strlen(unterminated), NULL) == NULL);
+    }
+
+    // cute_tiled_strtod() is bit identical to strtod()
+    {
+        const char* cases[] = {
+            "0", "-0", "0.0", "-0.0", "1", "-1", "0.1", "0.5", "1.5", "3.14159", "-273.15",
+            "16", "32.000000", "0.30000000000000004", "9007199254740993", "9007199254740992",
+            "123456789012345678", "1234567890123456789", "12345678901234567890", "1e22", "1e23",
+            "12e25", "1e-22", "1e-23", "4.9e-324", "2.2250738585072014e-308", "1.7976931348623157e308",
+            "1e309", "1e-400", "0e99999", "1E5", "1e+5", "1.", ".5", "-.5", "1e", "1e-", "-",
+            "0x10", "inf", "nan", "+1", " 1", "1.5,", "2.5]", "7}", "0.000000000000000000001",
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            char* expectedEnd;
+            char* actualEnd;
+            double expected = strtod(cases[i], &expectedEnd);
+            double actual = cute_tiled_strtod(cases[i], &actualEnd);
+            assert(memcmp(&expected, &actual, sizeof(double)) == 0);
+            assert(expectedEnd == actualEnd);
+        }
+
+        // Random corpus of the decimals Tiled writes
+        uint32_t seed = 12345;
+        for (int i = 0; i < 200000; i++) {
+            char buffer[64];
+            int length = 0;
+            seed = seed * 1664525u + 1013904223u;
+            if (seed & 0x100) buffer[length++] = '-';
+            int integerDigits = 1 + (int)((seed >> 9) % 10);
+            int fractionDigits = (int)((seed >> 13) % 18);
+            for (int d = 0; d < integerDigits + fractionDigits; d++) {
+                seed = seed * 1664525u + 1013904223u;
+                if (d == integerDigits) buffer[length++] = '.';
+                buffer[length++] = (char)('0' + (seed >> 16) % 10);
+            }
+            seed = seed * 1664525u + 1013904223u;
+            if ((seed >> 20) % 4 == 0) {
+                length += sprintf(buffer + length, "e%d", (int)((seed >> 8) % 80) - 40);
+            }
+            buffer[length] = '\0';
+
+            char* expectedEnd;
+            char* actualEnd;
+            double expected = strtod(buffer, &expectedEnd);
+            double actual = cute_tiled_strtod(buffer, &actualEnd);
+            assert(memcmp(&expected, &actual, sizeof(double)) == 0);
+            assert(expectedEnd == actualEnd);
+        }
+    }
+
     // assertsys
     #ifdef PNTR_ASSETSYS_IMPLEMENTATION
     {